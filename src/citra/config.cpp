@@ -106,6 +106,11 @@ void Config::ReadValues() {
     Settings::values.use_cpu_jit = sdl2_config->GetBoolean("Core", "use_cpu_jit", true);
     Settings::values.cpu_clock_percentage =
         sdl2_config->GetInteger("Core", "cpu_clock_percentage", 100);
+    Settings::values.use_cpu_threads = sdl2_config->GetBoolean("Core", "use_cpu_threads", false);
+    Settings::values.deterministic_cpu_threads =
+        sdl2_config->GetBoolean("Core", "deterministic_cpu_threads", true);
+    Settings::values.skip_idle_loops = sdl2_config->GetBoolean("Core", "skip_idle_loops", false);
+    Settings::values.use_vfp_host_fpu = sdl2_config->GetBoolean("Core", "use_vfp_host_fpu", true);
 
     // Renderer
     Settings::values.use_gles = sdl2_config->GetBoolean("Renderer", "use_gles", false);
@@ -197,6 +202,10 @@ void Config::ReadValues() {
     // Data Storage
     Settings::values.use_virtual_sd =
         sdl2_config->GetBoolean("Data Storage", "use_virtual_sd", true);
+    Settings::values.cache_decrypted_content =
+        sdl2_config->GetBoolean("Data Storage", "cache_decrypted_content", false);
+    Settings::values.content_cache_size_mb = static_cast<u32>(
+        sdl2_config->GetInteger("Data Storage", "content_cache_size_mb", 1024));
 
     // System
     Settings::values.is_new_3ds = sdl2_config->GetBoolean("System", "is_new_3ds", true);
@@ -252,6 +261,10 @@ void Config::ReadValues() {
     // Debugging
     Settings::values.record_frame_times =
         sdl2_config->GetBoolean("Debugging", "record_frame_times", false);
+    Settings::values.guest_profiler_rate =
+        static_cast<u32>(sdl2_config->GetInteger("Debugging", "guest_profiler_rate", 0));
+    Settings::values.dump_service_metrics =
+        sdl2_config->GetBoolean("Debugging", "dump_service_metrics", false);
     Settings::values.use_gdbstub = sdl2_config->GetBoolean("Debugging", "use_gdbstub", false);
     Settings::values.gdbstub_port =
         static_cast<u16>(sdl2_config->GetInteger("Debugging", "gdbstub_port", 24689));
@@ -97,6 +97,24 @@ use_cpu_jit =
 # Range is any positive integer (but we suspect 25 - 400 is a good idea) Default is 100
 cpu_clock_percentage =
 
+# Whether to run each emulated CPU core on its own host thread (experimental)
+# Requires the interpreter (use_cpu_jit = 0), and is not used while the GDB stub is enabled.
+# 0 (default): Off, 1: On
+use_cpu_threads =
+
+# Whether cores running on host threads enter the kernel in a reproducible order.
+# Always enabled while recording or playing back a movie.
+# 0: Off (faster), 1 (default): On
+deterministic_cpu_threads =
+
+# Whether to skip ahead to the next event when a core spins in a loop waiting for it (experimental)
+# 0 (default): Off, 1: On
+skip_idle_loops =
+
+# Whether the interpreter runs VFP arithmetic on the host FPU when the result is known to be exact
+# 0: Off, 1 (default): On
+use_vfp_host_fpu =
+
 [Renderer]
 # Whether to render using GLES or OpenGL
 # 0 (default): OpenGL, 1: GLES
@@ -241,6 +259,15 @@ volume =
 # 1 (default): Yes, 0: No
 use_virtual_sd =
 
+# Whether to keep the decrypted and decompressed ExeFS of encrypted titles in the cache directory,
+# so that they don't need to be decrypted again the next time they are booted.
+# 0 (default): No, 1: Yes
+cache_decrypted_content =
+
+# Maximum size of the decrypted content cache in MB. The least recently booted titles are removed
+# first. Default: 1024
+content_cache_size_mb =
+
 [System]
 # The system model that Citra will try to emulate
 # 0: Old 3DS, 1: New 3DS (default)
@@ -289,6 +316,13 @@ log_filter = *:Info
 [Debugging]
 # Record frame time data, can be found in the log directory. Boolean value
 record_frame_times =
+# Samples per second of the guest code profiler. The report can be found in the log directory.
+# 0 (default): Disabled
+guest_profiler_rate =
+# Record the call statistics of the HLE services, and write them as JSON to the log directory on
+# shutdown.
+# 0 (default): No, 1: Yes
+dump_service_metrics =
 # Port for listening to GDB connections.
 use_gdbstub=false
 gdbstub_port=24689
@@ -256,6 +256,14 @@ void Config::ReadCoreValues() {
     Settings::values.use_cpu_jit = ReadSetting(QStringLiteral("use_cpu_jit"), true).toBool();
     Settings::values.cpu_clock_percentage =
         ReadSetting(QStringLiteral("cpu_clock_percentage"), 100).toInt();
+    Settings::values.use_cpu_threads =
+        ReadSetting(QStringLiteral("use_cpu_threads"), false).toBool();
+    Settings::values.deterministic_cpu_threads =
+        ReadSetting(QStringLiteral("deterministic_cpu_threads"), true).toBool();
+    Settings::values.skip_idle_loops =
+        ReadSetting(QStringLiteral("skip_idle_loops"), false).toBool();
+    Settings::values.use_vfp_host_fpu =
+        ReadSetting(QStringLiteral("use_vfp_host_fpu"), true).toBool();
 
     qt_config->endGroup();
 }
@@ -264,6 +272,10 @@ void Config::ReadDataStorageValues() {
     qt_config->beginGroup(QStringLiteral("Data Storage"));
 
     Settings::values.use_virtual_sd = ReadSetting(QStringLiteral("use_virtual_sd"), true).toBool();
+    Settings::values.cache_decrypted_content =
+        ReadSetting(QStringLiteral("cache_decrypted_content"), false).toBool();
+    Settings::values.content_cache_size_mb =
+        ReadSetting(QStringLiteral("content_cache_size_mb"), 1024).toUInt();
 
     qt_config->endGroup();
 }
@@ -274,6 +286,10 @@ void Config::ReadDebuggingValues() {
     // Intentionally not using the QT default setting as this is intended to be changed in the ini
     Settings::values.record_frame_times =
         qt_config->value(QStringLiteral("record_frame_times"), false).toBool();
+    Settings::values.guest_profiler_rate =
+        qt_config->value(QStringLiteral("guest_profiler_rate"), 0).toUInt();
+    Settings::values.dump_service_metrics =
+        qt_config->value(QStringLiteral("dump_service_metrics"), false).toBool();
     Settings::values.use_gdbstub = ReadSetting(QStringLiteral("use_gdbstub"), false).toBool();
     Settings::values.gdbstub_port = ReadSetting(QStringLiteral("gdbstub_port"), 24689).toInt();
 
@@ -786,6 +802,11 @@ void Config::SaveCoreValues() {
     WriteSetting(QStringLiteral("use_cpu_jit"), Settings::values.use_cpu_jit, true);
     WriteSetting(QStringLiteral("cpu_clock_percentage"), Settings::values.cpu_clock_percentage,
                  100);
+    WriteSetting(QStringLiteral("use_cpu_threads"), Settings::values.use_cpu_threads, false);
+    WriteSetting(QStringLiteral("deterministic_cpu_threads"),
+                 Settings::values.deterministic_cpu_threads, true);
+    WriteSetting(QStringLiteral("skip_idle_loops"), Settings::values.skip_idle_loops, false);
+    WriteSetting(QStringLiteral("use_vfp_host_fpu"), Settings::values.use_vfp_host_fpu, true);
 
     qt_config->endGroup();
 }
@@ -794,6 +815,10 @@ void Config::SaveDataStorageValues() {
     qt_config->beginGroup(QStringLiteral("Data Storage"));
 
     WriteSetting(QStringLiteral("use_virtual_sd"), Settings::values.use_virtual_sd, true);
+    WriteSetting(QStringLiteral("cache_decrypted_content"),
+                 Settings::values.cache_decrypted_content, false);
+    WriteSetting(QStringLiteral("content_cache_size_mb"), Settings::values.content_cache_size_mb,
+                 1024);
 
     qt_config->endGroup();
 }
@@ -803,6 +828,10 @@ void Config::SaveDebuggingValues() {
 
     // Intentionally not using the QT default setting as this is intended to be changed in the ini
     qt_config->setValue(QStringLiteral("record_frame_times"), Settings::values.record_frame_times);
+    qt_config->setValue(QStringLiteral("guest_profiler_rate"),
+                        Settings::values.guest_profiler_rate);
+    qt_config->setValue(QStringLiteral("dump_service_metrics"),
+                        Settings::values.dump_service_metrics);
     WriteSetting(QStringLiteral("use_gdbstub"), Settings::values.use_gdbstub, false);
     WriteSetting(QStringLiteral("gdbstub_port"), Settings::values.gdbstub_port, 24689);
 
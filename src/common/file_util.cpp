@@ -35,7 +35,7 @@
 #define fstat _fstat64
 
 #else
-#ifdef __APPLE__
+#ifndef __linux__
 #include <sys/param.h>
 #endif
 #include <cctype>
@@ -44,7 +44,13 @@
 #include <cstring>
 #include <dirent.h>
 #include <pwd.h>
+#include <sys/mman.h>
 #include <unistd.h>
+#ifdef __linux__
+#include <sys/vfs.h>
+#else
+#include <sys/mount.h>
+#endif
 #endif
 
 #if defined(__APPLE__)
@@ -344,6 +350,21 @@ u64 GetSize(const std::string& filename) {
     return 0;
 }
 
+s64 GetModificationTime(const std::string& filename) {
+    struct stat buf;
+#ifdef _WIN32
+    if (_wstat64(Common::UTF8ToUTF16W(filename).c_str(), &buf) == 0)
+#else
+    if (stat(filename.c_str(), &buf) == 0)
+#endif
+    {
+        return static_cast<s64>(buf.st_mtime);
+    }
+
+    LOG_ERROR(Common_Filesystem, "Stat failed {}: {}", filename, GetLastErrorMsg());
+    return 0;
+}
+
 u64 GetSize(const int fd) {
     struct stat buf;
     if (fstat(fd, &buf) != 0) {
@@ -975,4 +996,143 @@ bool IOFile::Resize(u64 size) {
     return m_good;
 }
 
+/**
+ * Checks whether a file is on a network or FUSE filesystem. Reading a mapping turns I/O errors,
+ * e.g. from a dropped connection, into a crash instead of a failed read, so such files aren't
+ * mapped.
+ */
+#ifdef _WIN32
+static bool IsRemoteFile(HANDLE handle) {
+    FILE_REMOTE_PROTOCOL_INFO info{};
+    return GetFileInformationByHandleEx(handle, FileRemoteProtocolInfo, &info, sizeof(info)) != 0;
+}
+#else
+static bool IsRemoteFile(int fd) {
+    struct statfs info;
+    if (fstatfs(fd, &info) != 0) {
+        return true;
+    }
+#ifdef __linux__
+    switch (static_cast<u32>(info.f_type)) {
+    case 0x6969:     // NFS
+    case 0x517B:     // SMB
+    case 0xFF534D42: // CIFS
+    case 0xFE534D42: // SMB2
+    case 0x65735546: // FUSE
+    case 0x01021997: // 9P
+    case 0x00C36400: // Ceph
+    case 0x5346414F: // AFS
+        return true;
+    default:
+        return false;
+    }
+#else
+    return (info.f_flags & MNT_LOCAL) == 0;
+#endif
+}
+#endif
+
+MappedFile::MappedFile() {}
+
+MappedFile::MappedFile(const IOFile& file) {
+    if (!file.IsOpen()) {
+        return;
+    }
+    const u64 size = file.GetSize();
+    if (size == 0 || size > std::numeric_limits<std::size_t>::max()) {
+        return;
+    }
+
+#ifdef _WIN32
+    const HANDLE handle = reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(file.m_file)));
+    if (IsRemoteFile(handle)) {
+        return;
+    }
+    const HANDLE mapping = CreateFileMappingW(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        LOG_WARNING(Common_Filesystem, "CreateFileMapping failed: {}", GetLastErrorMsg());
+        return;
+    }
+    // The view keeps the mapping object alive
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (data == nullptr) {
+        LOG_WARNING(Common_Filesystem, "MapViewOfFile failed: {}", GetLastErrorMsg());
+        return;
+    }
+#else
+    const int fd = fileno(file.m_file);
+    if (IsRemoteFile(fd)) {
+        return;
+    }
+    void* data = mmap(nullptr, static_cast<std::size_t>(size), PROT_READ, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED) {
+        LOG_WARNING(Common_Filesystem, "mmap failed: {}", GetLastErrorMsg());
+        return;
+    }
+#endif
+    m_data = static_cast<u8*>(data);
+    m_size = size;
+}
+
+MappedFile::~MappedFile() {
+    Unmap();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    Swap(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    Swap(other);
+    return *this;
+}
+
+void MappedFile::Swap(MappedFile& other) noexcept {
+    std::swap(m_data, other.m_data);
+    std::swap(m_size, other.m_size);
+}
+
+void MappedFile::Advise(u64 offset, u64 length, AccessHint hint) const {
+#ifndef _WIN32
+    if (!IsOpen() || offset >= m_size) {
+        return;
+    }
+    // madvise requires a page aligned address
+    static const u64 page_size = static_cast<u64>(sysconf(_SC_PAGESIZE));
+    const u64 start = offset & ~(page_size - 1);
+    const u64 end = std::min(offset + length, m_size);
+
+    int advice = MADV_NORMAL;
+    switch (hint) {
+    case AccessHint::Normal:
+        advice = MADV_NORMAL;
+        break;
+    case AccessHint::Sequential:
+        advice = MADV_SEQUENTIAL;
+        break;
+    case AccessHint::Random:
+        advice = MADV_RANDOM;
+        break;
+    case AccessHint::WillNeed:
+        advice = MADV_WILLNEED;
+        break;
+    }
+    madvise(m_data + start, static_cast<std::size_t>(end - start), advice);
+#endif
+}
+
+void MappedFile::Unmap() {
+    if (!IsOpen()) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(m_data);
+#else
+    munmap(m_data, static_cast<std::size_t>(m_size));
+#endif
+    m_data = nullptr;
+    m_size = 0;
+}
+
 } // namespace FileUtil
@@ -62,6 +62,9 @@ u64 GetSize(const int fd);
 // Overloaded GetSize, accepts FILE*
 u64 GetSize(FILE* f);
 
+// Returns the last modification time of filename in seconds since the epoch, or 0 on failure
+s64 GetModificationTime(const std::string& filename);
+
 // Returns true if successful, or path already exists.
 bool CreateDir(const std::string& filename);
 
@@ -305,10 +308,69 @@ public:
     }
 
 private:
+    friend class MappedFile;
+
     std::FILE* m_file = nullptr;
     bool m_good = true;
 };
 
+/**
+ * Read-only view of the whole contents of a file mapped into memory. Reading from it goes through
+ * the page cache directly, without a system call or a copy into an intermediate buffer. Mapping
+ * fails for empty files, and may fail for large files on 32-bit hosts, so users must be able to
+ * fall back to reading through an IOFile.
+ *
+ * The price is that an I/O error, or another process truncating the file, makes the next read of
+ * an affected page raise SIGBUS (an in-page error exception on Windows) rather than return an
+ * error. Files on network and FUSE filesystems, where I/O errors are routine, are therefore not
+ * mapped and go through the IOFile fallback. Local files are mapped anyway: the dumps this is used
+ * for aren't modified while a game runs, and a failing local disk breaks emulation either way.
+ */
+class MappedFile : public NonCopyable {
+public:
+    /// How the mapped data is going to be accessed, to let the OS tune its read-ahead
+    enum class AccessHint {
+        Normal,
+        Sequential,
+        Random,
+        /// The data is going to be read soon
+        WillNeed,
+    };
+
+    MappedFile();
+
+    /// Maps the file. The IOFile may be closed or moved from afterwards.
+    explicit MappedFile(const IOFile& file);
+
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    void Swap(MappedFile& other) noexcept;
+
+    bool IsOpen() const {
+        return m_data != nullptr;
+    }
+
+    const u8* Data() const {
+        return m_data;
+    }
+
+    u64 GetSize() const {
+        return m_size;
+    }
+
+    /// Gives the OS a hint about how a range of the file is going to be accessed.
+    void Advise(u64 offset, u64 length, AccessHint hint) const;
+
+private:
+    void Unmap();
+
+    u8* m_data = nullptr;
+    u64 m_size = 0;
+};
+
 } // namespace FileUtil
 
 // To deal with Windows being dumb at unicode:
@@ -0,0 +1,122 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace Common {
+
+/**
+ * Pool of fixed-size memory blocks, shared by all SlabAllocators with the same block size and
+ * alignment. Blocks are carved out of larger slabs and kept on a free list once released, so
+ * objects that are created and destroyed frequently don't go through the general-purpose heap.
+ * Memory is never returned to the system.
+ *
+ * The pool is locked because the last reference to an object is not always dropped on the thread
+ * that created it: the debugger widgets release kernel threads on the GUI thread, and the CPU
+ * core threads create and destroy objects concurrently. The lock is uncontended in the common
+ * case and much cheaper than a heap allocation.
+ */
+template <std::size_t Size, std::size_t Align>
+class SlabPool {
+public:
+    static SlabPool& Instance() {
+        // Intentionally leaked, as objects may still be released during static destruction
+        static SlabPool* pool = new SlabPool;
+        return *pool;
+    }
+
+    void* Allocate() {
+        std::lock_guard lock{mutex};
+        if (free_list == nullptr) {
+            Grow();
+        }
+        Block* block = free_list;
+        free_list = block->next;
+        return block;
+    }
+
+    void Free(void* pointer) {
+        std::lock_guard lock{mutex};
+        Block* block = static_cast<Block*>(pointer);
+        block->next = free_list;
+        free_list = block;
+    }
+
+private:
+    static constexpr std::size_t BLOCKS_PER_SLAB = 64;
+
+    union Block {
+        Block* next;
+        alignas(Align) unsigned char storage[Size];
+    };
+
+    SlabPool() = default;
+
+    void Grow() {
+        auto& slab = slabs.emplace_back(std::make_unique<Block[]>(BLOCKS_PER_SLAB));
+        for (std::size_t i = 0; i < BLOCKS_PER_SLAB; ++i) {
+            slab[i].next = free_list;
+            free_list = &slab[i];
+        }
+    }
+
+    std::mutex mutex;
+    Block* free_list = nullptr;
+    std::vector<std::unique_ptr<Block[]>> slabs;
+};
+
+/// Standard allocator that takes single objects from a SlabPool.
+template <typename T>
+class SlabAllocator {
+public:
+    using value_type = T;
+
+    SlabAllocator() noexcept = default;
+
+    template <typename U>
+    SlabAllocator(const SlabAllocator<U>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        if (n != 1) {
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{alignof(T)}));
+        }
+        return static_cast<T*>(Pool::Instance().Allocate());
+    }
+
+    void deallocate(T* pointer, std::size_t n) noexcept {
+        if (n != 1) {
+            ::operator delete(pointer, std::align_val_t{alignof(T)});
+            return;
+        }
+        Pool::Instance().Free(pointer);
+    }
+
+private:
+    using Pool = SlabPool<sizeof(T), alignof(T)>;
+};
+
+template <typename T, typename U>
+bool operator==(const SlabAllocator<T>&, const SlabAllocator<U>&) noexcept {
+    return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const SlabAllocator<T>&, const SlabAllocator<U>&) noexcept {
+    return false;
+}
+
+/// Like std::make_shared, but places the object and its reference count in a SlabPool.
+template <typename T, typename... Args>
+std::shared_ptr<T> MakeSlabShared(Args&&... args) {
+    return std::allocate_shared<T>(SlabAllocator<T>{}, std::forward<Args>(args)...);
+}
+
+} // namespace Common
@@ -6,7 +6,10 @@
 
 #include <algorithm>
 #include <array>
+#include <cstddef>
 #include <deque>
+#include "common/bit_set.h"
+#include "common/common_types.h"
 
 namespace Common {
 
@@ -21,15 +24,11 @@ struct ThreadQueueList {
     // Number of priority levels. (Valid levels are [0..NUM_QUEUES).)
     static const Priority NUM_QUEUES = N;
 
-    ThreadQueueList() {
-        first = nullptr;
-    }
-
     // Only for debugging, returns priority level.
     Priority contains(const T& uid) {
         for (Priority i = 0; i < NUM_QUEUES; ++i) {
             Queue& cur = queues[i];
-            if (std::find(cur.data.cbegin(), cur.data.cend(), uid) != cur.data.cend()) {
+            if (std::find(cur.cbegin(), cur.cend(), uid) != cur.cend()) {
                 return i;
             }
         }
@@ -38,125 +37,106 @@ struct ThreadQueueList {
     }
 
     T get_first() {
-        Queue* cur = first;
-        while (cur != nullptr) {
-            if (!cur->data.empty()) {
-                return cur->data.front();
-            }
-            cur = cur->next_nonempty;
+        const Priority priority = first_nonempty(NUM_QUEUES);
+        if (priority == NUM_QUEUES) {
+            return T();
         }
-
-        return T();
+        return queues[priority].front();
     }
 
     T pop_first() {
-        Queue* cur = first;
-        while (cur != nullptr) {
-            if (!cur->data.empty()) {
-                auto tmp = std::move(cur->data.front());
-                cur->data.pop_front();
-                return tmp;
-            }
-            cur = cur->next_nonempty;
-        }
-
-        return T();
+        return pop_first_better(NUM_QUEUES);
     }
 
     T pop_first_better(Priority priority) {
-        Queue* cur = first;
-        Queue* stop = &queues[priority];
-        while (cur < stop) {
-            if (!cur->data.empty()) {
-                auto tmp = std::move(cur->data.front());
-                cur->data.pop_front();
-                return tmp;
-            }
-            cur = cur->next_nonempty;
+        const Priority first = first_nonempty(priority);
+        if (first == NUM_QUEUES) {
+            return T();
         }
 
-        return T();
+        Queue& cur = queues[first];
+        auto tmp = std::move(cur.front());
+        cur.pop_front();
+        if (cur.empty()) {
+            mark_empty(first);
+        }
+        return tmp;
     }
 
     void push_front(Priority priority, const T& thread_id) {
-        Queue* cur = &queues[priority];
-        cur->data.push_front(thread_id);
+        queues[priority].push_front(thread_id);
+        mark_nonempty(priority);
     }
 
     void push_back(Priority priority, const T& thread_id) {
-        Queue* cur = &queues[priority];
-        cur->data.push_back(thread_id);
+        queues[priority].push_back(thread_id);
+        mark_nonempty(priority);
     }
 
     void move(const T& thread_id, Priority old_priority, Priority new_priority) {
         remove(old_priority, thread_id);
-        prepare(new_priority);
         push_back(new_priority, thread_id);
     }
 
     void remove(Priority priority, const T& thread_id) {
-        Queue* const cur = &queues[priority];
-        const auto iter = std::remove(cur->data.begin(), cur->data.end(), thread_id);
-        cur->data.erase(iter, cur->data.end());
+        Queue& cur = queues[priority];
+        const auto iter = std::remove(cur.begin(), cur.end(), thread_id);
+        cur.erase(iter, cur.end());
+        if (cur.empty()) {
+            mark_empty(priority);
+        }
     }
 
     void rotate(Priority priority) {
-        Queue* cur = &queues[priority];
+        Queue& cur = queues[priority];
 
-        if (cur->data.size() > 1) {
-            cur->data.push_back(std::move(cur->data.front()));
-            cur->data.pop_front();
+        if (cur.size() > 1) {
+            cur.push_back(std::move(cur.front()));
+            cur.pop_front();
         }
     }
 
     void clear() {
         queues.fill(Queue());
-        first = nullptr;
+        nonempty.fill(0);
     }
 
     bool empty(Priority priority) const {
-        const Queue* cur = &queues[priority];
-        return cur->data.empty();
-    }
-
-    void prepare(Priority priority) {
-        Queue* cur = &queues[priority];
-        if (cur->next_nonempty == UnlinkedTag())
-            link(priority);
+        return queues[priority].empty();
     }
 
 private:
-    struct Queue {
-        // Points to the next active priority, skipping over ones that have never been used.
-        Queue* next_nonempty = UnlinkedTag();
-        // Double-ended queue of threads in this priority level
-        std::deque<T> data;
-    };
-
-    /// Special tag used to mark priority levels that have never been used.
-    static Queue* UnlinkedTag() {
-        return reinterpret_cast<Queue*>(1);
+    // Double-ended queue of threads in a priority level
+    using Queue = std::deque<T>;
+
+    static constexpr std::size_t WORD_BITS = 64;
+    static constexpr std::size_t NUM_WORDS = (NUM_QUEUES + WORD_BITS - 1) / WORD_BITS;
+
+    void mark_nonempty(Priority priority) {
+        nonempty[priority / WORD_BITS] |= u64(1) << (priority % WORD_BITS);
     }
 
-    void link(Priority priority) {
-        Queue* cur = &queues[priority];
+    void mark_empty(Priority priority) {
+        nonempty[priority / WORD_BITS] &= ~(u64(1) << (priority % WORD_BITS));
+    }
 
-        for (int i = priority - 1; i >= 0; --i) {
-            if (queues[i].next_nonempty != UnlinkedTag()) {
-                cur->next_nonempty = queues[i].next_nonempty;
-                queues[i].next_nonempty = cur;
-                return;
+    /// Returns the highest priority level (lowest value) below the given one that has any threads
+    /// queued, or NUM_QUEUES if there is none.
+    Priority first_nonempty(Priority limit) const {
+        for (std::size_t word = 0; word < NUM_WORDS; ++word) {
+            if (nonempty[word] != 0) {
+                const Priority priority = static_cast<Priority>(
+                    word * WORD_BITS + LeastSignificantSetBit(nonempty[word]));
+                return priority < limit ? priority : NUM_QUEUES;
             }
         }
-
-        cur->next_nonempty = first;
-        first = cur;
+        return NUM_QUEUES;
     }
 
-    // The first queue that's ever been used.
-    Queue* first;
     // The priority level queues of thread ids.
     std::array<Queue, NUM_QUEUES> queues;
+    // Bit i is set if the queue of priority level i is not empty.
+    std::array<u64, NUM_WORDS> nonempty{};
 };
 
 } // namespace Common
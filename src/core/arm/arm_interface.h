@@ -6,11 +6,19 @@
 
 #include <cstddef>
 #include <memory>
+#include <mutex>
+#include <vector>
 #include "common/common_types.h"
 #include "core/arm/skyeye_common/arm_regformat.h"
 #include "core/arm/skyeye_common/vfp/asm_vfp.h"
 #include "core/core_timing.h"
 
+class ExclusiveMonitor;
+
+namespace Memory {
+struct PageTable;
+}
+
 /// Generic ARM11 CPU interface
 class ARM_Interface : NonCopyable {
 public:
@@ -75,6 +83,17 @@ public:
     /// Notify CPU emulation that page tables have changed
     virtual void PageTableChanged() = 0;
 
+    /**
+     * Notify CPU emulation that a page table is being destroyed, so that the code translated from
+     * it is dropped before its address can be reused by another page table. This can be called
+     * from any host thread. It takes effect the next time the page table of this CPU changes,
+     * which happens before this CPU can run code from a page table at the same address.
+     */
+    void PageTableDestroyed(Memory::PageTable* page_table) {
+        std::lock_guard lock{destroyed_page_tables_mutex};
+        destroyed_page_tables.push_back(page_table);
+    }
+
     /**
      * Set the Program Counter to an address
      * @param addr Address to set PC to
@@ -173,9 +192,27 @@ public:
      */
     virtual void LoadContext(const std::unique_ptr<ThreadContext>& ctx) = 0;
 
+    /**
+     * Makes the core forget the context of the thread it ran, when it switches to no thread. The
+     * context may be destroyed afterwards.
+     */
+    virtual void UnloadContext() {}
+
     /// Prepare core for thread reschedule (if needed to correctly handle state)
     virtual void PrepareReschedule() = 0;
 
+    /// Returns whether the core can keep its LDREX/STREX reservations in a shared monitor.
+    virtual bool SupportsExclusiveMonitor() const {
+        return false;
+    }
+
+    /**
+     * Makes the core keep its LDREX/STREX reservations in a monitor shared with cores running on
+     * other host threads. Only valid if SupportsExclusiveMonitor returns true.
+     * @param monitor Monitor to use, or nullptr to go back to the local one
+     */
+    virtual void SetExclusiveMonitor(ExclusiveMonitor* monitor) {}
+
     std::shared_ptr<Core::Timing::Timer> GetTimer() {
         return timer;
     }
@@ -185,8 +222,17 @@ public:
     }
 
 protected:
+    /// Returns the page tables destroyed since the last call, whose code should be dropped.
+    std::vector<Memory::PageTable*> TakeDestroyedPageTables() {
+        std::lock_guard lock{destroyed_page_tables_mutex};
+        return std::move(destroyed_page_tables);
+    }
+
     std::shared_ptr<Core::Timing::Timer> timer;
 
 private:
     u32 id;
+
+    std::mutex destroyed_page_tables_mutex;
+    std::vector<Memory::PageTable*> destroyed_page_tables;
 };
@@ -10,6 +10,7 @@
 #include "core/arm/dynarmic/arm_dynarmic.h"
 #include "core/arm/dynarmic/arm_dynarmic_cp15.h"
 #include "core/arm/dyncom/arm_dyncom_interpreter.h"
+#include "core/arm/dyncom/arm_dyncom_trans_cache.h"
 #include "core/core.h"
 #include "core/core_timing.h"
 #include "core/gdbstub/gdbstub.h"
@@ -165,8 +166,10 @@ ARM_Dynarmic::ARM_Dynarmic(Core::System* system, Memory::MemorySystem& memory,
                            PrivilegeMode initial_mode, u32 id,
                            std::shared_ptr<Core::Timing::Timer> timer)
     : ARM_Interface(id, timer), system(*system), memory(memory),
-      cb(std::make_unique<DynarmicUserCallbacks>(*this)) {
+      cb(std::make_unique<DynarmicUserCallbacks>(*this)),
+      interpreter_cache(std::make_unique<TranslationCache>()) {
     interpreter_state = std::make_shared<ARMul_State>(system, memory, initial_mode);
+    interpreter_state->trans_cache = interpreter_cache.get();
     PageTableChanged();
 }
 
@@ -270,20 +273,38 @@ void ARM_Dynarmic::PrepareReschedule() {
 }
 
 void ARM_Dynarmic::ClearInstructionCache() {
-    // TODO: Clear interpreter cache when appropriate.
     for (const auto& j : jits) {
         j.second->ClearCache();
     }
-    interpreter_state->instruction_cache.clear();
+    interpreter_cache->Clear();
 }
 
 void ARM_Dynarmic::InvalidateCacheRange(u32 start_address, std::size_t length) {
     jit->InvalidateCacheRange(start_address, length);
+    interpreter_cache->InvalidateRange(start_address, length);
 }
 
 void ARM_Dynarmic::PageTableChanged() {
     current_page_table = memory.GetCurrentPageTable();
 
+    // The interpreter is only used as a fallback for a few instructions, so it shares a single
+    // cache between all address spaces.
+    interpreter_cache->Clear();
+
+    // A page table destroyed since the last switch may be at the same address as the new one. The
+    // JIT in use is only cleared, as this can be called by an SVC that runs from it.
+    for (Memory::PageTable* page_table : TakeDestroyedPageTables()) {
+        const auto iter = jits.find(page_table);
+        if (iter == jits.end()) {
+            continue;
+        }
+        if (iter->second.get() == jit) {
+            jit->ClearCache();
+        } else {
+            jits.erase(iter);
+        }
+    }
+
     auto iter = jits.find(current_page_table);
     if (iter != jits.end()) {
         jit = iter->second.get();
@@ -21,6 +21,7 @@ class System;
 }
 
 class DynarmicUserCallbacks;
+class TranslationCache;
 
 class ARM_Dynarmic final : public ARM_Interface {
 public:
@@ -64,5 +65,6 @@ private:
     Dynarmic::A32::Jit* jit = nullptr;
     Memory::PageTable* current_page_table = nullptr;
     std::map<Memory::PageTable*, std::unique_ptr<Dynarmic::A32::Jit>> jits;
+    std::unique_ptr<TranslationCache> interpreter_cache;
     std::shared_ptr<ARMul_State> interpreter_state;
 };
@@ -7,24 +7,31 @@
 #include <memory>
 #include "core/arm/dyncom/arm_dyncom.h"
 #include "core/arm/dyncom/arm_dyncom_interpreter.h"
-#include "core/arm/dyncom/arm_dyncom_trans.h"
+#include "core/arm/dyncom/arm_dyncom_trans_cache.h"
 #include "core/arm/skyeye_common/armstate.h"
 #include "core/core.h"
 #include "core/core_timing.h"
+#include "core/memory.h"
 
 class DynComThreadContext final : public ARM_Interface::ThreadContext {
 public:
     DynComThreadContext() {
         Reset();
     }
-    ~DynComThreadContext() override = default;
+    ~DynComThreadContext() override {
+        // A thread can be released while its core still runs it, e.g. when the kernel shuts down
+        if (vfp.running_on != nullptr) {
+            vfp.running_on->UnloadVFPContext();
+        }
+    }
 
     void Reset() override {
         cpu_registers = {};
         cpsr = 0;
-        fpu_registers = {};
-        fpscr = 0;
-        fpexc = 0;
+        vfp.ext_reg = {};
+        vfp.fpscr = 0;
+        vfp.fpexc = 0;
+        vfp.loaded_on = nullptr;
     }
 
     u32 GetCpuRegister(std::size_t index) const override {
@@ -40,22 +47,25 @@ public:
         cpsr = value;
     }
     u32 GetFpuRegister(std::size_t index) const override {
-        return fpu_registers[index];
+        return vfp.ext_reg[index];
     }
     void SetFpuRegister(std::size_t index, u32 value) override {
-        fpu_registers[index] = value;
+        vfp.ext_reg[index] = value;
+        vfp.loaded_on = nullptr;
     }
     u32 GetFpscr() const override {
-        return fpscr;
+        return vfp.fpscr;
     }
     void SetFpscr(u32 value) override {
-        fpscr = value;
+        vfp.fpscr = value;
+        vfp.loaded_on = nullptr;
     }
     u32 GetFpexc() const override {
-        return fpexc;
+        return vfp.fpexc;
     }
     void SetFpexc(u32 value) override {
-        fpexc = value;
+        vfp.fpexc = value;
+        vfp.loaded_on = nullptr;
     }
 
 private:
@@ -63,9 +73,7 @@ private:
 
     std::array<u32, 16> cpu_registers;
     u32 cpsr;
-    std::array<u32, 64> fpu_registers;
-    u32 fpscr;
-    u32 fpexc;
+    VFPContext vfp;
 };
 
 ARM_DynCom::ARM_DynCom(Core::System* system, Memory::MemorySystem& memory,
@@ -73,12 +81,13 @@ ARM_DynCom::ARM_DynCom(Core::System* system, Memory::MemorySystem& memory,
                        std::shared_ptr<Core::Timing::Timer> timer)
     : ARM_Interface(id, timer), system(system) {
     state = std::make_unique<ARMul_State>(system, memory, initial_mode);
+    PageTableChanged();
 }
 
 ARM_DynCom::~ARM_DynCom() {}
 
 void ARM_DynCom::Run() {
-    DEBUG_ASSERT(system != nullptr);
+    DEBUG_ASSERT(timer != nullptr);
     ExecuteInstructions(std::max<s64>(timer->GetDowncount(), 0));
 }
 
@@ -87,16 +96,41 @@ void ARM_DynCom::Step() {
 }
 
 void ARM_DynCom::ClearInstructionCache() {
-    state->instruction_cache.clear();
-    trans_cache_buf_top = 0;
+    for (const auto& cache : trans_caches) {
+        cache.second->Clear();
+    }
 }
 
-void ARM_DynCom::InvalidateCacheRange(u32, std::size_t) {
-    ClearInstructionCache();
+void ARM_DynCom::InvalidateCacheRange(u32 start_address, std::size_t length) {
+    state->trans_cache->InvalidateRange(start_address, length);
 }
 
 void ARM_DynCom::PageTableChanged() {
-    ClearInstructionCache();
+    Memory::PageTable* current_page_table = state->memory.GetCurrentPageTable();
+
+    // A page table destroyed since the last switch may be at the same address as the new one. The
+    // cache in use is only cleared, as this can be called by an SVC that runs from it.
+    for (Memory::PageTable* page_table : TakeDestroyedPageTables()) {
+        const auto iter = trans_caches.find(page_table);
+        if (iter == trans_caches.end()) {
+            continue;
+        }
+        if (iter->second.get() == state->trans_cache) {
+            iter->second->Clear();
+        } else {
+            trans_caches.erase(iter);
+        }
+    }
+
+    auto iter = trans_caches.find(current_page_table);
+    if (iter != trans_caches.end()) {
+        state->trans_cache = iter->second.get();
+        return;
+    }
+
+    auto new_cache = std::make_unique<TranslationCache>();
+    state->trans_cache = new_cache.get();
+    trans_caches.emplace(current_page_table, std::move(new_cache));
 }
 
 void ARM_DynCom::SetPC(u32 pc) {
@@ -116,18 +150,22 @@ void ARM_DynCom::SetReg(int index, u32 value) {
 }
 
 u32 ARM_DynCom::GetVFPReg(int index) const {
+    state->ActivateVFP();
     return state->ExtReg[index];
 }
 
 void ARM_DynCom::SetVFPReg(int index, u32 value) {
+    state->ActivateVFP();
     state->ExtReg[index] = value;
 }
 
 u32 ARM_DynCom::GetVFPSystemReg(VFPSystemRegister reg) const {
+    state->ActivateVFP();
     return state->VFP[reg];
 }
 
 void ARM_DynCom::SetVFPSystemReg(VFPSystemRegister reg, u32 value) {
+    state->ActivateVFP();
     state->VFP[reg] = value;
 }
 
@@ -150,7 +188,7 @@ void ARM_DynCom::SetCP15Register(CP15Register reg, u32 value) {
 void ARM_DynCom::ExecuteInstructions(u64 num_instructions) {
     state->NumInstrsToExecute = num_instructions;
     unsigned ticks_executed = InterpreterMainLoop(state.get());
-    if (system != nullptr) {
+    if (timer != nullptr) {
         timer->AddTicks(ticks_executed);
     }
     state->ServeBreak();
@@ -161,27 +199,37 @@ std::unique_ptr<ARM_Interface::ThreadContext> ARM_DynCom::NewContext() const {
 }
 
 void ARM_DynCom::SaveContext(const std::unique_ptr<ThreadContext>& arg) {
-    DynComThreadContext* ctx = dynamic_cast<DynComThreadContext*>(arg.get());
-    ASSERT(ctx);
+    // Contexts only ever come from NewContext, so the type is only checked in debug builds
+    DEBUG_ASSERT(dynamic_cast<DynComThreadContext*>(arg.get()) != nullptr);
+    DynComThreadContext* ctx = static_cast<DynComThreadContext*>(arg.get());
 
     ctx->cpu_registers = state->Reg;
     ctx->cpsr = state->Cpsr;
-    ctx->fpu_registers = state->ExtReg;
-    ctx->fpscr = state->VFP[VFP_FPSCR];
-    ctx->fpexc = state->VFP[VFP_FPEXC];
+    state->SaveVFPContext(ctx->vfp);
 }
 
 void ARM_DynCom::LoadContext(const std::unique_ptr<ThreadContext>& arg) {
-    DynComThreadContext* ctx = dynamic_cast<DynComThreadContext*>(arg.get());
-    ASSERT(ctx);
+    // Contexts only ever come from NewContext, so the type is only checked in debug builds
+    DEBUG_ASSERT(dynamic_cast<DynComThreadContext*>(arg.get()) != nullptr);
+    DynComThreadContext* ctx = static_cast<DynComThreadContext*>(arg.get());
 
     state->Reg = ctx->cpu_registers;
     state->Cpsr = ctx->cpsr;
-    state->ExtReg = ctx->fpu_registers;
-    state->VFP[VFP_FPSCR] = ctx->fpscr;
-    state->VFP[VFP_FPEXC] = ctx->fpexc;
+    state->LoadVFPContext(ctx->vfp);
+}
+
+void ARM_DynCom::UnloadContext() {
+    state->UnloadVFPContext();
 }
 
 void ARM_DynCom::PrepareReschedule() {
     state->NumInstrsToExecute = 0;
 }
+
+bool ARM_DynCom::SupportsExclusiveMonitor() const {
+    return true;
+}
+
+void ARM_DynCom::SetExclusiveMonitor(ExclusiveMonitor* monitor) {
+    state->SetExclusiveMonitor(monitor, GetID());
+}
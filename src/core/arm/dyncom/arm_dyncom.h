@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <map>
 #include <memory>
 #include "common/common_types.h"
 #include "core/arm/arm_interface.h"
@@ -16,7 +17,10 @@ class System;
 
 namespace Memory {
 class MemorySystem;
-}
+struct PageTable;
+} // namespace Memory
+
+class TranslationCache;
 
 class ARM_DynCom final : public ARM_Interface {
 public:
@@ -48,12 +52,16 @@ public:
     std::unique_ptr<ThreadContext> NewContext() const override;
     void SaveContext(const std::unique_ptr<ThreadContext>& arg) override;
     void LoadContext(const std::unique_ptr<ThreadContext>& arg) override;
+    void UnloadContext() override;
 
     void PrepareReschedule() override;
+    bool SupportsExclusiveMonitor() const override;
+    void SetExclusiveMonitor(ExclusiveMonitor* monitor) override;
 
 private:
     void ExecuteInstructions(u64 num_instructions);
 
     Core::System* system;
     std::unique_ptr<ARMul_State> state;
+    std::map<Memory::PageTable*, std::unique_ptr<TranslationCache>> trans_caches;
 };
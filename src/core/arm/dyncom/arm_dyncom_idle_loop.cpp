@@ -0,0 +1,131 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "core/arm/dyncom/arm_dyncom_idle_loop.h"
+#include "core/arm/skyeye_common/armsupp.h"
+#include "core/memory.h"
+
+// Idle loops are short, so there's no need to look further.
+static constexpr int MAX_IDLE_LOOP_INSTRUCTIONS = 8;
+
+// Registers that the instructions of a candidate idle loop use to address memory, and that they
+// write. Each iteration repeats the previous one exactly if the two sets are disjoint.
+struct IdleLoopRegisters {
+    u32 address = 0;
+    u32 written = 0;
+};
+
+// Loads without writeback and comparisons only depend on memory and registers the loop doesn't
+// modify, so they have no side effects visible to the loop itself.
+static bool IsIdleLoopInstructionARM(u32 inst, IdleLoopRegisters& regs) {
+    const u32 rn = BITS(inst, 16, 19);
+    const u32 rd = BITS(inst, 12, 15);
+    const u32 rm = BITS(inst, 0, 3);
+
+    // LDR, LDRB with offset addressing
+    if ((inst & 0x0D300000) == 0x05100000) {
+        if (BIT(inst, 25) && BIT(inst, 4)) {
+            return false;
+        }
+        regs.address |= (1 << rn) | (BIT(inst, 25) ? (1 << rm) : 0);
+        regs.written |= 1 << rd;
+        return rd != 15;
+    }
+    // LDRH, LDRSB, LDRSH with offset addressing
+    if ((inst & 0x0F300090) == 0x01100090 && BITS(inst, 5, 6) != 0) {
+        regs.address |= (1 << rn) | (BIT(inst, 22) ? 0 : (1 << rm));
+        regs.written |= 1 << rd;
+        return rd != 15;
+    }
+    // TST, TEQ, CMP, CMN
+    if ((inst & 0x0D900000) == 0x01100000) {
+        return BIT(inst, 25) || (inst & 0x90) != 0x90;
+    }
+    return false;
+}
+
+static bool IsIdleLoopInstructionThumb(u32 inst, IdleLoopRegisters& regs) {
+    const u32 rd = BITS(inst, 0, 2);
+    const u32 rn = BITS(inst, 3, 5);
+    const u32 rm = BITS(inst, 6, 8);
+
+    switch (inst & 0xF800) {
+    case 0x6800: // LDR (immediate)
+    case 0x7800: // LDRB (immediate)
+    case 0x8800: // LDRH (immediate)
+        regs.address |= 1 << rn;
+        regs.written |= 1 << rd;
+        return true;
+    case 0x4800: // LDR (literal)
+        regs.written |= 1 << BITS(inst, 8, 10);
+        return true;
+    case 0x9800: // LDR (SP relative)
+        regs.address |= 1 << 13;
+        regs.written |= 1 << BITS(inst, 8, 10);
+        return true;
+    case 0x2800: // CMP (immediate)
+        return true;
+    }
+    // LDRSB, LDR, LDRH, LDRB, LDRSH (register)
+    if ((inst & 0xF000) == 0x5000 && BITS(inst, 9, 11) >= 3) {
+        regs.address |= (1 << rn) | (1 << rm);
+        regs.written |= 1 << rd;
+        return true;
+    }
+    // TST, CMP, CMN (register)
+    if ((inst & 0xFC00) == 0x4000) {
+        const u32 op = BITS(inst, 6, 9);
+        return op == 0x8 || op == 0xA || op == 0xB;
+    }
+    // CMP (high registers)
+    return (inst & 0xFF00) == 0x4500;
+}
+
+IdleLoopBranch FindIdleLoop(Memory::MemorySystem& memory, bool thumb, u32 pc, u32& branch_addr) {
+    IdleLoopRegisters regs;
+    u32 addr = pc;
+    for (int i = 0; i < MAX_IDLE_LOOP_INSTRUCTIONS; ++i) {
+        // The block would end at the page boundary instead of at the branch
+        if (i != 0 && (addr & Memory::PAGE_MASK) == 0) {
+            return IdleLoopBranch::NONE;
+        }
+        branch_addr = addr;
+
+        if (thumb) {
+            const u32 inst = memory.Read16(addr);
+            if ((inst & 0xF000) == 0xD000 && BITS(inst, 8, 11) < 0xE) {
+                const u32 offset = (BITS(inst, 0, 7) << 1) | (BIT(inst, 7) ? 0xFFFFFE00 : 0);
+                return addr + 4 + offset == pc && (regs.address & regs.written) == 0
+                           ? IdleLoopBranch::THUMB_COND
+                           : IdleLoopBranch::NONE;
+            }
+            if ((inst & 0xF800) == 0xE000) {
+                const u32 offset = (BITS(inst, 0, 10) << 1) | (BIT(inst, 10) ? 0xFFFFF000 : 0);
+                return addr + 4 + offset == pc && (regs.address & regs.written) == 0
+                           ? IdleLoopBranch::THUMB
+                           : IdleLoopBranch::NONE;
+            }
+            if (!IsIdleLoopInstructionThumb(inst, regs)) {
+                return IdleLoopBranch::NONE;
+            }
+            addr += 2;
+        } else {
+            const u32 inst = memory.Read32(addr);
+            if (BITS(inst, 28, 31) == 0xF) {
+                return IdleLoopBranch::NONE;
+            }
+            if ((inst & 0x0F000000) == 0x0A000000) {
+                const u32 offset = (BITS(inst, 0, 23) << 2) | (BIT(inst, 23) ? 0xFC000000 : 0);
+                return addr + 8 + offset == pc && (regs.address & regs.written) == 0
+                           ? IdleLoopBranch::ARM
+                           : IdleLoopBranch::NONE;
+            }
+            if (!IsIdleLoopInstructionARM(inst, regs)) {
+                return IdleLoopBranch::NONE;
+            }
+            addr += 4;
+        }
+    }
+    return IdleLoopBranch::NONE;
+}
@@ -0,0 +1,26 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include "common/common_types.h"
+
+namespace Memory {
+class MemorySystem;
+}
+
+/// Kinds of branches that can close an idle loop, which determine the cream to flag
+enum class IdleLoopBranch { NONE, ARM, THUMB, THUMB_COND };
+
+/**
+ * Checks whether the block at pc is a loop that branches back to its start and only waits for a
+ * value in memory to change. In that case it can't exit before something else runs, so the rest of
+ * the slice can be skipped once it has looped once.
+ * @param memory Memory to read the instructions from
+ * @param thumb Whether the block is made of Thumb instructions
+ * @param pc Address of the first instruction of the block
+ * @param branch_addr Receives the address of the closing branch
+ * @returns The kind of the closing branch, or NONE if the block isn't an idle loop
+ */
+IdleLoopBranch FindIdleLoop(Memory::MemorySystem& memory, bool thumb, u32 pc, u32& branch_addr);
@@ -11,10 +11,12 @@
 #include "common/logging/log.h"
 #include "common/microprofile.h"
 #include "core/arm/dyncom/arm_dyncom_dec.h"
+#include "core/arm/dyncom/arm_dyncom_idle_loop.h"
 #include "core/arm/dyncom/arm_dyncom_interpreter.h"
 #include "core/arm/dyncom/arm_dyncom_run.h"
 #include "core/arm/dyncom/arm_dyncom_thumb.h"
 #include "core/arm/dyncom/arm_dyncom_trans.h"
+#include "core/arm/dyncom/arm_dyncom_trans_cache.h"
 #include "core/arm/skyeye_common/armstate.h"
 #include "core/arm/skyeye_common/armsupp.h"
 #include "core/arm/skyeye_common/vfp/vfp.h"
@@ -23,6 +25,7 @@
 #include "core/gdbstub/gdbstub.h"
 #include "core/hle/kernel/svc.h"
 #include "core/memory.h"
+#include "core/settings.h"
 
 #define RM BITS(sht_oper, 0, 3)
 #define RS BITS(sht_oper, 8, 11)
@@ -755,7 +758,8 @@ get_addr_fp_t GetAddressingOpLoadStoreT(unsigned int inst) {
 
 enum { FETCH_SUCCESS, FETCH_FAILURE };
 
-static ThumbDecodeStatus DecodeThumbInstruction(u32 inst, u32 addr, u32* arm_inst, u32* inst_size,
+static ThumbDecodeStatus DecodeThumbInstruction(TranslationCache& cache, u32 inst, u32 addr,
+                                                u32* arm_inst, u32* inst_size,
                                                 ARM_INST_PTR* ptr_inst_base) {
     // Check if in Thumb mode
     ThumbDecodeStatus ret = TranslateThumbInstruction(addr, inst, arm_inst, inst_size);
@@ -769,7 +773,7 @@ static ThumbDecodeStatus DecodeThumbInstruction(u32 inst, u32 addr, u32* arm_ins
         case 27:
             if (((tinstr & 0x0F00) != 0x0E00) && ((tinstr & 0x0F00) != 0x0F00)) {
                 inst_index = table_length - 4;
-                *ptr_inst_base = arm_instruction_trans[inst_index](tinstr, inst_index);
+                *ptr_inst_base = arm_instruction_trans[inst_index](cache, tinstr, inst_index);
             } else {
                 LOG_ERROR(Core_ARM11, "thumb decoder error");
             }
@@ -777,24 +781,24 @@ static ThumbDecodeStatus DecodeThumbInstruction(u32 inst, u32 addr, u32* arm_ins
         case 28:
             // Branch 2, unconditional branch
             inst_index = table_length - 5;
-            *ptr_inst_base = arm_instruction_trans[inst_index](tinstr, inst_index);
+            *ptr_inst_base = arm_instruction_trans[inst_index](cache, tinstr, inst_index);
             break;
 
         case 8:
         case 29:
             // For BLX 1 thumb instruction
             inst_index = table_length - 1;
-            *ptr_inst_base = arm_instruction_trans[inst_index](tinstr, inst_index);
+            *ptr_inst_base = arm_instruction_trans[inst_index](cache, tinstr, inst_index);
             break;
         case 30:
             // For BL 1 thumb instruction
             inst_index = table_length - 3;
-            *ptr_inst_base = arm_instruction_trans[inst_index](tinstr, inst_index);
+            *ptr_inst_base = arm_instruction_trans[inst_index](cache, tinstr, inst_index);
             break;
         case 31:
             // For BL 2 thumb instruction
             inst_index = table_length - 2;
-            *ptr_inst_base = arm_instruction_trans[inst_index](tinstr, inst_index);
+            *ptr_inst_base = arm_instruction_trans[inst_index](cache, tinstr, inst_index);
             break;
         default:
             ret = ThumbDecodeStatus::UNDEFINED;
@@ -810,6 +814,7 @@ MICROPROFILE_DEFINE(DynCom_Decode, "DynCom", "Decode", MP_RGB(255, 64, 64));
 
 static unsigned int InterpreterTranslateInstruction(const ARMul_State* cpu, const u32 phys_addr,
                                                     ARM_INST_PTR& inst_base) {
+    TranslationCache& cache = *cpu->trans_cache;
     u32 inst_size = 4;
     u32 inst = cpu->memory.Read32(phys_addr & 0xFFFFFFFC);
 
@@ -818,7 +823,7 @@ static unsigned int InterpreterTranslateInstruction(const ARMul_State* cpu, cons
     if (cpu->TFlag) {
         u32 arm_inst;
         ThumbDecodeStatus state =
-            DecodeThumbInstruction(inst, phys_addr, &arm_inst, &inst_size, &inst_base);
+            DecodeThumbInstruction(cache, inst, phys_addr, &arm_inst, &inst_size, &inst_base);
 
         // We have translated the Thumb branch instruction in the Thumb decoder
         if (state == ThumbDecodeStatus::BRANCH) {
@@ -835,40 +840,67 @@ static unsigned int InterpreterTranslateInstruction(const ARMul_State* cpu, cons
                   cpu->Reg[15]);
         CITRA_IGNORE_EXIT(-1);
     }
-    inst_base = arm_instruction_trans[idx](inst, idx);
+    inst_base = arm_instruction_trans[idx](cache, inst, idx);
 
     return inst_size;
 }
 
+static void MarkIdleLoop(ARM_INST_PTR branch, IdleLoopBranch kind) {
+    switch (kind) {
+    case IdleLoopBranch::ARM:
+        reinterpret_cast<bbl_inst*>(branch->component)->idle_loop = true;
+        break;
+    case IdleLoopBranch::THUMB:
+        reinterpret_cast<b_2_thumb*>(branch->component)->idle_loop = true;
+        break;
+    case IdleLoopBranch::THUMB_COND:
+        reinterpret_cast<b_cond_thumb*>(branch->component)->idle_loop = true;
+        break;
+    case IdleLoopBranch::NONE:
+        break;
+    }
+}
+
 static int InterpreterTranslateBlock(ARMul_State* cpu, std::size_t& bb_start, u32 addr) {
     MICROPROFILE_SCOPE(DynCom_Decode);
 
     // Decode instruction, get index
     // Allocate memory and init InsCream
     // Go on next, until terminal instruction
-    // Save start addr of basicblock in CreamCache
     ARM_INST_PTR inst_base = nullptr;
     TransExtData ret = TransExtData::NON_BRANCH;
     int size = 0; // instruction size of basic block
-    bb_start = trans_cache_buf_top;
 
     u32 phys_addr = addr;
     u32 pc_start = cpu->Reg[15];
 
+    u32 idle_loop_branch_addr = 0;
+    const IdleLoopBranch idle_loop = Settings::values.skip_idle_loops
+                                         ? FindIdleLoop(cpu->memory, cpu->TFlag, pc_start,
+                                                        idle_loop_branch_addr)
+                                         : IdleLoopBranch::NONE;
+
+    bb_start = cpu->trans_cache->BeginBlock(pc_start);
+
     while (ret == TransExtData::NON_BRANCH) {
+        const u32 inst_addr = phys_addr;
         unsigned int inst_size = InterpreterTranslateInstruction(cpu, phys_addr, inst_base);
 
         size++;
 
         phys_addr += inst_size;
 
-        if ((phys_addr & 0xfff) == 0) {
+        // Blocks must not cross a page boundary so they can be invalidated per page, nor a
+        // segment boundary of the translation cache.
+        if ((phys_addr & 0xfff) == 0 || !cpu->trans_cache->HasSpaceForInstruction()) {
             inst_base->br = TransExtData::END_OF_PAGE;
         }
         ret = inst_base->br;
-    };
 
-    cpu->instruction_cache[pc_start] = bb_start;
+        if (ret != TransExtData::NON_BRANCH && inst_addr == idle_loop_branch_addr) {
+            MarkIdleLoop(inst_base, idle_loop);
+        }
+    };
 
     return KEEP_GOING;
 }
@@ -877,19 +909,18 @@ static int InterpreterTranslateSingle(ARMul_State* cpu, std::size_t& bb_start, u
     MICROPROFILE_SCOPE(DynCom_Decode);
 
     ARM_INST_PTR inst_base = nullptr;
-    bb_start = trans_cache_buf_top;
 
     u32 phys_addr = addr;
     u32 pc_start = cpu->Reg[15];
 
+    bb_start = cpu->trans_cache->BeginBlock(pc_start);
+
     InterpreterTranslateInstruction(cpu, phys_addr, inst_base);
 
     if (inst_base->br == TransExtData::NON_BRANCH) {
         inst_base->br = TransExtData::SINGLE_STEP;
     }
 
-    cpu->instruction_cache[pc_start] = bb_start;
-
     return KEEP_GOING;
 }
 
@@ -953,6 +984,31 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
 #define INC_PC(l) ptr += sizeof(arm_inst) + l
 #define INC_PC_STUB ptr += sizeof(arm_inst)
 
+// Jumps straight to the block linked to a direct branch instead of looking it up in DISPATCH.
+// Stale links, pending interrupts and debugging still go through DISPATCH, which (re)links the
+// branch once the target block has been found.
+#define DISPATCH_LINKED(link)                                                                      \
+    if ((link).generation == cpu->trans_cache->GetGeneration() && cpu->NirqSig &&                 \
+        !GDBStub::IsConnected()) {                                                                 \
+        ptr = (link).offset;                                                                       \
+        inst_base = (arm_inst*)&trans_cache_buf[ptr];                                              \
+        GOTO_NEXT_INST;                                                                            \
+    }                                                                                              \
+    pending_link = &(link);                                                                        \
+    pending_link_generation = cpu->trans_cache->GetGeneration();                                   \
+    goto DISPATCH
+
+// Ends the slice once a branch has closed an idle loop, since the loop can't exit before the next
+// event anyway.
+#define SKIP_IDLE_LOOP(inst_cream)                                                                 \
+    if ((inst_cream)->idle_loop && cpu->system != nullptr && !GDBStub::IsConnected()) {            \
+        const auto timer = cpu->system->GetRunningCore().GetTimer();                               \
+        timer->AddTicks(num_instrs);                                                               \
+        num_instrs = 0;                                                                            \
+        timer->SkipIdleLoop();                                                                     \
+        goto END;                                                                                  \
+    }
+
 #define GDB_BP_CHECK                                                                               \
     cpu->Cpsr &= ~(1 << 5);                                                                        \
     cpu->Cpsr |= cpu->TFlag << 5;                                                                  \
@@ -1626,6 +1682,11 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
     unsigned int num_instrs = 0;
 
     std::size_t ptr;
+    u8* trans_cache_buf;
+
+    // Link of the direct branch that most recently went through DISPATCH
+    block_link* pending_link = nullptr;
+    u32 pending_link_generation = 0;
 
     LOAD_NZCVT;
 DISPATCH : {
@@ -1641,9 +1702,9 @@ DISPATCH : {
         cpu->Reg[15] &= 0xfffffffc;
 
     // Find the cached instruction cream, otherwise translate it...
-    auto itr = cpu->instruction_cache.find(cpu->Reg[15]);
-    if (itr != cpu->instruction_cache.end()) {
-        ptr = itr->second;
+    trans_cache_buf = cpu->trans_cache->GetBuffer();
+    if (const auto cached = cpu->trans_cache->FindBlock(cpu->Reg[15])) {
+        ptr = *cached;
     } else if (cpu->NumInstrsToExecute != 1) {
         if (InterpreterTranslateBlock(cpu, ptr, cpu->Reg[15]) == FETCH_EXCEPTION)
             goto END;
@@ -1652,6 +1713,14 @@ DISPATCH : {
             goto END;
     }
 
+    // Only link the branch if translating its target did not drop the block containing it
+    if (pending_link != nullptr) {
+        if (pending_link_generation == cpu->trans_cache->GetGeneration()) {
+            *pending_link = {pending_link_generation, static_cast<u32>(ptr)};
+        }
+        pending_link = nullptr;
+    }
+
     // Find breakpoint if one exists within the block
     if (GDBStub::IsConnected()) {
         breakpoint_data =
@@ -1761,18 +1830,17 @@ AND_INST : {
     GOTO_NEXT_INST;
 }
 BBL_INST : {
+    bbl_inst* inst_cream = (bbl_inst*)inst_base->component;
     if ((inst_base->cond == ConditionCode::AL) || CondPassed(cpu, inst_base->cond)) {
-        bbl_inst* inst_cream = (bbl_inst*)inst_base->component;
         if (inst_cream->L) {
             LINK_RTN_ADDR;
         }
         SET_PC;
-        INC_PC(sizeof(bbl_inst));
-        goto DISPATCH;
+        SKIP_IDLE_LOOP(inst_cream);
+        DISPATCH_LINKED(inst_cream->taken);
     }
     cpu->Reg[15] += cpu->GetInstructionSize();
-    INC_PC(sizeof(bbl_inst));
-    goto DISPATCH;
+    DISPATCH_LINKED(inst_cream->not_taken);
 }
 BIC_INST : {
     bic_inst* inst_cream = (bic_inst*)inst_base->component;
@@ -2235,9 +2303,8 @@ LDREX_INST : {
         generic_arm_inst* inst_cream = (generic_arm_inst*)inst_base->component;
         unsigned int read_addr = RN;
 
-        cpu->SetExclusiveMemoryAddress(read_addr);
-
         RD = cpu->ReadMemory32(read_addr);
+        cpu->SetExclusiveMemoryAddress(read_addr, RD);
     }
     cpu->Reg[15] += cpu->GetInstructionSize();
     INC_PC(sizeof(generic_arm_inst));
@@ -2249,9 +2316,8 @@ LDREXB_INST : {
         generic_arm_inst* inst_cream = (generic_arm_inst*)inst_base->component;
         unsigned int read_addr = RN;
 
-        cpu->SetExclusiveMemoryAddress(read_addr);
-
         RD = cpu->ReadMemory8(read_addr);
+        cpu->SetExclusiveMemoryAddress(read_addr, RD);
     }
     cpu->Reg[15] += cpu->GetInstructionSize();
     INC_PC(sizeof(generic_arm_inst));
@@ -2263,9 +2329,8 @@ LDREXH_INST : {
         generic_arm_inst* inst_cream = (generic_arm_inst*)inst_base->component;
         unsigned int read_addr = RN;
 
-        cpu->SetExclusiveMemoryAddress(read_addr);
-
         RD = cpu->ReadMemory16(read_addr);
+        cpu->SetExclusiveMemoryAddress(read_addr, RD);
     }
     cpu->Reg[15] += cpu->GetInstructionSize();
     INC_PC(sizeof(generic_arm_inst));
@@ -2277,10 +2342,9 @@ LDREXD_INST : {
         generic_arm_inst* inst_cream = (generic_arm_inst*)inst_base->component;
         unsigned int read_addr = RN;
 
-        cpu->SetExclusiveMemoryAddress(read_addr);
-
         RD = cpu->ReadMemory32(read_addr);
         RD2 = cpu->ReadMemory32(read_addr + 4);
+        cpu->SetExclusiveMemoryAddress(read_addr, RD | static_cast<u64>(RD2) << 32);
     }
     cpu->Reg[15] += cpu->GetInstructionSize();
     INC_PC(sizeof(generic_arm_inst));
@@ -3714,14 +3778,8 @@ STREX_INST : {
         generic_arm_inst* inst_cream = (generic_arm_inst*)inst_base->component;
         unsigned int write_addr = cpu->Reg[inst_cream->Rn];
 
-        if (cpu->IsExclusiveMemoryAccess(write_addr)) {
-            cpu->UnsetExclusiveMemoryAddress();
-            cpu->WriteMemory32(write_addr, RM);
-            RD = 0;
-        } else {
-            // Failed to write due to mutex access
-            RD = 1;
-        }
+        // Fails if the reservation was lost
+        RD = cpu->WriteExclusiveMemory32(write_addr, RM) ? 0 : 1;
     }
     cpu->Reg[15] += cpu->GetInstructionSize();
     INC_PC(sizeof(generic_arm_inst));
@@ -3733,14 +3791,8 @@ STREXB_INST : {
         generic_arm_inst* inst_cream = (generic_arm_inst*)inst_base->component;
         unsigned int write_addr = cpu->Reg[inst_cream->Rn];
 
-        if (cpu->IsExclusiveMemoryAccess(write_addr)) {
-            cpu->UnsetExclusiveMemoryAddress();
-            cpu->WriteMemory8(write_addr, cpu->Reg[inst_cream->Rm]);
-            RD = 0;
-        } else {
-            // Failed to write due to mutex access
-            RD = 1;
-        }
+        // Fails if the reservation was lost
+        RD = cpu->WriteExclusiveMemory8(write_addr, cpu->Reg[inst_cream->Rm]) ? 0 : 1;
     }
     cpu->Reg[15] += cpu->GetInstructionSize();
     INC_PC(sizeof(generic_arm_inst));
@@ -3752,24 +3804,17 @@ STREXD_INST : {
         generic_arm_inst* inst_cream = (generic_arm_inst*)inst_base->component;
         unsigned int write_addr = cpu->Reg[inst_cream->Rn];
 
-        if (cpu->IsExclusiveMemoryAccess(write_addr)) {
-            cpu->UnsetExclusiveMemoryAddress();
+        const u32 rt = cpu->Reg[inst_cream->Rm + 0];
+        const u32 rt2 = cpu->Reg[inst_cream->Rm + 1];
+        u64 value;
 
-            const u32 rt = cpu->Reg[inst_cream->Rm + 0];
-            const u32 rt2 = cpu->Reg[inst_cream->Rm + 1];
-            u64 value;
-
-            if (cpu->InBigEndianMode())
-                value = (((u64)rt << 32) | rt2);
-            else
-                value = (((u64)rt2 << 32) | rt);
+        if (cpu->InBigEndianMode())
+            value = (((u64)rt << 32) | rt2);
+        else
+            value = (((u64)rt2 << 32) | rt);
 
-            cpu->WriteMemory64(write_addr, value);
-            RD = 0;
-        } else {
-            // Failed to write due to mutex access
-            RD = 1;
-        }
+        // Fails if the reservation was lost
+        RD = cpu->WriteExclusiveMemory64(write_addr, value) ? 0 : 1;
     }
     cpu->Reg[15] += cpu->GetInstructionSize();
     INC_PC(sizeof(generic_arm_inst));
@@ -3781,14 +3826,8 @@ STREXH_INST : {
         generic_arm_inst* inst_cream = (generic_arm_inst*)inst_base->component;
         unsigned int write_addr = cpu->Reg[inst_cream->Rn];
 
-        if (cpu->IsExclusiveMemoryAccess(write_addr)) {
-            cpu->UnsetExclusiveMemoryAddress();
-            cpu->WriteMemory16(write_addr, RM);
-            RD = 0;
-        } else {
-            // Failed to write due to mutex access
-            RD = 1;
-        }
+        // Fails if the reservation was lost
+        RD = cpu->WriteExclusiveMemory16(write_addr, RM) ? 0 : 1;
     }
     cpu->Reg[15] += cpu->GetInstructionSize();
     INC_PC(sizeof(generic_arm_inst));
@@ -4322,19 +4361,19 @@ UMULL_INST : {
 B_2_THUMB : {
     b_2_thumb* inst_cream = (b_2_thumb*)inst_base->component;
     cpu->Reg[15] = cpu->Reg[15] + 4 + inst_cream->imm;
-    INC_PC(sizeof(b_2_thumb));
-    goto DISPATCH;
+    SKIP_IDLE_LOOP(inst_cream);
+    DISPATCH_LINKED(inst_cream->taken);
 }
 B_COND_THUMB : {
     b_cond_thumb* inst_cream = (b_cond_thumb*)inst_base->component;
 
-    if (CondPassed(cpu, inst_cream->cond))
+    if (CondPassed(cpu, inst_cream->cond)) {
         cpu->Reg[15] = cpu->Reg[15] + 4 + inst_cream->imm;
-    else
-        cpu->Reg[15] += 2;
-
-    INC_PC(sizeof(b_cond_thumb));
-    goto DISPATCH;
+        SKIP_IDLE_LOOP(inst_cream);
+        DISPATCH_LINKED(inst_cream->taken);
+    }
+    cpu->Reg[15] += 2;
+    DISPATCH_LINKED(inst_cream->not_taken);
 }
 BL_1_THUMB : {
     bl_1_thumb* inst_cream = (bl_1_thumb*)inst_base->component;
@@ -2,20 +2,11 @@
 #include "common/assert.h"
 #include "common/common_types.h"
 #include "core/arm/dyncom/arm_dyncom_trans.h"
+#include "core/arm/dyncom/arm_dyncom_trans_cache.h"
 #include "core/arm/skyeye_common/armstate.h"
 #include "core/arm/skyeye_common/armsupp.h"
 #include "core/arm/skyeye_common/vfp/vfp.h"
 
-char trans_cache_buf[TRANS_CACHE_SIZE];
-size_t trans_cache_buf_top = 0;
-
-static void* AllocBuffer(std::size_t size) {
-    std::size_t start = trans_cache_buf_top;
-    trans_cache_buf_top += size;
-    ASSERT_MSG(trans_cache_buf_top <= TRANS_CACHE_SIZE, "Translation cache is full!");
-    return static_cast<void*>(&trans_cache_buf[start]);
-}
-
 #define glue(x, y) x##y
 #define INTERPRETER_TRANSLATE(s) glue(InterpreterTranslate_, s)
 
@@ -23,8 +14,9 @@ shtop_fp_t GetShifterOp(unsigned int inst);
 get_addr_fp_t GetAddressingOp(unsigned int inst);
 get_addr_fp_t GetAddressingOpLoadStoreT(unsigned int inst);
 
-static ARM_INST_PTR INTERPRETER_TRANSLATE(adc)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(adc_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(adc)(TranslationCache& cache, unsigned int inst,
+                                               int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(adc_inst));
     adc_inst* inst_cream = (adc_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -43,8 +35,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(adc)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(add)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(add_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(add)(TranslationCache& cache, unsigned int inst,
+                                               int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(add_inst));
     add_inst* inst_cream = (add_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -63,8 +56,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(add)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(and)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(and_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(and)(TranslationCache& cache, unsigned int inst,
+                                               int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(and_inst));
     and_inst* inst_cream = (and_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -83,11 +77,12 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(and)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(bbl)(unsigned int inst, int index) {
+static ARM_INST_PTR INTERPRETER_TRANSLATE(bbl)(TranslationCache& cache, unsigned int inst,
+                                               int index) {
 #define POSBRANCH ((inst & 0x7fffff) << 2)
 #define NEGBRANCH ((0xff000000 | (inst & 0xffffff)) << 2)
 
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(bbl_inst));
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(bbl_inst));
     bbl_inst* inst_cream = (bbl_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -99,11 +94,15 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(bbl)(unsigned int inst, int index) {
 
     inst_cream->L = BIT(inst, 24);
     inst_cream->signed_immed_24 = BIT(inst, 23) ? NEGBRANCH : POSBRANCH;
+    inst_cream->taken = {};
+    inst_cream->not_taken = {};
+    inst_cream->idle_loop = false;
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(bic)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(bic_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(bic)(TranslationCache& cache, unsigned int inst,
+                                               int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(bic_inst));
     bic_inst* inst_cream = (bic_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -122,8 +121,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(bic)(unsigned int inst, int index) {
     return inst_base;
 }
 
-static ARM_INST_PTR INTERPRETER_TRANSLATE(bkpt)(unsigned int inst, int index) {
-    arm_inst* const inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(bkpt_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(bkpt)(TranslationCache& cache, unsigned int inst,
+                                                int index) {
+    arm_inst* const inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(bkpt_inst));
     bkpt_inst* const inst_cream = (bkpt_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -135,8 +135,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(bkpt)(unsigned int inst, int index) {
     return inst_base;
 }
 
-static ARM_INST_PTR INTERPRETER_TRANSLATE(blx)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(blx_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(blx)(TranslationCache& cache, unsigned int inst,
+                                               int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(blx_inst));
     blx_inst* inst_cream = (blx_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -152,8 +153,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(blx)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(bx)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(bx_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(bx)(TranslationCache& cache, unsigned int inst,
+                                              int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(bx_inst));
     bx_inst* inst_cream = (bx_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -164,12 +166,14 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(bx)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(bxj)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(bx)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(bxj)(TranslationCache& cache, unsigned int inst,
+                                               int index) {
+    return INTERPRETER_TRANSLATE(bx)(cache, inst, index);
 }
 
-static ARM_INST_PTR INTERPRETER_TRANSLATE(cdp)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(cdp_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(cdp)(TranslationCache& cache, unsigned int inst,
+                                               int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(cdp_inst));
     cdp_inst* inst_cream = (cdp_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -187,16 +191,18 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(cdp)(unsigned int inst, int index) {
     LOG_TRACE(Core_ARM11, "inst {:x} index {:x}", inst, index);
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(clrex)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(clrex_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(clrex)(TranslationCache& cache, unsigned int inst,
+                                                 int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(clrex_inst));
     inst_base->cond = BITS(inst, 28, 31);
     inst_base->idx = index;
     inst_base->br = TransExtData::NON_BRANCH;
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(clz)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(clz_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(clz)(TranslationCache& cache, unsigned int inst,
+                                               int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(clz_inst));
     clz_inst* inst_cream = (clz_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -208,8 +214,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(clz)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(cmn)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(cmn_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(cmn)(TranslationCache& cache, unsigned int inst,
+                                               int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(cmn_inst));
     cmn_inst* inst_cream = (cmn_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -223,8 +230,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(cmn)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(cmp)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(cmp_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(cmp)(TranslationCache& cache, unsigned int inst,
+                                               int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(cmp_inst));
     cmp_inst* inst_cream = (cmp_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -238,8 +246,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(cmp)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(cps)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(cps_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(cps)(TranslationCache& cache, unsigned int inst,
+                                               int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(cps_inst));
     cps_inst* inst_cream = (cps_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -256,8 +265,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(cps)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(cpy)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(mov_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(cpy)(TranslationCache& cache, unsigned int inst,
+                                               int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(mov_inst));
     mov_inst* inst_cream = (mov_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -275,8 +285,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(cpy)(unsigned int inst, int index) {
     }
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(eor)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(eor_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(eor)(TranslationCache& cache, unsigned int inst,
+                                               int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(eor_inst));
     eor_inst* inst_cream = (eor_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -295,16 +306,18 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(eor)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(ldc)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(ldc_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(ldc)(TranslationCache& cache, unsigned int inst,
+                                               int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(ldc_inst));
     inst_base->cond = BITS(inst, 28, 31);
     inst_base->idx = index;
     inst_base->br = TransExtData::NON_BRANCH;
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(ldm)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(ldst_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(ldm)(TranslationCache& cache, unsigned int inst,
+                                               int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(ldst_inst));
     ldst_inst* inst_cream = (ldst_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -319,8 +332,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(ldm)(unsigned int inst, int index) {
     }
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(sxth)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(sxtb_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(sxth)(TranslationCache& cache, unsigned int inst,
+                                                int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(sxtb_inst));
     sxtb_inst* inst_cream = (sxtb_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -333,8 +347,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(sxth)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(ldr)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(ldst_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(ldr)(TranslationCache& cache, unsigned int inst,
+                                               int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(ldst_inst));
     ldst_inst* inst_cream = (ldst_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -350,8 +365,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(ldr)(unsigned int inst, int index) {
     return inst_base;
 }
 
-static ARM_INST_PTR INTERPRETER_TRANSLATE(ldrcond)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(ldst_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(ldrcond)(TranslationCache& cache, unsigned int inst,
+                                                   int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(ldst_inst));
     ldst_inst* inst_cream = (ldst_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -367,8 +383,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(ldrcond)(unsigned int inst, int index)
     return inst_base;
 }
 
-static ARM_INST_PTR INTERPRETER_TRANSLATE(uxth)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(uxth_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(uxth)(TranslationCache& cache, unsigned int inst,
+                                                int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(uxth_inst));
     uxth_inst* inst_cream = (uxth_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -381,8 +398,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(uxth)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(uxtah)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(uxtah_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(uxtah)(TranslationCache& cache, unsigned int inst,
+                                                 int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(uxtah_inst));
     uxtah_inst* inst_cream = (uxtah_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -396,8 +414,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(uxtah)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(ldrb)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(ldst_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(ldrb)(TranslationCache& cache, unsigned int inst,
+                                                int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(ldst_inst));
     ldst_inst* inst_cream = (ldst_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -409,8 +428,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(ldrb)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(ldrbt)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(ldst_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(ldrbt)(TranslationCache& cache, unsigned int inst,
+                                                 int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(ldst_inst));
     ldst_inst* inst_cream = (ldst_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -422,8 +442,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(ldrbt)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(ldrd)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(ldst_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(ldrd)(TranslationCache& cache, unsigned int inst,
+                                                int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(ldst_inst));
     ldst_inst* inst_cream = (ldst_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -435,8 +456,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(ldrd)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(ldrex)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(generic_arm_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(ldrex)(TranslationCache& cache, unsigned int inst,
+                                                 int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(generic_arm_inst));
     generic_arm_inst* inst_cream = (generic_arm_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -449,17 +471,21 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(ldrex)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(ldrexb)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(ldrex)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(ldrexb)(TranslationCache& cache, unsigned int inst,
+                                                  int index) {
+    return INTERPRETER_TRANSLATE(ldrex)(cache, inst, index);
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(ldrexh)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(ldrex)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(ldrexh)(TranslationCache& cache, unsigned int inst,
+                                                  int index) {
+    return INTERPRETER_TRANSLATE(ldrex)(cache, inst, index);
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(ldrexd)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(ldrex)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(ldrexd)(TranslationCache& cache, unsigned int inst,
+                                                  int index) {
+    return INTERPRETER_TRANSLATE(ldrex)(cache, inst, index);
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(ldrh)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(ldst_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(ldrh)(TranslationCache& cache, unsigned int inst,
+                                                int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(ldst_inst));
     ldst_inst* inst_cream = (ldst_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -471,8 +497,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(ldrh)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(ldrsb)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(ldst_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(ldrsb)(TranslationCache& cache, unsigned int inst,
+                                                 int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(ldst_inst));
     ldst_inst* inst_cream = (ldst_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -484,8 +511,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(ldrsb)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(ldrsh)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(ldst_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(ldrsh)(TranslationCache& cache, unsigned int inst,
+                                                 int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(ldst_inst));
     ldst_inst* inst_cream = (ldst_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -497,8 +525,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(ldrsh)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(ldrt)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(ldst_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(ldrt)(TranslationCache& cache, unsigned int inst,
+                                                int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(ldst_inst));
     ldst_inst* inst_cream = (ldst_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -513,8 +542,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(ldrt)(unsigned int inst, int index) {
     }
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(mcr)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(mcr_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(mcr)(TranslationCache& cache, unsigned int inst,
+                                               int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(mcr_inst));
     mcr_inst* inst_cream = (mcr_inst*)inst_base->component;
     inst_base->cond = BITS(inst, 28, 31);
     inst_base->idx = index;
@@ -530,8 +560,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(mcr)(unsigned int inst, int index) {
     return inst_base;
 }
 
-static ARM_INST_PTR INTERPRETER_TRANSLATE(mcrr)(unsigned int inst, int index) {
-    arm_inst* const inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(mcrr_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(mcrr)(TranslationCache& cache, unsigned int inst,
+                                                int index) {
+    arm_inst* const inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(mcrr_inst));
     mcrr_inst* const inst_cream = (mcrr_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -547,8 +578,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(mcrr)(unsigned int inst, int index) {
     return inst_base;
 }
 
-static ARM_INST_PTR INTERPRETER_TRANSLATE(mla)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(mla_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(mla)(TranslationCache& cache, unsigned int inst,
+                                               int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(mla_inst));
     mla_inst* inst_cream = (mla_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -563,8 +595,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(mla)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(mov)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(mov_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(mov)(TranslationCache& cache, unsigned int inst,
+                                               int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(mov_inst));
     mov_inst* inst_cream = (mov_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -582,8 +615,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(mov)(unsigned int inst, int index) {
     }
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(mrc)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(mrc_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(mrc)(TranslationCache& cache, unsigned int inst,
+                                               int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(mrc_inst));
     mrc_inst* inst_cream = (mrc_inst*)inst_base->component;
     inst_base->cond = BITS(inst, 28, 31);
     inst_base->idx = index;
@@ -599,12 +633,14 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(mrc)(unsigned int inst, int index) {
     return inst_base;
 }
 
-static ARM_INST_PTR INTERPRETER_TRANSLATE(mrrc)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(mcrr)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(mrrc)(TranslationCache& cache, unsigned int inst,
+                                                int index) {
+    return INTERPRETER_TRANSLATE(mcrr)(cache, inst, index);
 }
 
-static ARM_INST_PTR INTERPRETER_TRANSLATE(mrs)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(mrs_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(mrs)(TranslationCache& cache, unsigned int inst,
+                                               int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(mrs_inst));
     mrs_inst* inst_cream = (mrs_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -616,8 +652,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(mrs)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(msr)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(msr_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(msr)(TranslationCache& cache, unsigned int inst,
+                                               int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(msr_inst));
     msr_inst* inst_cream = (msr_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -630,8 +667,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(msr)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(mul)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(mul_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(mul)(TranslationCache& cache, unsigned int inst,
+                                               int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(mul_inst));
     mul_inst* inst_cream = (mul_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -645,8 +683,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(mul)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(mvn)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(mvn_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(mvn)(TranslationCache& cache, unsigned int inst,
+                                               int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(mvn_inst));
     mvn_inst* inst_cream = (mvn_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -664,8 +703,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(mvn)(unsigned int inst, int index) {
     }
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(orr)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(orr_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(orr)(TranslationCache& cache, unsigned int inst,
+                                               int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(orr_inst));
     orr_inst* inst_cream = (orr_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -686,8 +726,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(orr)(unsigned int inst, int index) {
 }
 
 // NOP introduced in ARMv6K.
-static ARM_INST_PTR INTERPRETER_TRANSLATE(nop)(unsigned int inst, int index) {
-    arm_inst* const inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(nop)(TranslationCache& cache, unsigned int inst,
+                                               int index) {
+    arm_inst* const inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst));
 
     inst_base->cond = BITS(inst, 28, 31);
     inst_base->idx = index;
@@ -696,8 +737,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(nop)(unsigned int inst, int index) {
     return inst_base;
 }
 
-static ARM_INST_PTR INTERPRETER_TRANSLATE(pkhbt)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(pkh_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(pkhbt)(TranslationCache& cache, unsigned int inst,
+                                                 int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(pkh_inst));
     pkh_inst* inst_cream = (pkh_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -712,12 +754,14 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(pkhbt)(unsigned int inst, int index) {
     return inst_base;
 }
 
-static ARM_INST_PTR INTERPRETER_TRANSLATE(pkhtb)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(pkhbt)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(pkhtb)(TranslationCache& cache, unsigned int inst,
+                                                 int index) {
+    return INTERPRETER_TRANSLATE(pkhbt)(cache, inst, index);
 }
 
-static ARM_INST_PTR INTERPRETER_TRANSLATE(pld)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(pld_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(pld)(TranslationCache& cache, unsigned int inst,
+                                               int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(pld_inst));
 
     inst_base->cond = BITS(inst, 28, 31);
     inst_base->idx = index;
@@ -726,8 +770,10 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(pld)(unsigned int inst, int index) {
     return inst_base;
 }
 
-static ARM_INST_PTR INTERPRETER_TRANSLATE(qadd)(unsigned int inst, int index) {
-    arm_inst* const inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(generic_arm_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(qadd)(TranslationCache& cache, unsigned int inst,
+                                                int index) {
+    arm_inst* const inst_base =
+        (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(generic_arm_inst));
     generic_arm_inst* const inst_cream = (generic_arm_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -741,18 +787,23 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(qadd)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(qdadd)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(qadd)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(qdadd)(TranslationCache& cache, unsigned int inst,
+                                                 int index) {
+    return INTERPRETER_TRANSLATE(qadd)(cache, inst, index);
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(qdsub)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(qadd)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(qdsub)(TranslationCache& cache, unsigned int inst,
+                                                 int index) {
+    return INTERPRETER_TRANSLATE(qadd)(cache, inst, index);
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(qsub)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(qadd)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(qsub)(TranslationCache& cache, unsigned int inst,
+                                                int index) {
+    return INTERPRETER_TRANSLATE(qadd)(cache, inst, index);
 }
 
-static ARM_INST_PTR INTERPRETER_TRANSLATE(qadd8)(unsigned int inst, int index) {
-    arm_inst* const inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(generic_arm_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(qadd8)(TranslationCache& cache, unsigned int inst,
+                                                 int index) {
+    arm_inst* const inst_base =
+        (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(generic_arm_inst));
     generic_arm_inst* const inst_cream = (generic_arm_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -767,24 +818,30 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(qadd8)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(qadd16)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(qadd8)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(qadd16)(TranslationCache& cache, unsigned int inst,
+                                                  int index) {
+    return INTERPRETER_TRANSLATE(qadd8)(cache, inst, index);
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(qaddsubx)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(qadd8)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(qaddsubx)(TranslationCache& cache, unsigned int inst,
+                                                    int index) {
+    return INTERPRETER_TRANSLATE(qadd8)(cache, inst, index);
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(qsub8)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(qadd8)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(qsub8)(TranslationCache& cache, unsigned int inst,
+                                                 int index) {
+    return INTERPRETER_TRANSLATE(qadd8)(cache, inst, index);
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(qsub16)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(qadd8)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(qsub16)(TranslationCache& cache, unsigned int inst,
+                                                  int index) {
+    return INTERPRETER_TRANSLATE(qadd8)(cache, inst, index);
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(qsubaddx)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(qadd8)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(qsubaddx)(TranslationCache& cache, unsigned int inst,
+                                                    int index) {
+    return INTERPRETER_TRANSLATE(qadd8)(cache, inst, index);
 }
 
-static ARM_INST_PTR INTERPRETER_TRANSLATE(rev)(unsigned int inst, int index) {
-    arm_inst* const inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(rev_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(rev)(TranslationCache& cache, unsigned int inst,
+                                               int index) {
+    arm_inst* const inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(rev_inst));
     rev_inst* const inst_cream = (rev_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -798,15 +855,18 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(rev)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(rev16)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(rev)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(rev16)(TranslationCache& cache, unsigned int inst,
+                                                 int index) {
+    return INTERPRETER_TRANSLATE(rev)(cache, inst, index);
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(revsh)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(rev)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(revsh)(TranslationCache& cache, unsigned int inst,
+                                                 int index) {
+    return INTERPRETER_TRANSLATE(rev)(cache, inst, index);
 }
 
-static ARM_INST_PTR INTERPRETER_TRANSLATE(rfe)(unsigned int inst, int index) {
-    arm_inst* const inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(ldst_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(rfe)(TranslationCache& cache, unsigned int inst,
+                                               int index) {
+    arm_inst* const inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(ldst_inst));
     ldst_inst* const inst_cream = (ldst_inst*)inst_base->component;
 
     inst_base->cond = AL;
@@ -819,8 +879,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(rfe)(unsigned int inst, int index) {
     return inst_base;
 }
 
-static ARM_INST_PTR INTERPRETER_TRANSLATE(rsb)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(rsb_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(rsb)(TranslationCache& cache, unsigned int inst,
+                                               int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(rsb_inst));
     rsb_inst* inst_cream = (rsb_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -839,8 +900,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(rsb)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(rsc)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(rsc_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(rsc)(TranslationCache& cache, unsigned int inst,
+                                               int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(rsc_inst));
     rsc_inst* inst_cream = (rsc_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -859,8 +921,10 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(rsc)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(sadd8)(unsigned int inst, int index) {
-    arm_inst* const inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(generic_arm_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(sadd8)(TranslationCache& cache, unsigned int inst,
+                                                 int index) {
+    arm_inst* const inst_base =
+        (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(generic_arm_inst));
     generic_arm_inst* const inst_cream = (generic_arm_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -875,24 +939,30 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(sadd8)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(sadd16)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(sadd8)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(sadd16)(TranslationCache& cache, unsigned int inst,
+                                                  int index) {
+    return INTERPRETER_TRANSLATE(sadd8)(cache, inst, index);
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(saddsubx)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(sadd8)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(saddsubx)(TranslationCache& cache, unsigned int inst,
+                                                    int index) {
+    return INTERPRETER_TRANSLATE(sadd8)(cache, inst, index);
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(ssub8)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(sadd8)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(ssub8)(TranslationCache& cache, unsigned int inst,
+                                                 int index) {
+    return INTERPRETER_TRANSLATE(sadd8)(cache, inst, index);
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(ssub16)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(sadd8)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(ssub16)(TranslationCache& cache, unsigned int inst,
+                                                  int index) {
+    return INTERPRETER_TRANSLATE(sadd8)(cache, inst, index);
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(ssubaddx)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(sadd8)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(ssubaddx)(TranslationCache& cache, unsigned int inst,
+                                                    int index) {
+    return INTERPRETER_TRANSLATE(sadd8)(cache, inst, index);
 }
 
-static ARM_INST_PTR INTERPRETER_TRANSLATE(sbc)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(sbc_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(sbc)(TranslationCache& cache, unsigned int inst,
+                                               int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(sbc_inst));
     sbc_inst* inst_cream = (sbc_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -911,8 +981,10 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(sbc)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(sel)(unsigned int inst, int index) {
-    arm_inst* const inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(generic_arm_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(sel)(TranslationCache& cache, unsigned int inst,
+                                               int index) {
+    arm_inst* const inst_base =
+        (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(generic_arm_inst));
     generic_arm_inst* const inst_cream = (generic_arm_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -928,8 +1000,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(sel)(unsigned int inst, int index) {
     return inst_base;
 }
 
-static ARM_INST_PTR INTERPRETER_TRANSLATE(setend)(unsigned int inst, int index) {
-    arm_inst* const inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(setend_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(setend)(TranslationCache& cache, unsigned int inst,
+                                                  int index) {
+    arm_inst* const inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(setend_inst));
     setend_inst* const inst_cream = (setend_inst*)inst_base->component;
 
     inst_base->cond = AL;
@@ -941,8 +1014,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(setend)(unsigned int inst, int index)
     return inst_base;
 }
 
-static ARM_INST_PTR INTERPRETER_TRANSLATE(sev)(unsigned int inst, int index) {
-    arm_inst* const inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(sev)(TranslationCache& cache, unsigned int inst,
+                                               int index) {
+    arm_inst* const inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst));
 
     inst_base->cond = BITS(inst, 28, 31);
     inst_base->idx = index;
@@ -951,8 +1025,10 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(sev)(unsigned int inst, int index) {
     return inst_base;
 }
 
-static ARM_INST_PTR INTERPRETER_TRANSLATE(shadd8)(unsigned int inst, int index) {
-    arm_inst* const inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(generic_arm_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(shadd8)(TranslationCache& cache, unsigned int inst,
+                                                  int index) {
+    arm_inst* const inst_base =
+        (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(generic_arm_inst));
     generic_arm_inst* const inst_cream = (generic_arm_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -967,24 +1043,30 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(shadd8)(unsigned int inst, int index)
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(shadd16)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(shadd8)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(shadd16)(TranslationCache& cache, unsigned int inst,
+                                                   int index) {
+    return INTERPRETER_TRANSLATE(shadd8)(cache, inst, index);
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(shaddsubx)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(shadd8)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(shaddsubx)(TranslationCache& cache, unsigned int inst,
+                                                     int index) {
+    return INTERPRETER_TRANSLATE(shadd8)(cache, inst, index);
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(shsub8)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(shadd8)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(shsub8)(TranslationCache& cache, unsigned int inst,
+                                                  int index) {
+    return INTERPRETER_TRANSLATE(shadd8)(cache, inst, index);
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(shsub16)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(shadd8)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(shsub16)(TranslationCache& cache, unsigned int inst,
+                                                   int index) {
+    return INTERPRETER_TRANSLATE(shadd8)(cache, inst, index);
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(shsubaddx)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(shadd8)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(shsubaddx)(TranslationCache& cache, unsigned int inst,
+                                                     int index) {
+    return INTERPRETER_TRANSLATE(shadd8)(cache, inst, index);
 }
 
-static ARM_INST_PTR INTERPRETER_TRANSLATE(smla)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(smla_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(smla)(TranslationCache& cache, unsigned int inst,
+                                                int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(smla_inst));
     smla_inst* inst_cream = (smla_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1001,8 +1083,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(smla)(unsigned int inst, int index) {
     return inst_base;
 }
 
-static ARM_INST_PTR INTERPRETER_TRANSLATE(smlad)(unsigned int inst, int index) {
-    arm_inst* const inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(smlad_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(smlad)(TranslationCache& cache, unsigned int inst,
+                                                 int index) {
+    arm_inst* const inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(smlad_inst));
     smlad_inst* const inst_cream = (smlad_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1019,18 +1102,22 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(smlad)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(smuad)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(smlad)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(smuad)(TranslationCache& cache, unsigned int inst,
+                                                 int index) {
+    return INTERPRETER_TRANSLATE(smlad)(cache, inst, index);
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(smusd)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(smlad)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(smusd)(TranslationCache& cache, unsigned int inst,
+                                                 int index) {
+    return INTERPRETER_TRANSLATE(smlad)(cache, inst, index);
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(smlsd)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(smlad)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(smlsd)(TranslationCache& cache, unsigned int inst,
+                                                 int index) {
+    return INTERPRETER_TRANSLATE(smlad)(cache, inst, index);
 }
 
-static ARM_INST_PTR INTERPRETER_TRANSLATE(smlal)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(umlal_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(smlal)(TranslationCache& cache, unsigned int inst,
+                                                 int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(umlal_inst));
     umlal_inst* inst_cream = (umlal_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1046,8 +1133,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(smlal)(unsigned int inst, int index) {
     return inst_base;
 }
 
-static ARM_INST_PTR INTERPRETER_TRANSLATE(smlalxy)(unsigned int inst, int index) {
-    arm_inst* const inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(smlalxy_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(smlalxy)(TranslationCache& cache, unsigned int inst,
+                                                   int index) {
+    arm_inst* const inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(smlalxy_inst));
     smlalxy_inst* const inst_cream = (smlalxy_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1064,8 +1152,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(smlalxy)(unsigned int inst, int index)
     return inst_base;
 }
 
-static ARM_INST_PTR INTERPRETER_TRANSLATE(smlaw)(unsigned int inst, int index) {
-    arm_inst* const inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(smlad_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(smlaw)(TranslationCache& cache, unsigned int inst,
+                                                 int index) {
+    arm_inst* const inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(smlad_inst));
     smlad_inst* const inst_cream = (smlad_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1081,8 +1170,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(smlaw)(unsigned int inst, int index) {
     return inst_base;
 }
 
-static ARM_INST_PTR INTERPRETER_TRANSLATE(smlald)(unsigned int inst, int index) {
-    arm_inst* const inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(smlald_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(smlald)(TranslationCache& cache, unsigned int inst,
+                                                  int index) {
+    arm_inst* const inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(smlald_inst));
     smlald_inst* const inst_cream = (smlald_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1099,12 +1189,14 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(smlald)(unsigned int inst, int index)
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(smlsld)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(smlald)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(smlsld)(TranslationCache& cache, unsigned int inst,
+                                                  int index) {
+    return INTERPRETER_TRANSLATE(smlald)(cache, inst, index);
 }
 
-static ARM_INST_PTR INTERPRETER_TRANSLATE(smmla)(unsigned int inst, int index) {
-    arm_inst* const inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(smlad_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(smmla)(TranslationCache& cache, unsigned int inst,
+                                                 int index) {
+    arm_inst* const inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(smlad_inst));
     smlad_inst* const inst_cream = (smlad_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1121,15 +1213,18 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(smmla)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(smmls)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(smmla)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(smmls)(TranslationCache& cache, unsigned int inst,
+                                                 int index) {
+    return INTERPRETER_TRANSLATE(smmla)(cache, inst, index);
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(smmul)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(smmla)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(smmul)(TranslationCache& cache, unsigned int inst,
+                                                 int index) {
+    return INTERPRETER_TRANSLATE(smmla)(cache, inst, index);
 }
 
-static ARM_INST_PTR INTERPRETER_TRANSLATE(smul)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(smul_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(smul)(TranslationCache& cache, unsigned int inst,
+                                                int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(smul_inst));
     smul_inst* inst_cream = (smul_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1145,8 +1240,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(smul)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(smull)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(umull_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(smull)(TranslationCache& cache, unsigned int inst,
+                                                 int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(umull_inst));
     umull_inst* inst_cream = (umull_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1162,8 +1258,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(smull)(unsigned int inst, int index) {
     return inst_base;
 }
 
-static ARM_INST_PTR INTERPRETER_TRANSLATE(smulw)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(smlad_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(smulw)(TranslationCache& cache, unsigned int inst,
+                                                 int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(smlad_inst));
     smlad_inst* inst_cream = (smlad_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1178,8 +1275,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(smulw)(unsigned int inst, int index) {
     return inst_base;
 }
 
-static ARM_INST_PTR INTERPRETER_TRANSLATE(srs)(unsigned int inst, int index) {
-    arm_inst* const inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(ldst_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(srs)(TranslationCache& cache, unsigned int inst,
+                                               int index) {
+    arm_inst* const inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(ldst_inst));
     ldst_inst* const inst_cream = (ldst_inst*)inst_base->component;
 
     inst_base->cond = AL;
@@ -1192,8 +1290,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(srs)(unsigned int inst, int index) {
     return inst_base;
 }
 
-static ARM_INST_PTR INTERPRETER_TRANSLATE(ssat)(unsigned int inst, int index) {
-    arm_inst* const inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(ssat_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(ssat)(TranslationCache& cache, unsigned int inst,
+                                                int index) {
+    arm_inst* const inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(ssat_inst));
     ssat_inst* const inst_cream = (ssat_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1208,8 +1307,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(ssat)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(ssat16)(unsigned int inst, int index) {
-    arm_inst* const inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(ssat_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(ssat16)(TranslationCache& cache, unsigned int inst,
+                                                  int index) {
+    arm_inst* const inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(ssat_inst));
     ssat_inst* const inst_cream = (ssat_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1223,16 +1323,18 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(ssat16)(unsigned int inst, int index)
     return inst_base;
 }
 
-static ARM_INST_PTR INTERPRETER_TRANSLATE(stc)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(stc_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(stc)(TranslationCache& cache, unsigned int inst,
+                                               int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(stc_inst));
     inst_base->cond = BITS(inst, 28, 31);
     inst_base->idx = index;
     inst_base->br = TransExtData::NON_BRANCH;
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(stm)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(ldst_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(stm)(TranslationCache& cache, unsigned int inst,
+                                               int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(ldst_inst));
     ldst_inst* inst_cream = (ldst_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1243,8 +1345,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(stm)(unsigned int inst, int index) {
     inst_cream->get_addr = GetAddressingOp(inst);
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(sxtb)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(sxtb_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(sxtb)(TranslationCache& cache, unsigned int inst,
+                                                int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(sxtb_inst));
     sxtb_inst* inst_cream = (sxtb_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1257,8 +1360,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(sxtb)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(str)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(ldst_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(str)(TranslationCache& cache, unsigned int inst,
+                                               int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(ldst_inst));
     ldst_inst* inst_cream = (ldst_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1270,8 +1374,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(str)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(uxtb)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(uxth_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(uxtb)(TranslationCache& cache, unsigned int inst,
+                                                int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(uxth_inst));
     uxth_inst* inst_cream = (uxth_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1284,8 +1389,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(uxtb)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(uxtab)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(uxtab_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(uxtab)(TranslationCache& cache, unsigned int inst,
+                                                 int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(uxtab_inst));
     uxtab_inst* inst_cream = (uxtab_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1299,8 +1405,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(uxtab)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(strb)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(ldst_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(strb)(TranslationCache& cache, unsigned int inst,
+                                                int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(ldst_inst));
     ldst_inst* inst_cream = (ldst_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1312,8 +1419,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(strb)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(strbt)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(ldst_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(strbt)(TranslationCache& cache, unsigned int inst,
+                                                 int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(ldst_inst));
     ldst_inst* inst_cream = (ldst_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1325,8 +1433,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(strbt)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(strd)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(ldst_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(strd)(TranslationCache& cache, unsigned int inst,
+                                                int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(ldst_inst));
     ldst_inst* inst_cream = (ldst_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1338,8 +1447,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(strd)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(strex)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(generic_arm_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(strex)(TranslationCache& cache, unsigned int inst,
+                                                 int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(generic_arm_inst));
     generic_arm_inst* inst_cream = (generic_arm_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1352,17 +1462,21 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(strex)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(strexb)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(strex)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(strexb)(TranslationCache& cache, unsigned int inst,
+                                                  int index) {
+    return INTERPRETER_TRANSLATE(strex)(cache, inst, index);
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(strexh)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(strex)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(strexh)(TranslationCache& cache, unsigned int inst,
+                                                  int index) {
+    return INTERPRETER_TRANSLATE(strex)(cache, inst, index);
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(strexd)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(strex)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(strexd)(TranslationCache& cache, unsigned int inst,
+                                                  int index) {
+    return INTERPRETER_TRANSLATE(strex)(cache, inst, index);
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(strh)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(ldst_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(strh)(TranslationCache& cache, unsigned int inst,
+                                                int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(ldst_inst));
     ldst_inst* inst_cream = (ldst_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1374,8 +1488,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(strh)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(strt)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(ldst_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(strt)(TranslationCache& cache, unsigned int inst,
+                                                int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(ldst_inst));
     ldst_inst* inst_cream = (ldst_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1387,8 +1502,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(strt)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(sub)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(sub_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(sub)(TranslationCache& cache, unsigned int inst,
+                                               int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(sub_inst));
     sub_inst* inst_cream = (sub_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1407,8 +1523,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(sub)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(swi)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(swi_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(swi)(TranslationCache& cache, unsigned int inst,
+                                               int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(swi_inst));
     swi_inst* inst_cream = (swi_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1418,8 +1535,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(swi)(unsigned int inst, int index) {
     inst_cream->num = BITS(inst, 0, 23);
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(swp)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(swp_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(swp)(TranslationCache& cache, unsigned int inst,
+                                               int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(swp_inst));
     swp_inst* inst_cream = (swp_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1432,8 +1550,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(swp)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(swpb)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(swp_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(swpb)(TranslationCache& cache, unsigned int inst,
+                                                int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(swp_inst));
     swp_inst* inst_cream = (swp_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1446,8 +1565,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(swpb)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(sxtab)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(sxtab_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(sxtab)(TranslationCache& cache, unsigned int inst,
+                                                 int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(sxtab_inst));
     sxtab_inst* inst_cream = (sxtab_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1462,8 +1582,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(sxtab)(unsigned int inst, int index) {
     return inst_base;
 }
 
-static ARM_INST_PTR INTERPRETER_TRANSLATE(sxtab16)(unsigned int inst, int index) {
-    arm_inst* const inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(sxtab_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(sxtab16)(TranslationCache& cache, unsigned int inst,
+                                                   int index) {
+    arm_inst* const inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(sxtab_inst));
     sxtab_inst* const inst_cream = (sxtab_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1477,12 +1598,14 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(sxtab16)(unsigned int inst, int index)
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(sxtb16)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(sxtab16)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(sxtb16)(TranslationCache& cache, unsigned int inst,
+                                                  int index) {
+    return INTERPRETER_TRANSLATE(sxtab16)(cache, inst, index);
 }
 
-static ARM_INST_PTR INTERPRETER_TRANSLATE(sxtah)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(sxtah_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(sxtah)(TranslationCache& cache, unsigned int inst,
+                                                 int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(sxtah_inst));
     sxtah_inst* inst_cream = (sxtah_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1497,8 +1620,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(sxtah)(unsigned int inst, int index) {
     return inst_base;
 }
 
-static ARM_INST_PTR INTERPRETER_TRANSLATE(teq)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(teq_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(teq)(TranslationCache& cache, unsigned int inst,
+                                               int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(teq_inst));
     teq_inst* inst_cream = (teq_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1512,8 +1636,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(teq)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(tst)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(tst_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(tst)(TranslationCache& cache, unsigned int inst,
+                                               int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(tst_inst));
     tst_inst* inst_cream = (tst_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1530,8 +1655,10 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(tst)(unsigned int inst, int index) {
     return inst_base;
 }
 
-static ARM_INST_PTR INTERPRETER_TRANSLATE(uadd8)(unsigned int inst, int index) {
-    arm_inst* const inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(generic_arm_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(uadd8)(TranslationCache& cache, unsigned int inst,
+                                                 int index) {
+    arm_inst* const inst_base =
+        (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(generic_arm_inst));
     generic_arm_inst* const inst_cream = (generic_arm_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1546,24 +1673,31 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(uadd8)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(uadd16)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(uadd8)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(uadd16)(TranslationCache& cache, unsigned int inst,
+                                                  int index) {
+    return INTERPRETER_TRANSLATE(uadd8)(cache, inst, index);
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(uaddsubx)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(uadd8)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(uaddsubx)(TranslationCache& cache, unsigned int inst,
+                                                    int index) {
+    return INTERPRETER_TRANSLATE(uadd8)(cache, inst, index);
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(usub8)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(uadd8)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(usub8)(TranslationCache& cache, unsigned int inst,
+                                                 int index) {
+    return INTERPRETER_TRANSLATE(uadd8)(cache, inst, index);
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(usub16)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(uadd8)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(usub16)(TranslationCache& cache, unsigned int inst,
+                                                  int index) {
+    return INTERPRETER_TRANSLATE(uadd8)(cache, inst, index);
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(usubaddx)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(uadd8)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(usubaddx)(TranslationCache& cache, unsigned int inst,
+                                                    int index) {
+    return INTERPRETER_TRANSLATE(uadd8)(cache, inst, index);
 }
 
-static ARM_INST_PTR INTERPRETER_TRANSLATE(uhadd8)(unsigned int inst, int index) {
-    arm_inst* const inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(generic_arm_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(uhadd8)(TranslationCache& cache, unsigned int inst,
+                                                  int index) {
+    arm_inst* const inst_base =
+        (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(generic_arm_inst));
     generic_arm_inst* const inst_cream = (generic_arm_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1578,23 +1712,29 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(uhadd8)(unsigned int inst, int index)
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(uhadd16)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(uhadd8)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(uhadd16)(TranslationCache& cache, unsigned int inst,
+                                                   int index) {
+    return INTERPRETER_TRANSLATE(uhadd8)(cache, inst, index);
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(uhaddsubx)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(uhadd8)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(uhaddsubx)(TranslationCache& cache, unsigned int inst,
+                                                     int index) {
+    return INTERPRETER_TRANSLATE(uhadd8)(cache, inst, index);
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(uhsub8)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(uhadd8)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(uhsub8)(TranslationCache& cache, unsigned int inst,
+                                                  int index) {
+    return INTERPRETER_TRANSLATE(uhadd8)(cache, inst, index);
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(uhsub16)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(uhadd8)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(uhsub16)(TranslationCache& cache, unsigned int inst,
+                                                   int index) {
+    return INTERPRETER_TRANSLATE(uhadd8)(cache, inst, index);
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(uhsubaddx)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(uhadd8)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(uhsubaddx)(TranslationCache& cache, unsigned int inst,
+                                                     int index) {
+    return INTERPRETER_TRANSLATE(uhadd8)(cache, inst, index);
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(umaal)(unsigned int inst, int index) {
-    arm_inst* const inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(umaal_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(umaal)(TranslationCache& cache, unsigned int inst,
+                                                 int index) {
+    arm_inst* const inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(umaal_inst));
     umaal_inst* const inst_cream = (umaal_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1608,8 +1748,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(umaal)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(umlal)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(umlal_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(umlal)(TranslationCache& cache, unsigned int inst,
+                                                 int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(umlal_inst));
     umlal_inst* inst_cream = (umlal_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1624,8 +1765,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(umlal)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(umull)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(umull_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(umull)(TranslationCache& cache, unsigned int inst,
+                                                 int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(umull_inst));
     umull_inst* inst_cream = (umull_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1641,11 +1783,14 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(umull)(unsigned int inst, int index) {
     return inst_base;
 }
 
-static ARM_INST_PTR INTERPRETER_TRANSLATE(b_2_thumb)(unsigned int tinst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(b_2_thumb));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(b_2_thumb)(TranslationCache& cache, unsigned int tinst,
+                                                     int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(b_2_thumb));
     b_2_thumb* inst_cream = (b_2_thumb*)inst_base->component;
 
     inst_cream->imm = ((tinst & 0x3FF) << 1) | ((tinst & (1 << 10)) ? 0xFFFFF800 : 0);
+    inst_cream->taken = {};
+    inst_cream->idle_loop = false;
 
     inst_base->idx = index;
     inst_base->br = TransExtData::DIRECT_BRANCH;
@@ -1653,20 +1798,25 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(b_2_thumb)(unsigned int tinst, int ind
     return inst_base;
 }
 
-static ARM_INST_PTR INTERPRETER_TRANSLATE(b_cond_thumb)(unsigned int tinst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(b_cond_thumb));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(b_cond_thumb)(TranslationCache& cache, unsigned int tinst,
+                                                        int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(b_cond_thumb));
     b_cond_thumb* inst_cream = (b_cond_thumb*)inst_base->component;
 
     inst_cream->imm = (((tinst & 0x7F) << 1) | ((tinst & (1 << 7)) ? 0xFFFFFF00 : 0));
     inst_cream->cond = ((tinst >> 8) & 0xf);
+    inst_cream->taken = {};
+    inst_cream->not_taken = {};
+    inst_cream->idle_loop = false;
     inst_base->idx = index;
     inst_base->br = TransExtData::DIRECT_BRANCH;
 
     return inst_base;
 }
 
-static ARM_INST_PTR INTERPRETER_TRANSLATE(bl_1_thumb)(unsigned int tinst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(bl_1_thumb));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(bl_1_thumb)(TranslationCache& cache, unsigned int tinst,
+                                                      int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(bl_1_thumb));
     bl_1_thumb* inst_cream = (bl_1_thumb*)inst_base->component;
 
     inst_cream->imm = (((tinst & 0x07FF) << 12) | ((tinst & (1 << 10)) ? 0xFF800000 : 0));
@@ -1675,8 +1825,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(bl_1_thumb)(unsigned int tinst, int in
     inst_base->br = TransExtData::NON_BRANCH;
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(bl_2_thumb)(unsigned int tinst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(bl_2_thumb));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(bl_2_thumb)(TranslationCache& cache, unsigned int tinst,
+                                                      int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(bl_2_thumb));
     bl_2_thumb* inst_cream = (bl_2_thumb*)inst_base->component;
 
     inst_cream->imm = (tinst & 0x07FF) << 1;
@@ -1685,8 +1836,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(bl_2_thumb)(unsigned int tinst, int in
     inst_base->br = TransExtData::DIRECT_BRANCH;
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(blx_1_thumb)(unsigned int tinst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(blx_1_thumb));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(blx_1_thumb)(TranslationCache& cache, unsigned int tinst,
+                                                       int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(blx_1_thumb));
     blx_1_thumb* inst_cream = (blx_1_thumb*)inst_base->component;
 
     inst_cream->imm = (tinst & 0x07FF) << 1;
@@ -1697,8 +1849,10 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(blx_1_thumb)(unsigned int tinst, int i
     return inst_base;
 }
 
-static ARM_INST_PTR INTERPRETER_TRANSLATE(uqadd8)(unsigned int inst, int index) {
-    arm_inst* const inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(generic_arm_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(uqadd8)(TranslationCache& cache, unsigned int inst,
+                                                  int index) {
+    arm_inst* const inst_base =
+        (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(generic_arm_inst));
     generic_arm_inst* const inst_cream = (generic_arm_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1713,23 +1867,30 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(uqadd8)(unsigned int inst, int index)
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(uqadd16)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(uqadd8)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(uqadd16)(TranslationCache& cache, unsigned int inst,
+                                                   int index) {
+    return INTERPRETER_TRANSLATE(uqadd8)(cache, inst, index);
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(uqaddsubx)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(uqadd8)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(uqaddsubx)(TranslationCache& cache, unsigned int inst,
+                                                     int index) {
+    return INTERPRETER_TRANSLATE(uqadd8)(cache, inst, index);
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(uqsub8)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(uqadd8)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(uqsub8)(TranslationCache& cache, unsigned int inst,
+                                                  int index) {
+    return INTERPRETER_TRANSLATE(uqadd8)(cache, inst, index);
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(uqsub16)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(uqadd8)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(uqsub16)(TranslationCache& cache, unsigned int inst,
+                                                   int index) {
+    return INTERPRETER_TRANSLATE(uqadd8)(cache, inst, index);
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(uqsubaddx)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(uqadd8)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(uqsubaddx)(TranslationCache& cache, unsigned int inst,
+                                                     int index) {
+    return INTERPRETER_TRANSLATE(uqadd8)(cache, inst, index);
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(usada8)(unsigned int inst, int index) {
-    arm_inst* const inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(generic_arm_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(usada8)(TranslationCache& cache, unsigned int inst,
+                                                  int index) {
+    arm_inst* const inst_base =
+        (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(generic_arm_inst));
     generic_arm_inst* const inst_cream = (generic_arm_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1745,18 +1906,22 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(usada8)(unsigned int inst, int index)
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(usad8)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(usada8)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(usad8)(TranslationCache& cache, unsigned int inst,
+                                                 int index) {
+    return INTERPRETER_TRANSLATE(usada8)(cache, inst, index);
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(usat)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(ssat)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(usat)(TranslationCache& cache, unsigned int inst,
+                                                int index) {
+    return INTERPRETER_TRANSLATE(ssat)(cache, inst, index);
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(usat16)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(ssat16)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(usat16)(TranslationCache& cache, unsigned int inst,
+                                                  int index) {
+    return INTERPRETER_TRANSLATE(ssat16)(cache, inst, index);
 }
 
-static ARM_INST_PTR INTERPRETER_TRANSLATE(uxtab16)(unsigned int inst, int index) {
-    arm_inst* const inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(uxtab_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(uxtab16)(TranslationCache& cache, unsigned int inst,
+                                                   int index) {
+    arm_inst* const inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(uxtab_inst));
     uxtab_inst* const inst_cream = (uxtab_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1770,12 +1935,14 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(uxtab16)(unsigned int inst, int index)
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(uxtb16)(unsigned int inst, int index) {
-    return INTERPRETER_TRANSLATE(uxtab16)(inst, index);
+static ARM_INST_PTR INTERPRETER_TRANSLATE(uxtb16)(TranslationCache& cache, unsigned int inst,
+                                                  int index) {
+    return INTERPRETER_TRANSLATE(uxtab16)(cache, inst, index);
 }
 
-static ARM_INST_PTR INTERPRETER_TRANSLATE(wfe)(unsigned int inst, int index) {
-    arm_inst* const inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(wfe)(TranslationCache& cache, unsigned int inst,
+                                               int index) {
+    arm_inst* const inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst));
 
     inst_base->cond = BITS(inst, 28, 31);
     inst_base->idx = index;
@@ -1783,8 +1950,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(wfe)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(wfi)(unsigned int inst, int index) {
-    arm_inst* const inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(wfi)(TranslationCache& cache, unsigned int inst,
+                                               int index) {
+    arm_inst* const inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst));
 
     inst_base->cond = BITS(inst, 28, 31);
     inst_base->idx = index;
@@ -1792,8 +1960,9 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(wfi)(unsigned int inst, int index) {
 
     return inst_base;
 }
-static ARM_INST_PTR INTERPRETER_TRANSLATE(yield)(unsigned int inst, int index) {
-    arm_inst* const inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(yield)(TranslationCache& cache, unsigned int inst,
+                                                 int index) {
+    arm_inst* const inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst));
 
     inst_base->cond = BITS(inst, 28, 31);
     inst_base->idx = index;
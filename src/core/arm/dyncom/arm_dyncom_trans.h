@@ -8,6 +8,7 @@
 #include "common/common_types.h"
 
 struct ARMul_State;
+class TranslationCache;
 typedef unsigned int (*shtop_fp_t)(ARMul_State* cpu, unsigned int sht_oper);
 
 enum class TransExtData {
@@ -83,11 +84,19 @@ struct eor_inst {
     shtop_fp_t shtop_func;
 };
 
+/// Cached location of a branch target in the translation cache. A link is only followed while the
+/// cache generation it was created in is still current, i.e. no block has been dropped since.
+struct block_link {
+    u32 generation;
+    u32 offset;
+};
+
 struct bbl_inst {
     unsigned int L;
     int signed_immed_24;
-    unsigned int next_addr;
-    unsigned int jmp_addr;
+    block_link taken;
+    block_link not_taken;
+    bool idle_loop;
 };
 
 struct bx_inst {
@@ -451,10 +460,15 @@ struct setend_inst {
 
 struct b_2_thumb {
     unsigned int imm;
+    block_link taken;
+    bool idle_loop;
 };
 struct b_cond_thumb {
     unsigned int imm;
     unsigned int cond;
+    block_link taken;
+    block_link not_taken;
+    bool idle_loop;
 };
 
 struct bl_1_thumb {
@@ -488,11 +502,7 @@ struct ldst_inst {
 };
 
 typedef arm_inst* ARM_INST_PTR;
-typedef ARM_INST_PTR (*transop_fp_t)(unsigned int, int);
+typedef ARM_INST_PTR (*transop_fp_t)(TranslationCache&, unsigned int, int);
 
 extern const transop_fp_t arm_instruction_trans[];
 extern const std::size_t arm_instruction_trans_len;
-
-#define TRANS_CACHE_SIZE (64 * 1024 * 2000)
-extern char trans_cache_buf[TRANS_CACHE_SIZE];
-extern std::size_t trans_cache_buf_top;
@@ -0,0 +1,128 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include "common/assert.h"
+#include "core/arm/dyncom/arm_dyncom_trans_cache.h"
+#include "core/memory.h"
+
+// The buffer is deliberately left uninitialized so that the host only commits the pages that
+// actually get used.
+TranslationCache::TranslationCache() : buffer(new u8[CACHE_SIZE]) {}
+
+TranslationCache::~TranslationCache() = default;
+
+std::optional<std::size_t> TranslationCache::FindBlock(u32 pc) const {
+    const auto iter = blocks.find(pc);
+    if (iter == blocks.end()) {
+        return std::nullopt;
+    }
+    return iter->second;
+}
+
+std::size_t TranslationCache::BeginBlock(u32 pc) {
+    if (!HasSpaceForInstruction()) {
+        current_segment = (current_segment + 1) % NUM_SEGMENTS;
+        RecycleSegment(current_segment);
+        top = current_segment * SEGMENT_SIZE;
+    }
+
+    const auto [iter, inserted] = blocks.insert_or_assign(pc, top);
+    if (inserted) {
+        page_blocks[pc >> Memory::PAGE_BITS].push_back(pc);
+    }
+    segment_blocks[current_segment].push_back(pc);
+    return top;
+}
+
+bool TranslationCache::HasSpaceForInstruction() const {
+    return (current_segment + 1) * SEGMENT_SIZE - top >= MAX_INSTRUCTION_SIZE;
+}
+
+void* TranslationCache::Allocate(std::size_t size) {
+    ASSERT_MSG(size <= MAX_INSTRUCTION_SIZE, "Instruction of size {} is too large", size);
+    ASSERT_MSG(top + size <= (current_segment + 1) * SEGMENT_SIZE,
+               "Translation cache segment overflow");
+    void* ptr = &buffer[top];
+    top += size;
+    return ptr;
+}
+
+void TranslationCache::InvalidateRange(u32 start_address, std::size_t length) {
+    if (length == 0) {
+        return;
+    }
+
+    const u32 first_page = start_address >> Memory::PAGE_BITS;
+    const u32 last_page = static_cast<u32>((start_address + length - 1) >> Memory::PAGE_BITS);
+
+    // Large ranges are cheaper to handle by walking the pages that actually hold code.
+    if (last_page - first_page >= page_blocks.size()) {
+        std::vector<u32> pages;
+        for (const auto& [page, pcs] : page_blocks) {
+            if (page >= first_page && page <= last_page) {
+                pages.push_back(page);
+            }
+        }
+        for (u32 page : pages) {
+            InvalidatePage(page);
+        }
+        return;
+    }
+
+    for (u32 page = first_page; page <= last_page; ++page) {
+        InvalidatePage(page);
+    }
+}
+
+void TranslationCache::Clear() {
+    blocks.clear();
+    page_blocks.clear();
+    for (auto& pcs : segment_blocks) {
+        pcs.clear();
+    }
+    top = 0;
+    current_segment = 0;
+    BumpGeneration();
+}
+
+void TranslationCache::InvalidatePage(u32 page_index) {
+    const auto iter = page_blocks.find(page_index);
+    if (iter == page_blocks.end()) {
+        return;
+    }
+    for (u32 pc : iter->second) {
+        blocks.erase(pc);
+    }
+    page_blocks.erase(iter);
+    BumpGeneration();
+}
+
+void TranslationCache::RecycleSegment(std::size_t segment) {
+    for (u32 pc : segment_blocks[segment]) {
+        const auto iter = blocks.find(pc);
+        // The block may have been invalidated and translated again into another segment since.
+        if (iter == blocks.end() || iter->second / SEGMENT_SIZE != segment) {
+            continue;
+        }
+        blocks.erase(iter);
+
+        const auto page_iter = page_blocks.find(pc >> Memory::PAGE_BITS);
+        ASSERT(page_iter != page_blocks.end());
+        auto& pcs = page_iter->second;
+        pcs.erase(std::find(pcs.begin(), pcs.end(), pc));
+        if (pcs.empty()) {
+            page_blocks.erase(page_iter);
+        }
+    }
+    segment_blocks[segment].clear();
+    BumpGeneration();
+}
+
+void TranslationCache::BumpGeneration() {
+    // Generation 0 is reserved for links that have not been resolved yet
+    if (++generation == 0) {
+        generation = 1;
+    }
+}
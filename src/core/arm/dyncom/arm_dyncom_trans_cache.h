@@ -0,0 +1,83 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+#include "common/common_types.h"
+
+/**
+ * Storage for the decoded instructions of one address space.
+ *
+ * The buffer is split into segments which are filled one after the other. Once the last segment
+ * is full, the oldest segment is recycled and all blocks that were translated into it are dropped,
+ * so the cache stays within a fixed size while recently translated code stays resident. Since
+ * blocks never cross a guest page, invalidating a range only drops the blocks of the pages it
+ * touches.
+ */
+class TranslationCache {
+public:
+    static constexpr std::size_t NUM_SEGMENTS = 8;
+    static constexpr std::size_t SEGMENT_SIZE = 16 * 1024 * 1024;
+    static constexpr std::size_t CACHE_SIZE = NUM_SEGMENTS * SEGMENT_SIZE;
+
+    /// Upper bound of the space taken by a single decoded instruction.
+    static constexpr std::size_t MAX_INSTRUCTION_SIZE = 128;
+
+    TranslationCache();
+    ~TranslationCache();
+
+    /// Returns the buffer offset of the block starting at the given address, if it is cached.
+    std::optional<std::size_t> FindBlock(u32 pc) const;
+
+    /**
+     * Starts translating a new block at the given address, recycling the oldest segment if the
+     * current one cannot hold another instruction.
+     * @returns the buffer offset of the new block
+     */
+    std::size_t BeginBlock(u32 pc);
+
+    /// Returns whether the block being translated can be extended by another instruction.
+    bool HasSpaceForInstruction() const;
+
+    /// Reserves space for one decoded instruction in the block being translated.
+    void* Allocate(std::size_t size);
+
+    u8* GetBuffer() const {
+        return buffer.get();
+    }
+
+    /// Returns the current generation of the cache, which changes whenever blocks are dropped.
+    u32 GetGeneration() const {
+        return generation;
+    }
+
+    /// Drops all blocks translated from the pages touching the given range.
+    void InvalidateRange(u32 start_address, std::size_t length);
+
+    /// Drops all blocks.
+    void Clear();
+
+private:
+    void InvalidatePage(u32 page_index);
+    void RecycleSegment(std::size_t segment);
+    void BumpGeneration();
+
+    std::unique_ptr<u8[]> buffer;
+    std::size_t top = 0;
+    std::size_t current_segment = 0;
+    u32 generation = 1;
+
+    /// Maps the guest address of each block to its offset in the buffer.
+    std::unordered_map<u32, std::size_t> blocks;
+    /// Guest addresses of the blocks translated into each segment.
+    std::array<std::vector<u32>, NUM_SEGMENTS> segment_blocks;
+    /// Guest addresses of the blocks translated from each guest page.
+    std::unordered_map<u32, std::vector<u32>> page_blocks;
+};
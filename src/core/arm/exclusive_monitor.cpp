@@ -0,0 +1,19 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "core/arm/exclusive_monitor.h"
+
+ExclusiveMonitor::ExclusiveMonitor(std::size_t num_cores) : reservations(num_cores) {}
+
+ExclusiveMonitor::~ExclusiveMonitor() = default;
+
+void ExclusiveMonitor::Mark(std::size_t core, u32 address, u64 value) {
+    std::lock_guard lock{mutex};
+    reservations[core] = {address & RESERVATION_GRANULE_MASK, value};
+}
+
+void ExclusiveMonitor::Clear(std::size_t core) {
+    std::lock_guard lock{mutex};
+    reservations[core].tag = INVALID_TAG;
+}
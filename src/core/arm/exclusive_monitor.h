@@ -0,0 +1,72 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+#include "common/common_types.h"
+
+/**
+ * Global exclusive monitor, shared by cores that run on different host threads so that LDREX and
+ * STREX stay atomic across them. Each core holds at most one reservation. A successful exclusive
+ * store clears the reservations of the other cores on the same granule.
+ *
+ * Plain stores of other cores don't go through the monitor. Instead, an exclusive store also fails
+ * when the memory no longer holds the value the core loaded, which catches every plain store that
+ * changed it.
+ */
+class ExclusiveMonitor {
+public:
+    explicit ExclusiveMonitor(std::size_t num_cores);
+    ~ExclusiveMonitor();
+
+    /// Reserves the granule of address for core, which loaded value from it.
+    void Mark(std::size_t core, u32 address, u64 value);
+
+    /// Drops the reservation of core.
+    void Clear(std::size_t core);
+
+    /**
+     * Performs the store of an STREX if core still holds the reservation for address, and the
+     * memory still holds the value it loaded. The reservation is dropped either way.
+     * @param load Reads the current value at address, in the same way the LDREX did
+     * @param store Writes the new value
+     * @returns true if the store was performed
+     */
+    template <typename Load, typename Store>
+    bool ExclusiveWrite(std::size_t core, u32 address, Load&& load, Store&& store) {
+        const u32 tag = address & RESERVATION_GRANULE_MASK;
+        std::lock_guard lock{mutex};
+        Reservation& reservation = reservations[core];
+        if (reservation.tag != tag) {
+            return false;
+        }
+        reservation.tag = INVALID_TAG;
+        if (load() != reservation.value) {
+            return false;
+        }
+        store();
+        for (Reservation& other : reservations) {
+            if (other.tag == tag) {
+                other.tag = INVALID_TAG;
+            }
+        }
+        return true;
+    }
+
+private:
+    // Same granule as the local monitor of ARMul_State
+    static constexpr u32 RESERVATION_GRANULE_MASK = 0xFFFFFFF8;
+    static constexpr u32 INVALID_TAG = 0xFFFFFFFF;
+
+    struct Reservation {
+        u32 tag = INVALID_TAG;
+        u64 value = 0;
+    };
+
+    std::mutex mutex;
+    std::vector<Reservation> reservations;
+};
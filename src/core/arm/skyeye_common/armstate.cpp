@@ -5,6 +5,7 @@
 #include <algorithm>
 #include "common/logging/log.h"
 #include "common/swap.h"
+#include "core/arm/exclusive_monitor.h"
 #include "core/arm/skyeye_common/armstate.h"
 #include "core/arm/skyeye_common/vfp/vfp.h"
 #include "core/core.h"
@@ -262,6 +263,67 @@ void ARMul_State::WriteMemory64(u32 address, u64 data) {
     memory.Write64(address, data);
 }
 
+void ARMul_State::SetExclusiveMonitor(ExclusiveMonitor* monitor, std::size_t core_id) {
+    UnsetExclusiveMemoryAddress();
+    exclusive_monitor = monitor;
+    exclusive_monitor_core = core_id;
+}
+
+void ARMul_State::SetExclusiveMemoryAddress(u32 address, u64 value) {
+    if (exclusive_monitor != nullptr) {
+        exclusive_monitor->Mark(exclusive_monitor_core, address, value);
+        return;
+    }
+    exclusive_tag = address & RESERVATION_GRANULE_MASK;
+    exclusive_state = true;
+}
+
+void ARMul_State::UnsetExclusiveMemoryAddress() {
+    if (exclusive_monitor != nullptr) {
+        exclusive_monitor->Clear(exclusive_monitor_core);
+    }
+    exclusive_tag = 0xFFFFFFFF;
+    exclusive_state = false;
+}
+
+template <typename Load, typename Store>
+bool ARMul_State::WriteExclusive(u32 address, Load&& load, Store&& store) {
+    if (exclusive_monitor != nullptr) {
+        return exclusive_monitor->ExclusiveWrite(exclusive_monitor_core, address, load, store);
+    }
+    if (!IsExclusiveMemoryAccess(address)) {
+        return false;
+    }
+    UnsetExclusiveMemoryAddress();
+    store();
+    return true;
+}
+
+bool ARMul_State::WriteExclusiveMemory8(u32 address, u8 data) {
+    return WriteExclusive(
+        address, [&] { return ReadMemory8(address); }, [&] { WriteMemory8(address, data); });
+}
+
+bool ARMul_State::WriteExclusiveMemory16(u32 address, u16 data) {
+    return WriteExclusive(
+        address, [&] { return ReadMemory16(address); }, [&] { WriteMemory16(address, data); });
+}
+
+bool ARMul_State::WriteExclusiveMemory32(u32 address, u32 data) {
+    return WriteExclusive(
+        address, [&] { return ReadMemory32(address); }, [&] { WriteMemory32(address, data); });
+}
+
+bool ARMul_State::WriteExclusiveMemory64(u32 address, u64 data) {
+    // Compared the same way LDREXD loads it, as two words
+    return WriteExclusive(
+        address,
+        [&] {
+            return ReadMemory32(address) | static_cast<u64>(ReadMemory32(address + 4)) << 32;
+        },
+        [&] { WriteMemory64(address, data); });
+}
+
 // Reads from the CP15 registers. Used with implementation of the MRC instruction.
 // Note that since the 3DS does not have the hypervisor extensions, these registers
 // are not implemented.
@@ -616,3 +678,15 @@ void ARMul_State::ServeBreak() {
         GDBStub::SendTrap(thread, 5);
     }
 }
+
+void ARMul_State::LoadPendingVFP() {
+    vfp_active = true;
+    if (vfp_context == nullptr || HoldsVFPContext(*vfp_context)) {
+        return;
+    }
+    ExtReg = vfp_context->ext_reg;
+    VFP[VFP_FPSCR] = vfp_context->fpscr;
+    VFP[VFP_FPEXC] = vfp_context->fpexc;
+    vfp_context->loaded_on = this;
+    vfp_context->load_id = ++vfp_loads;
+}
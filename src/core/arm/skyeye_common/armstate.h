@@ -18,7 +18,7 @@
 #pragma once
 
 #include <array>
-#include <unordered_map>
+#include <cstddef>
 #include "common/common_types.h"
 #include "core/arm/skyeye_common/arm_regformat.h"
 #include "core/gdbstub/gdbstub.h"
@@ -27,6 +27,9 @@ namespace Core {
 class System;
 }
 
+class ExclusiveMonitor;
+class TranslationCache;
+
 namespace Memory {
 class MemorySystem;
 }
@@ -145,10 +148,32 @@ enum {
     RUN = 3         // Continuous execution
 };
 
+struct ARMul_State;
+
+// VFP registers of a thread while it is switched out.
+struct VFPContext {
+    std::array<u32, 64> ext_reg{};
+    u32 fpscr = 0;
+    u32 fpexc = 0;
+
+    // CPU that the registers were last loaded on or saved from, and the number of loads that CPU
+    // had done by then. The registers of that CPU still hold this state as long as it hasn't
+    // loaded another context since. Cleared when the context is modified.
+    const ARMul_State* loaded_on = nullptr;
+    u64 load_id = 0;
+
+    // CPU running the thread of this context, which refers to it until the CPU switches away.
+    // The context clears the reference when it is destroyed before that.
+    ARMul_State* running_on = nullptr;
+};
+
 struct ARMul_State final {
 public:
     explicit ARMul_State(Core::System* system, Memory::MemorySystem& memory,
                          PrivilegeMode initial_mode);
+    ~ARMul_State() {
+        UnloadVFPContext();
+    }
 
     void ChangePrivilegeMode(u32 new_mode);
     void Reset();
@@ -167,18 +192,16 @@ public:
     u32 ReadCP15Register(u32 crn, u32 opcode_1, u32 crm, u32 opcode_2) const;
     void WriteCP15Register(u32 value, u32 crn, u32 opcode_1, u32 crm, u32 opcode_2);
 
-    // Exclusive memory access functions
-    bool IsExclusiveMemoryAccess(u32 address) const {
-        return exclusive_state && exclusive_tag == (address & RESERVATION_GRANULE_MASK);
-    }
-    void SetExclusiveMemoryAddress(u32 address) {
-        exclusive_tag = address & RESERVATION_GRANULE_MASK;
-        exclusive_state = true;
-    }
-    void UnsetExclusiveMemoryAddress() {
-        exclusive_tag = 0xFFFFFFFF;
-        exclusive_state = false;
-    }
+    // Exclusive memory access functions. The reservation is kept in the local monitor, unless the
+    // core shares a global monitor with cores running on other host threads.
+    void SetExclusiveMonitor(ExclusiveMonitor* monitor, std::size_t core_id);
+    void SetExclusiveMemoryAddress(u32 address, u64 value);
+    void UnsetExclusiveMemoryAddress();
+    // Store data if the reservation for address is still held, returning whether it was stored
+    bool WriteExclusiveMemory8(u32 address, u8 data);
+    bool WriteExclusiveMemory16(u32 address, u16 data);
+    bool WriteExclusiveMemory32(u32 address, u32 data);
+    bool WriteExclusiveMemory64(u32 address, u64 data);
 
     // Whether or not the given CPU is in big endian mode (E bit is set)
     bool InBigEndianMode() const {
@@ -206,6 +229,50 @@ public:
 
     void ServeBreak();
 
+    // Lazy switching of the VFP registers. LoadVFPContext only records the context of the thread,
+    // and its registers are loaded by its first VFP access, unless this core still holds them.
+    // SaveVFPContext only stores them if the thread accessed them. Only the core itself touches
+    // its registers, so a thread can move between cores. UnloadVFPContext drops the context when
+    // the core goes idle or the context is destroyed, so the core never refers to a dead context.
+    void LoadVFPContext(VFPContext& context) {
+        if (vfp_context == &context) {
+            // Loading the running thread again keeps its registers, unless its context was modified
+            vfp_active = vfp_active && HoldsVFPContext(context);
+            return;
+        }
+        UnloadVFPContext();
+        if (context.running_on != nullptr) {
+            // The kernel switches a core away from a thread before another core runs it, so this
+            // only happens when the debugger loads a thread, while all cores are stopped.
+            context.running_on->UnloadVFPContext();
+        }
+        vfp_context = &context;
+        context.running_on = this;
+    }
+    void SaveVFPContext(VFPContext& context) {
+        if (vfp_active && vfp_context == &context) {
+            context.ext_reg = ExtReg;
+            context.fpscr = VFP[VFP_FPSCR];
+            context.fpexc = VFP[VFP_FPEXC];
+            context.loaded_on = this;
+            context.load_id = vfp_loads;
+        }
+    }
+    void UnloadVFPContext() {
+        if (vfp_context != nullptr) {
+            vfp_context->running_on = nullptr;
+            vfp_context = nullptr;
+        }
+        vfp_active = false;
+    }
+    // Makes sure that the registers hold the state of the running thread. Called before every
+    // access to the VFP registers, see CHECK_VFP_ENABLED.
+    void ActivateVFP() {
+        if (!vfp_active) {
+            LoadPendingVFP();
+        }
+    }
+
     Core::System* system;
     Memory::MemorySystem& memory;
 
@@ -227,6 +294,9 @@ public:
     // and only 32 singleword registers are accessible (S0-S31).
     std::array<u32, 64> ExtReg{};
 
+    // Set once the running thread has accessed the VFP registers
+    bool vfp_active = false;
+
     u32 Emulate; // To start and stop emulation
     u32 Cpsr;    // The current PSR
     u32 Spsr_copy;
@@ -252,12 +322,18 @@ public:
     unsigned bigendSig;
     unsigned syscallSig;
 
-    // TODO(bunnei): Move this cache to a better place - it should be per codeset (likely per
-    // process for our purposes), not per ARMul_State (which tracks CPU core state).
-    std::unordered_map<u32, std::size_t> instruction_cache;
+    // Translation cache of the address space currently being executed, owned by the CPU core
+    TranslationCache* trans_cache = nullptr;
 
 private:
     void ResetMPCoreCP15Registers();
+    void LoadPendingVFP();
+
+    bool IsExclusiveMemoryAccess(u32 address) const {
+        return exclusive_state && exclusive_tag == (address & RESERVATION_GRANULE_MASK);
+    }
+    template <typename Load, typename Store>
+    bool WriteExclusive(u32 address, Load&& load, Store&& store);
 
     // Defines a reservation granule of 2 words, which protects the first 2 words starting at the
     // tag. This is the smallest granule allowed by the v7 spec, and is coincidentally just large
@@ -267,6 +343,18 @@ private:
     u32 exclusive_tag; // The address for which the local monitor is in exclusive access mode
     bool exclusive_state;
 
+    ExclusiveMonitor* exclusive_monitor = nullptr;
+    std::size_t exclusive_monitor_core = 0;
+
+    // Whether the VFP registers still hold the state of the context
+    bool HoldsVFPContext(const VFPContext& context) const {
+        return context.loaded_on == this && context.load_id == vfp_loads;
+    }
+
+    // Context of the running thread, and the number of contexts loaded into the VFP registers
+    VFPContext* vfp_context = nullptr;
+    u64 vfp_loads = 0;
+
     GDBStub::BreakpointAddress last_bkpt{};
     bool last_bkpt_hit = false;
 };
@@ -23,7 +23,7 @@
 #include "core/arm/skyeye_common/vfp/vfp_helper.h" /* for references to cdp SoftFloat functions */
 
 #define VFP_DEBUG_UNTESTED(x) LOG_TRACE(Core_ARM11, "in func {}, " #x " untested", __FUNCTION__);
-#define CHECK_VFP_ENABLED
+#define CHECK_VFP_ENABLED cpu->ActivateVFP()
 #define CHECK_VFP_CDP_RET vfp_raise_exceptions(cpu, ret, inst_cream->instr, cpu->VFP[VFP_FPSCR]);
 
 void VFPInit(ARMul_State* state);
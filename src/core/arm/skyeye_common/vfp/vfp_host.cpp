@@ -0,0 +1,200 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include "common/common_types.h"
+#include "core/arm/skyeye_common/vfp/asm_vfp.h"
+#include "core/arm/skyeye_common/vfp/vfp_host.h"
+
+// Excess precision, as with x87 code, would round twice and break the bit exactness
+#if defined(ARCHITECTURE_x86_64) || defined(ARCHITECTURE_ARM64)
+#define VFP_HOST_FPU_EXACT
+#endif
+
+namespace {
+
+constexpr u32 SINGLE_EXPONENT_MASK = 0x7F800000;
+constexpr u64 DOUBLE_EXPONENT_MASK = 0x7FF0000000000000;
+
+/// Products of operands smaller than this can have an error term that is not representable
+constexpr double DOUBLE_MIN_FACTOR = 0x1p-450;
+/// Operands larger than this could overflow when they are split into halves
+constexpr double DOUBLE_MAX_FACTOR = 0x1p450;
+
+/// Returns whether the bits are a normal number or a zero, i.e. not denormal, infinite or NaN
+bool IsNormalOrZero(u32 bits) {
+    const u32 exponent = bits & SINGLE_EXPONENT_MASK;
+    return exponent != SINGLE_EXPONENT_MASK && (exponent != 0 || (bits << 1) == 0);
+}
+
+bool IsNormalOrZero(u64 bits) {
+    const u64 exponent = bits & DOUBLE_EXPONENT_MASK;
+    return exponent != DOUBLE_EXPONENT_MASK && (exponent != 0 || (bits << 1) == 0);
+}
+
+template <typename To, typename From>
+To BitCast(From from) {
+    static_assert(sizeof(To) == sizeof(From));
+    To to;
+    std::memcpy(&to, &from, sizeof(To));
+    return to;
+}
+
+/// Returns the rounding error of s = a + b, which is zero iff the sum is exact (Knuth's TwoSum)
+double TwoSumError(double a, double b, double s) {
+    const double b_virtual = s - a;
+    const double a_virtual = s - b_virtual;
+    return (a - a_virtual) + (b - b_virtual);
+}
+
+/// Returns the rounding error of p = a * b. Requires the magnitude of a and b to be within
+/// [DOUBLE_MIN_FACTOR, DOUBLE_MAX_FACTOR].
+double TwoProductError(double a, double b, double p) {
+#ifdef FP_FAST_FMA
+    return std::fma(a, b, -p);
+#else
+    // Dekker's algorithm, splitting both factors into 26 bit halves
+    const auto split = [](double x, double& high, double& low) {
+        const double c = 134217729.0 * x; // 2^27 + 1
+        high = c - (c - x);
+        low = x - high;
+    };
+    double a_high, a_low, b_high, b_low;
+    split(a, a_high, a_low);
+    split(b, b_high, b_low);
+    return ((a_high * b_high - p) + a_high * b_low + a_low * b_high) + a_low * b_low;
+#endif
+}
+
+bool IsInFactorRange(double x) {
+    const double magnitude = std::abs(x);
+    return magnitude >= DOUBLE_MIN_FACTOR && magnitude <= DOUBLE_MAX_FACTOR;
+}
+
+} // Anonymous namespace
+
+bool VFPHostSingleOp(VFPHostOp op, u32 n, u32 m, u32 fpscr, u32& result, u32& exceptions) {
+#ifdef VFP_HOST_FPU_EXACT
+    if ((fpscr & FPSCR_RMODE_MASK) != FPSCR_ROUND_NEAREST || !IsNormalOrZero(n) ||
+        !IsNormalOrZero(m)) {
+        return false;
+    }
+
+    // Each operation is computed in double precision and rounded to single precision. Double
+    // precision has more than twice the bits of single precision, so rounding twice gives the
+    // correctly rounded result, and the wide result can be used to tell whether it is exact.
+    const double a = BitCast<float>(n);
+    const double b = BitCast<float>(m);
+    double wide;
+    bool wide_inexact = false;
+    switch (op) {
+    case VFPHostOp::Add:
+        wide = a + b;
+        wide_inexact = TwoSumError(a, b, wide) != 0.0;
+        break;
+    case VFPHostOp::Sub:
+        wide = a - b;
+        wide_inexact = TwoSumError(a, -b, wide) != 0.0;
+        break;
+    case VFPHostOp::Mul:
+    case VFPHostOp::NMul:
+        // Exact, since the significands have 24 bits each
+        wide = a * b;
+        break;
+    case VFPHostOp::Div:
+        if (b == 0.0) {
+            return false;
+        }
+        wide = a / b;
+        break;
+    default:
+        return false;
+    }
+
+    const float rounded = static_cast<float>(wide);
+    const u32 bits = BitCast<u32>(rounded);
+    // Underflows, which are detected before rounding, and overflows are left to the soft-float
+    // implementation
+    if (!IsNormalOrZero(bits) || (wide != 0.0 && std::abs(wide) < FLT_MIN)) {
+        return false;
+    }
+
+    bool inexact;
+    if (op == VFPHostOp::Div) {
+        // The product of two floats is exact in double precision
+        inexact = static_cast<double>(rounded) * b != a;
+    } else {
+        inexact = wide_inexact || static_cast<double>(rounded) != wide;
+    }
+
+    result = op == VFPHostOp::NMul ? bits ^ 0x80000000 : bits;
+    exceptions = inexact ? FPSCR_IXC : 0;
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool VFPHostDoubleOp(VFPHostOp op, u64 n, u64 m, u32 fpscr, u64& result, u32& exceptions) {
+#ifdef VFP_HOST_FPU_EXACT
+    if ((fpscr & FPSCR_RMODE_MASK) != FPSCR_ROUND_NEAREST || !IsNormalOrZero(n) ||
+        !IsNormalOrZero(m)) {
+        return false;
+    }
+
+    const double a = BitCast<double>(n);
+    const double b = BitCast<double>(m);
+    double value;
+    bool inexact = false;
+    switch (op) {
+    case VFPHostOp::Add:
+        value = a + b;
+        inexact = TwoSumError(a, b, value) != 0.0;
+        break;
+    case VFPHostOp::Sub:
+        value = a - b;
+        inexact = TwoSumError(a, -b, value) != 0.0;
+        break;
+    case VFPHostOp::Mul:
+    case VFPHostOp::NMul:
+        value = a * b;
+        if (a != 0.0 && b != 0.0) {
+            if (!IsInFactorRange(a) || !IsInFactorRange(b)) {
+                return false;
+            }
+            inexact = TwoProductError(a, b, value) != 0.0;
+        }
+        break;
+    case VFPHostOp::Div:
+        if (b == 0.0) {
+            return false;
+        }
+        value = a / b;
+        if (a != 0.0) {
+            if (!IsInFactorRange(value) || !IsInFactorRange(b)) {
+                return false;
+            }
+            // The quotient is exact iff multiplying it back gives the dividend without error
+            inexact = value * b != a || TwoProductError(value, b, value * b) != 0.0;
+        }
+        break;
+    default:
+        return false;
+    }
+
+    const u64 bits = BitCast<u64>(value);
+    // Operands within the factor range can't underflow or overflow, but sums can
+    if (!IsNormalOrZero(bits)) {
+        return false;
+    }
+
+    result = op == VFPHostOp::NMul ? bits ^ 0x8000000000000000 : bits;
+    exceptions = inexact ? FPSCR_IXC : 0;
+    return true;
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,33 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include "common/common_types.h"
+
+/// VFP data-processing operations that can be run on the host FPU
+enum class VFPHostOp {
+    Add,
+    Sub,
+    Mul,
+    NMul,
+    Div,
+};
+
+/**
+ * Runs a single precision operation on the host FPU. This is only done if the result and the
+ * cumulative exception flags are guaranteed to be identical to the soft-float implementation: the
+ * rounding mode has to be round to nearest, both operands have to be normal numbers or zeros, and
+ * so does the result. Otherwise, nothing is computed and false is returned.
+ * @param n Bits of the first operand
+ * @param m Bits of the second operand
+ * @param fpscr Current value of the FPSCR
+ * @param result Receives the bits of the result
+ * @param exceptions Receives the FPSCR exception flags raised by the operation
+ * @return Whether the operation was run
+ */
+bool VFPHostSingleOp(VFPHostOp op, u32 n, u32 m, u32 fpscr, u32& result, u32& exceptions);
+
+/// Double precision version of VFPHostSingleOp.
+bool VFPHostDoubleOp(VFPHostOp op, u64 n, u64 m, u32 fpscr, u64& result, u32& exceptions);
@@ -52,10 +52,13 @@
  */
 
 #include <algorithm>
+#include <optional>
 #include "common/logging/log.h"
 #include "core/arm/skyeye_common/vfp/asm_vfp.h"
 #include "core/arm/skyeye_common/vfp/vfp.h"
 #include "core/arm/skyeye_common/vfp/vfp_helper.h"
+#include "core/arm/skyeye_common/vfp/vfp_host.h"
+#include "core/settings.h"
 
 static struct vfp_double vfp_double_default_qnan = {
     2047,
@@ -1165,6 +1168,12 @@ static struct op fops[] = {
     {vfp_double_fnmul, 0}, {vfp_double_fsub, 0},  {vfp_double_fdiv, 0},
 };
 
+/// Operations in fops that can be run on the host FPU, or nullopt
+static const std::optional<VFPHostOp> host_fops[] = {
+    std::nullopt,   std::nullopt,    VFPHostOp::Mul, VFPHostOp::Add, std::nullopt,
+    std::nullopt,   VFPHostOp::NMul, VFPHostOp::Sub, VFPHostOp::Div,
+};
+
 #define FREG_BANK(x) ((x)&0x0c)
 #define FREG_IDX(x) ((x)&3)
 
@@ -1176,11 +1185,14 @@ u32 vfp_double_cpdo(ARMul_State* state, u32 inst, u32 fpscr) {
     unsigned int dm;
     unsigned int vecitr, veclen, vecstride;
     struct op* fop;
+    std::optional<VFPHostOp> host_op;
 
     LOG_TRACE(Core_ARM11, "In {}", __FUNCTION__);
     vecstride = (1 + ((fpscr & FPSCR_STRIDE_MASK) == FPSCR_STRIDE_MASK));
 
     fop = (op == FOP_EXT) ? &fops_ext[FEXT_TO_IDX(inst)] : &fops[FOP_TO_IDX(op)];
+    if (op != FOP_EXT && Settings::values.use_vfp_host_fpu)
+        host_op = host_fops[FOP_TO_IDX(op)];
 
     /*
      * fcvtds takes an sN register number as destination, not dN.
@@ -1228,7 +1240,13 @@ u32 vfp_double_cpdo(ARMul_State* state, u32 inst, u32 fpscr) {
             LOG_TRACE(Core_ARM11, "VFP: itr{} ({}{}) = (d{}) op[{}] (d{})",
                       vecitr >> FPSCR_LENGTH_BIT, type, dest, dn, FOP_TO_IDX(op), dm);
 
-        except = fop->fn(state, dest, dn, dm, fpscr);
+        u64 result;
+        if (host_op && VFPHostDoubleOp(*host_op, vfp_get_double(state, dn),
+                                       vfp_get_double(state, dm), fpscr, result, except)) {
+            vfp_put_double(state, result, dest);
+        } else {
+            except = fop->fn(state, dest, dn, dm, fpscr);
+        }
         LOG_TRACE(Core_ARM11, "VFP: itr{}: exceptions={:08x}", vecitr >> FPSCR_LENGTH_BIT, except);
 
         exceptions |= except & ~VFP_NAN_FLAG;
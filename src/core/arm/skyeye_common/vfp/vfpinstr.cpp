@@ -19,8 +19,9 @@ struct vmla_inst {
 };
 #endif
 #ifdef VFP_INTERPRETER_TRANS
-static ARM_INST_PTR INTERPRETER_TRANSLATE(vmla)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(vmla_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(vmla)(TranslationCache& cache, unsigned int inst,
+                                                int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(vmla_inst));
     vmla_inst* inst_cream = (vmla_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -66,8 +67,9 @@ struct vmls_inst {
 };
 #endif
 #ifdef VFP_INTERPRETER_TRANS
-static ARM_INST_PTR INTERPRETER_TRANSLATE(vmls)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(vmls_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(vmls)(TranslationCache& cache, unsigned int inst,
+                                                int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(vmls_inst));
     vmls_inst* inst_cream = (vmls_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -113,8 +115,9 @@ struct vnmla_inst {
 };
 #endif
 #ifdef VFP_INTERPRETER_TRANS
-static ARM_INST_PTR INTERPRETER_TRANSLATE(vnmla)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(vnmla_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(vnmla)(TranslationCache& cache, unsigned int inst,
+                                                 int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(vnmla_inst));
     vnmla_inst* inst_cream = (vnmla_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -161,8 +164,9 @@ struct vnmls_inst {
 };
 #endif
 #ifdef VFP_INTERPRETER_TRANS
-static ARM_INST_PTR INTERPRETER_TRANSLATE(vnmls)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(vnmls_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(vnmls)(TranslationCache& cache, unsigned int inst,
+                                                 int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(vnmls_inst));
     vnmls_inst* inst_cream = (vnmls_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -208,8 +212,9 @@ struct vnmul_inst {
 };
 #endif
 #ifdef VFP_INTERPRETER_TRANS
-static ARM_INST_PTR INTERPRETER_TRANSLATE(vnmul)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(vnmul_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(vnmul)(TranslationCache& cache, unsigned int inst,
+                                                 int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(vnmul_inst));
     vnmul_inst* inst_cream = (vnmul_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -255,8 +260,9 @@ struct vmul_inst {
 };
 #endif
 #ifdef VFP_INTERPRETER_TRANS
-static ARM_INST_PTR INTERPRETER_TRANSLATE(vmul)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(vmul_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(vmul)(TranslationCache& cache, unsigned int inst,
+                                                int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(vmul_inst));
     vmul_inst* inst_cream = (vmul_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -302,8 +308,9 @@ struct vadd_inst {
 };
 #endif
 #ifdef VFP_INTERPRETER_TRANS
-static ARM_INST_PTR INTERPRETER_TRANSLATE(vadd)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(vadd_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(vadd)(TranslationCache& cache, unsigned int inst,
+                                                int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(vadd_inst));
     vadd_inst* inst_cream = (vadd_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -349,8 +356,9 @@ struct vsub_inst {
 };
 #endif
 #ifdef VFP_INTERPRETER_TRANS
-static ARM_INST_PTR INTERPRETER_TRANSLATE(vsub)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(vsub_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(vsub)(TranslationCache& cache, unsigned int inst,
+                                                int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(vsub_inst));
     vsub_inst* inst_cream = (vsub_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -396,8 +404,9 @@ struct vdiv_inst {
 };
 #endif
 #ifdef VFP_INTERPRETER_TRANS
-static ARM_INST_PTR INTERPRETER_TRANSLATE(vdiv)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(vdiv_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(vdiv)(TranslationCache& cache, unsigned int inst,
+                                                int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(vdiv_inst));
     vdiv_inst* inst_cream = (vdiv_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -445,8 +454,9 @@ struct vmovi_inst {
 };
 #endif
 #ifdef VFP_INTERPRETER_TRANS
-static ARM_INST_PTR INTERPRETER_TRANSLATE(vmovi)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(vmovi_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(vmovi)(TranslationCache& cache, unsigned int inst,
+                                                 int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(vmovi_inst));
     vmovi_inst* inst_cream = (vmovi_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -494,8 +504,9 @@ struct vmovr_inst {
 };
 #endif
 #ifdef VFP_INTERPRETER_TRANS
-static ARM_INST_PTR INTERPRETER_TRANSLATE(vmovr)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(vmovr_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(vmovr)(TranslationCache& cache, unsigned int inst,
+                                                 int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(vmovr_inst));
     vmovr_inst* inst_cream = (vmovr_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -536,8 +547,9 @@ typedef struct _vabs_inst {
 } vabs_inst;
 #endif
 #ifdef VFP_INTERPRETER_TRANS
-static ARM_INST_PTR INTERPRETER_TRANSLATE(vabs)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(vabs_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(vabs)(TranslationCache& cache, unsigned int inst,
+                                                int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(vabs_inst));
     vabs_inst* inst_cream = (vabs_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -584,8 +596,9 @@ struct vneg_inst {
 };
 #endif
 #ifdef VFP_INTERPRETER_TRANS
-static ARM_INST_PTR INTERPRETER_TRANSLATE(vneg)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(vneg_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(vneg)(TranslationCache& cache, unsigned int inst,
+                                                int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(vneg_inst));
     vneg_inst* inst_cream = (vneg_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -631,8 +644,9 @@ struct vsqrt_inst {
 };
 #endif
 #ifdef VFP_INTERPRETER_TRANS
-static ARM_INST_PTR INTERPRETER_TRANSLATE(vsqrt)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(vsqrt_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(vsqrt)(TranslationCache& cache, unsigned int inst,
+                                                 int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(vsqrt_inst));
     vsqrt_inst* inst_cream = (vsqrt_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -678,8 +692,9 @@ struct vcmp_inst {
 };
 #endif
 #ifdef VFP_INTERPRETER_TRANS
-static ARM_INST_PTR INTERPRETER_TRANSLATE(vcmp)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(vcmp_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(vcmp)(TranslationCache& cache, unsigned int inst,
+                                                int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(vcmp_inst));
     vcmp_inst* inst_cream = (vcmp_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -725,8 +740,9 @@ struct vcmp2_inst {
 };
 #endif
 #ifdef VFP_INTERPRETER_TRANS
-static ARM_INST_PTR INTERPRETER_TRANSLATE(vcmp2)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(vcmp2_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(vcmp2)(TranslationCache& cache, unsigned int inst,
+                                                 int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(vcmp2_inst));
     vcmp2_inst* inst_cream = (vcmp2_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -772,8 +788,9 @@ struct vcvtbds_inst {
 };
 #endif
 #ifdef VFP_INTERPRETER_TRANS
-static ARM_INST_PTR INTERPRETER_TRANSLATE(vcvtbds)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(vcvtbds_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(vcvtbds)(TranslationCache& cache, unsigned int inst,
+                                                   int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(vcvtbds_inst));
     vcvtbds_inst* inst_cream = (vcvtbds_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -819,10 +836,11 @@ struct vcvtbff_inst {
 };
 #endif
 #ifdef VFP_INTERPRETER_TRANS
-static ARM_INST_PTR INTERPRETER_TRANSLATE(vcvtbff)(unsigned int inst, int index) {
+static ARM_INST_PTR INTERPRETER_TRANSLATE(vcvtbff)(TranslationCache& cache, unsigned int inst,
+                                                   int index) {
     VFP_DEBUG_UNTESTED(VCVTBFF);
 
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(vcvtbff_inst));
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(vcvtbff_inst));
     vcvtbff_inst* inst_cream = (vcvtbff_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -868,8 +886,9 @@ struct vcvtbfi_inst {
 };
 #endif
 #ifdef VFP_INTERPRETER_TRANS
-static ARM_INST_PTR INTERPRETER_TRANSLATE(vcvtbfi)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(vcvtbfi_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(vcvtbfi)(TranslationCache& cache, unsigned int inst,
+                                                   int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(vcvtbfi_inst));
     vcvtbfi_inst* inst_cream = (vcvtbfi_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -922,8 +941,9 @@ struct vmovbrs_inst {
 };
 #endif
 #ifdef VFP_INTERPRETER_TRANS
-static ARM_INST_PTR INTERPRETER_TRANSLATE(vmovbrs)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(vmovbrs_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(vmovbrs)(TranslationCache& cache, unsigned int inst,
+                                                   int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(vmovbrs_inst));
     vmovbrs_inst* inst_cream = (vmovbrs_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -964,8 +984,9 @@ struct vmsr_inst {
 };
 #endif
 #ifdef VFP_INTERPRETER_TRANS
-static ARM_INST_PTR INTERPRETER_TRANSLATE(vmsr)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(vmsr_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(vmsr)(TranslationCache& cache, unsigned int inst,
+                                                int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(vmsr_inst));
     vmsr_inst* inst_cream = (vmsr_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1022,8 +1043,9 @@ struct vmovbrc_inst {
 };
 #endif
 #ifdef VFP_INTERPRETER_TRANS
-static ARM_INST_PTR INTERPRETER_TRANSLATE(vmovbrc)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(vmovbrc_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(vmovbrc)(TranslationCache& cache, unsigned int inst,
+                                                   int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(vmovbrc_inst));
     vmovbrc_inst* inst_cream = (vmovbrc_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1066,8 +1088,9 @@ struct vmrs_inst {
 };
 #endif
 #ifdef VFP_INTERPRETER_TRANS
-static ARM_INST_PTR INTERPRETER_TRANSLATE(vmrs)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(vmrs_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(vmrs)(TranslationCache& cache, unsigned int inst,
+                                                int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(vmrs_inst));
     vmrs_inst* inst_cream = (vmrs_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1138,8 +1161,9 @@ struct vmovbcr_inst {
 };
 #endif
 #ifdef VFP_INTERPRETER_TRANS
-static ARM_INST_PTR INTERPRETER_TRANSLATE(vmovbcr)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(vmovbcr_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(vmovbcr)(TranslationCache& cache, unsigned int inst,
+                                                   int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(vmovbcr_inst));
     vmovbcr_inst* inst_cream = (vmovbcr_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1189,8 +1213,9 @@ struct vmovbrrss_inst {
 };
 #endif
 #ifdef VFP_INTERPRETER_TRANS
-static ARM_INST_PTR INTERPRETER_TRANSLATE(vmovbrrss)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(vmovbrrss_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(vmovbrrss)(TranslationCache& cache, unsigned int inst,
+                                                     int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(vmovbrrss_inst));
     vmovbrrss_inst* inst_cream = (vmovbrrss_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1235,8 +1260,9 @@ struct vmovbrrd_inst {
 };
 #endif
 #ifdef VFP_INTERPRETER_TRANS
-static ARM_INST_PTR INTERPRETER_TRANSLATE(vmovbrrd)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(vmovbrrd_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(vmovbrrd)(TranslationCache& cache, unsigned int inst,
+                                                    int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(vmovbrrd_inst));
     vmovbrrd_inst* inst_cream = (vmovbrrd_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1286,8 +1312,9 @@ struct vstr_inst {
 };
 #endif
 #ifdef VFP_INTERPRETER_TRANS
-static ARM_INST_PTR INTERPRETER_TRANSLATE(vstr)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(vstr_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(vstr)(TranslationCache& cache, unsigned int inst,
+                                                int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(vstr_inst));
     vstr_inst* inst_cream = (vstr_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1349,8 +1376,9 @@ struct vpush_inst {
 };
 #endif
 #ifdef VFP_INTERPRETER_TRANS
-static ARM_INST_PTR INTERPRETER_TRANSLATE(vpush)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(vpush_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(vpush)(TranslationCache& cache, unsigned int inst,
+                                                 int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(vpush_inst));
     vpush_inst* inst_cream = (vpush_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1419,8 +1447,9 @@ struct vstm_inst {
 };
 #endif
 #ifdef VFP_INTERPRETER_TRANS
-static ARM_INST_PTR INTERPRETER_TRANSLATE(vstm)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(vstm_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(vstm)(TranslationCache& cache, unsigned int inst,
+                                                int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(vstm_inst));
     vstm_inst* inst_cream = (vstm_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1501,8 +1530,9 @@ struct vpop_inst {
 };
 #endif
 #ifdef VFP_INTERPRETER_TRANS
-static ARM_INST_PTR INTERPRETER_TRANSLATE(vpop)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(vpop_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(vpop)(TranslationCache& cache, unsigned int inst,
+                                                int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(vpop_inst));
     vpop_inst* inst_cream = (vpop_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1568,8 +1598,9 @@ struct vldr_inst {
 };
 #endif
 #ifdef VFP_INTERPRETER_TRANS
-static ARM_INST_PTR INTERPRETER_TRANSLATE(vldr)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(vldr_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(vldr)(TranslationCache& cache, unsigned int inst,
+                                                int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(vldr_inst));
     vldr_inst* inst_cream = (vldr_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -1634,8 +1665,9 @@ struct vldm_inst {
 };
 #endif
 #ifdef VFP_INTERPRETER_TRANS
-static ARM_INST_PTR INTERPRETER_TRANSLATE(vldm)(unsigned int inst, int index) {
-    arm_inst* inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(vldm_inst));
+static ARM_INST_PTR INTERPRETER_TRANSLATE(vldm)(TranslationCache& cache, unsigned int inst,
+                                                int index) {
+    arm_inst* inst_base = (arm_inst*)cache.Allocate(sizeof(arm_inst) + sizeof(vldm_inst));
     vldm_inst* inst_cream = (vldm_inst*)inst_base->component;
 
     inst_base->cond = BITS(inst, 28, 31);
@@ -52,12 +52,15 @@
  */
 
 #include <algorithm>
+#include <optional>
 #include "common/common_funcs.h"
 #include "common/common_types.h"
 #include "common/logging/log.h"
 #include "core/arm/skyeye_common/vfp/asm_vfp.h"
 #include "core/arm/skyeye_common/vfp/vfp.h"
 #include "core/arm/skyeye_common/vfp/vfp_helper.h"
+#include "core/arm/skyeye_common/vfp/vfp_host.h"
+#include "core/settings.h"
 
 static struct vfp_single vfp_single_default_qnan = {
     255,
@@ -1194,6 +1197,12 @@ static struct op fops[] = {
     {vfp_single_fnmul, 0}, {vfp_single_fsub, 0},  {vfp_single_fdiv, 0},
 };
 
+/// Operations in fops that can be run on the host FPU, or nullopt
+static const std::optional<VFPHostOp> host_fops[] = {
+    std::nullopt,   std::nullopt,    VFPHostOp::Mul, VFPHostOp::Add, std::nullopt,
+    std::nullopt,   VFPHostOp::NMul, VFPHostOp::Sub, VFPHostOp::Div,
+};
+
 #define FREG_BANK(x) ((x)&0x18)
 #define FREG_IDX(x) ((x)&7)
 
@@ -1205,10 +1214,13 @@ u32 vfp_single_cpdo(ARMul_State* state, u32 inst, u32 fpscr) {
     unsigned int sm = vfp_get_sm(inst);
     unsigned int vecitr, veclen, vecstride;
     struct op* fop;
+    std::optional<VFPHostOp> host_op;
 
     vecstride = 1 + ((fpscr & FPSCR_STRIDE_MASK) == FPSCR_STRIDE_MASK);
 
     fop = (op == FOP_EXT) ? &fops_ext[FEXT_TO_IDX(inst)] : &fops[FOP_TO_IDX(op)];
+    if (op != FOP_EXT && Settings::values.use_vfp_host_fpu)
+        host_op = host_fops[FOP_TO_IDX(op)];
 
     /*
      * fcvtsd takes a dN register number as destination, not sN.
@@ -1252,7 +1264,13 @@ u32 vfp_single_cpdo(ARMul_State* state, u32 inst, u32 fpscr) {
             LOG_TRACE(Core_ARM11, "itr{} ({}{}) = (s{}) op[{}] (s{}={:08x})",
                       vecitr >> FPSCR_LENGTH_BIT, type, dest, sn, FOP_TO_IDX(op), sm, m);
 
-        except = fop->fn(state, dest, sn, m, fpscr);
+        u32 result;
+        if (host_op &&
+            VFPHostSingleOp(*host_op, vfp_get_float(state, sn), m, fpscr, result, except)) {
+            vfp_put_float(state, result, dest);
+        } else {
+            except = fop->fn(state, dest, sn, m, fpscr);
+        }
         LOG_TRACE(Core_ARM11, "itr{}: exceptions={:08x}", vecitr >> FPSCR_LENGTH_BIT, except);
 
         exceptions |= except & ~VFP_NAN_FLAG;
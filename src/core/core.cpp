@@ -108,22 +108,29 @@ System::ResultStatus System::RunLoop(bool tight_loop) {
         for (auto& cpu_core : cpu_cores) {
             cpu_core->GetTimer()->Advance(max_slice);
         }
-        for (auto& cpu_core : cpu_cores) {
-            LOG_TRACE(Core_ARM11, "Core {} running for {} ticks", cpu_core->GetID(),
-                      cpu_core->GetTimer()->GetDowncount());
-            running_core = cpu_core.get();
-            kernel->SetRunningCPU(cpu_core);
-            // If we don't have a currently active thread then don't execute instructions,
-            // instead advance to the next event and try to yield to the next thread
-            if (kernel->GetCurrentThreadManager().GetCurrentThread() == nullptr) {
-                LOG_TRACE(Core_ARM11, "Core {} idling", cpu_core->GetID());
-                cpu_core->GetTimer()->Idle();
-                PrepareReschedule();
-            } else {
-                if (tight_loop) {
-                    cpu_core->Run();
+        if (cpu_threads && tight_loop) {
+            cpu_threads->RunSlice();
+            // Continue on the emulation thread as if the cores had run one after the other
+            running_core = cpu_cores.back().get();
+            kernel->SetRunningCPU(cpu_cores.back());
+        } else {
+            for (auto& cpu_core : cpu_cores) {
+                LOG_TRACE(Core_ARM11, "Core {} running for {} ticks", cpu_core->GetID(),
+                          cpu_core->GetTimer()->GetDowncount());
+                running_core = cpu_core.get();
+                kernel->SetRunningCPU(cpu_core);
+                // If we don't have a currently active thread then don't execute instructions,
+                // instead advance to the next event and try to yield to the next thread
+                if (kernel->GetCurrentThreadManager().GetCurrentThread() == nullptr) {
+                    LOG_TRACE(Core_ARM11, "Core {} idling", cpu_core->GetID());
+                    cpu_core->GetTimer()->Idle();
+                    PrepareReschedule();
                 } else {
-                    cpu_core->Step();
+                    if (tight_loop) {
+                        cpu_core->Run();
+                    } else {
+                        cpu_core->Step();
+                    }
                 }
             }
         }
@@ -228,7 +235,7 @@ System::ResultStatus System::Load(Frontend::EmuWindow& emu_window, const std::st
 }
 
 void System::PrepareReschedule() {
-    running_core->PrepareReschedule();
+    GetRunningCore().PrepareReschedule();
     reschedule_pending = true;
 }
 
@@ -287,6 +294,28 @@ System::ResultStatus System::Init(Frontend::EmuWindow& emu_window, u32 system_mo
     kernel->SetCPUs(cpu_cores);
     kernel->SetRunningCPU(cpu_cores[0]);
 
+    if (Settings::values.use_cpu_threads) {
+        if (GDBStub::IsServerEnabled()) {
+            LOG_WARNING(Core, "CPU threads requested, but not supported while debugging");
+        } else if (!CPUThreads::IsSupported(cpu_cores)) {
+            // The JIT keeps the exclusive monitor to itself, which would break guest atomics
+            LOG_WARNING(Core, "CPU threads requested, but only supported by the interpreter");
+        } else {
+            const bool deterministic = Settings::values.deterministic_cpu_threads ||
+                                       Movie::GetInstance().IsPlayingInput() ||
+                                       Movie::GetInstance().IsRecordingInput();
+            cpu_threads = std::make_unique<CPUThreads>(*kernel, *memory, cpu_cores, deterministic);
+        }
+    }
+
+    service_metrics.Reset();
+    service_metrics.SetEnabled(Settings::values.dump_service_metrics);
+
+    if (Settings::values.guest_profiler_rate != 0) {
+        guest_profiler = std::make_unique<GuestProfiler>();
+        guest_profiler->StartSampling(*this, Settings::values.guest_profiler_rate);
+    }
+
     if (Settings::values.enable_dsp_lle) {
         dsp_core = std::make_unique<AudioCore::DspLle>(*memory,
                                                        Settings::values.enable_dsp_lle_multithread);
@@ -427,6 +456,31 @@ void System::Shutdown() {
     telemetry_session->AddField(Telemetry::FieldType::Performance, "Mean_Frametime_MS",
                                 perf_stats->GetMeanFrametime());
 
+    const auto idle_loop_stats = timing->GetIdleLoopStats();
+    LOG_INFO(Core, "Skipped {} idle loops, {} ticks in total", idle_loop_stats.skips,
+             idle_loop_stats.skipped_ticks);
+    telemetry_session->AddField(Telemetry::FieldType::Performance, "Shutdown_IdleLoopSkips",
+                                idle_loop_stats.skips);
+    telemetry_session->AddField(Telemetry::FieldType::Performance,
+                                "Shutdown_SkippedIdleLoopTicks", idle_loop_stats.skipped_ticks);
+
+    u64 title_id{0};
+    if (app_loader) {
+        app_loader->ReadProgramId(title_id);
+    }
+    if (guest_profiler) {
+        const std::string report_path = guest_profiler->WriteReport(title_id);
+        if (!report_path.empty()) {
+            LOG_INFO(Core, "Guest profile written to {}", report_path);
+        }
+    }
+    if (Settings::values.dump_service_metrics) {
+        const std::string metrics_path = service_metrics.WriteJson(title_id);
+        if (!metrics_path.empty()) {
+            LOG_INFO(Core, "Service metrics written to {}", metrics_path);
+        }
+    }
+
     // Shutdown emulation session
     GDBStub::Shutdown();
     VideoCore::Shutdown();
@@ -435,9 +489,11 @@ void System::Shutdown() {
     perf_stats.reset();
     rpc_server.reset();
     cheat_engine.reset();
+    guest_profiler.reset();
     archive_manager.reset();
     service_manager.reset();
     dsp_core.reset();
+    cpu_threads.reset();
     cpu_cores.clear();
     kernel.reset();
     timing.reset();
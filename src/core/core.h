@@ -7,10 +7,13 @@
 #include <memory>
 #include <string>
 #include "common/common_types.h"
+#include "core/cpu_threads.h"
 #include "core/custom_tex_cache.h"
 #include "core/frontend/applets/mii_selector.h"
 #include "core/frontend/applets/swkbd.h"
 #include "core/frontend/image_interface.h"
+#include "core/guest_profiler.h"
+#include "core/hle/service/service_metrics.h"
 #include "core/loader/loader.h"
 #include "core/memory.h"
 #include "core/perf_stats.h"
@@ -165,6 +168,9 @@ public:
      */
 
     ARM_Interface& GetRunningCore() {
+        if (ARM_Interface* thread_core = CPUThreads::GetThreadCore()) {
+            return *thread_core;
+        }
         return *running_core;
     };
 
@@ -255,6 +261,16 @@ public:
     /// Gets a const reference to the video dumper backend
     const VideoDumper::Backend& VideoDumper() const;
 
+    /// Gets the statistics of the HLE service calls
+    Service::ServiceMetrics& ServiceMetrics() {
+        return service_metrics;
+    }
+
+    /// Gets the guest code profiler, or nullptr if profiling is disabled
+    GuestProfiler* GetGuestProfiler() {
+        return guest_profiler.get();
+    }
+
     std::unique_ptr<PerfStats> perf_stats;
     FrameLimiter frame_limiter;
 
@@ -315,6 +331,9 @@ private:
     std::vector<std::shared_ptr<ARM_Interface>> cpu_cores;
     ARM_Interface* running_core = nullptr;
 
+    /// Host threads running the cores, if enabled
+    std::unique_ptr<CPUThreads> cpu_threads;
+
     /// DSP core
     std::unique_ptr<AudioCore::DspInterface> dsp_core;
 
@@ -340,6 +359,12 @@ private:
     /// Custom texture cache system
     std::unique_ptr<Core::CustomTexCache> custom_tex_cache;
 
+    /// Statistics of the HLE service calls
+    Service::ServiceMetrics service_metrics;
+
+    /// Guest code profiler, if enabled
+    std::unique_ptr<GuestProfiler> guest_profiler;
+
     /// Image interface
     std::shared_ptr<Frontend::ImageInterface> registered_image_interface;
 
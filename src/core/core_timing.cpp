@@ -6,6 +6,7 @@
 #include <cinttypes>
 #include <tuple>
 #include "common/assert.h"
+#include "common/bit_set.h"
 #include "common/logging/log.h"
 #include "core/core_timing.h"
 
@@ -20,6 +21,193 @@ bool Timing::Event::operator<(const Timing::Event& right) const {
     return std::tie(time, fifo_order) < std::tie(right.time, right.fifo_order);
 }
 
+Timing::EventQueue::EventQueue() = default;
+
+Timing::EventQueue::~EventQueue() = default;
+
+std::size_t Timing::EventQueue::KeyHash::operator()(const Key& key) const {
+    return std::hash<const void*>()(key.type) ^ std::hash<u64>()(key.userdata);
+}
+
+Timing::EventQueue::Handle Timing::EventQueue::Push(const Event& event) {
+    u32 index;
+    if (free_nodes.empty()) {
+        index = static_cast<u32>(nodes.size());
+        nodes.push_back(Node{event, INVALID, INVALID, INVALID, INVALID, FREE, 0});
+    } else {
+        index = free_nodes.back();
+        free_nodes.pop_back();
+        nodes[index].event = event;
+    }
+    Link(index);
+    ++size;
+
+    Node& node = nodes[index];
+    node.key_prev = INVALID;
+    const auto [iter, inserted] = key_heads.try_emplace(Key{event.type, event.userdata}, index);
+    if (inserted) {
+        node.key_next = INVALID;
+    } else {
+        node.key_next = iter->second;
+        nodes[iter->second].key_prev = index;
+        iter->second = index;
+    }
+    return Handle{index, node.generation};
+}
+
+bool Timing::EventQueue::Remove(Handle handle) {
+    if (handle.index >= nodes.size()) {
+        return false;
+    }
+    const Node& node = nodes[handle.index];
+    if (node.bucket == FREE || node.generation != handle.generation) {
+        return false;
+    }
+    Release(handle.index);
+    return true;
+}
+
+void Timing::EventQueue::Remove(const TimingEventType* type, u64 userdata) {
+    const auto iter = key_heads.find(Key{type, userdata});
+    if (iter == key_heads.end()) {
+        return;
+    }
+    for (u32 index = iter->second; index != INVALID;) {
+        const u32 next = nodes[index].key_next;
+        Release(index);
+        index = next;
+    }
+}
+
+void Timing::EventQueue::Remove(const TimingEventType* type) {
+    for (u32 index = 0; index < nodes.size(); ++index) {
+        if (nodes[index].bucket != FREE && nodes[index].event.type == type) {
+            Release(index);
+        }
+    }
+}
+
+const Timing::Event* Timing::EventQueue::Front() {
+    while (occupied[0] == 0) {
+        if (!Cascade()) {
+            return nullptr;
+        }
+    }
+    const u32 slot = Common::LeastSignificantSetBit(occupied[0]);
+    return &nodes[buckets[slot].head].event;
+}
+
+void Timing::EventQueue::PopFront() {
+    const Event* front = Front();
+    ASSERT(front != nullptr);
+    Release(buckets[Common::LeastSignificantSetBit(occupied[0])].head);
+}
+
+void Timing::EventQueue::Link(u32 index) {
+    Node& node = nodes[index];
+    // Events that are already due are placed at the current position, ahead of everything else
+    const u64 key = static_cast<u64>(std::max(node.event.time, now));
+    const u64 diff = key ^ static_cast<u64>(now);
+
+    if (diff >> (NUM_LEVELS * LEVEL_BITS) != 0) {
+        node.bucket = OVERFLOW_BUCKET;
+    } else {
+        u32 level = 0;
+        while (diff >> ((level + 1) * LEVEL_BITS) != 0) {
+            ++level;
+        }
+        const u32 slot = (key >> (level * LEVEL_BITS)) & (SLOTS_PER_LEVEL - 1);
+        node.bucket = level * SLOTS_PER_LEVEL + slot;
+        occupied[level] |= u64{1} << slot;
+    }
+
+    Bucket& bucket = buckets[node.bucket];
+    // Only the lowest level is kept sorted. New events almost always go to its back, so search
+    // from there.
+    u32 prev = bucket.tail;
+    if (node.bucket < SLOTS_PER_LEVEL) {
+        while (prev != INVALID && node.event < nodes[prev].event) {
+            prev = nodes[prev].prev;
+        }
+    }
+    const u32 next = prev == INVALID ? bucket.head : nodes[prev].next;
+    node.prev = prev;
+    node.next = next;
+    (prev == INVALID ? bucket.head : nodes[prev].next) = index;
+    (next == INVALID ? bucket.tail : nodes[next].prev) = index;
+}
+
+void Timing::EventQueue::Unlink(u32 index) {
+    Node& node = nodes[index];
+    Bucket& bucket = buckets[node.bucket];
+    (node.prev == INVALID ? bucket.head : nodes[node.prev].next) = node.next;
+    (node.next == INVALID ? bucket.tail : nodes[node.next].prev) = node.prev;
+    if (bucket.head == INVALID && node.bucket != OVERFLOW_BUCKET) {
+        occupied[node.bucket / SLOTS_PER_LEVEL] &= ~(u64{1} << (node.bucket % SLOTS_PER_LEVEL));
+    }
+}
+
+void Timing::EventQueue::Release(u32 index) {
+    Unlink(index);
+    --size;
+
+    Node& node = nodes[index];
+    if (node.key_prev != INVALID) {
+        nodes[node.key_prev].key_next = node.key_next;
+    } else if (node.key_next != INVALID) {
+        key_heads[Key{node.event.type, node.event.userdata}] = node.key_next;
+    } else {
+        key_heads.erase(Key{node.event.type, node.event.userdata});
+    }
+    if (node.key_next != INVALID) {
+        nodes[node.key_next].key_prev = node.key_prev;
+    }
+
+    node.bucket = FREE;
+    ++node.generation;
+    free_nodes.push_back(index);
+}
+
+bool Timing::EventQueue::Cascade() {
+    for (u32 level = 1; level < NUM_LEVELS; ++level) {
+        if (occupied[level] == 0) {
+            continue;
+        }
+        // Move the wheel to the start of the earliest slot and spread its events over the levels
+        // below it.
+        const u32 slot = Common::LeastSignificantSetBit(occupied[level]);
+        const u32 shift = level * LEVEL_BITS;
+        const u64 upper_mask = ~((u64{1} << (shift + LEVEL_BITS)) - 1);
+        now = static_cast<s64>((static_cast<u64>(now) & upper_mask) | (u64{slot} << shift));
+        Reinsert(level * SLOTS_PER_LEVEL + slot);
+        return true;
+    }
+
+    if (buckets[OVERFLOW_BUCKET].head == INVALID) {
+        return false;
+    }
+    s64 earliest = std::numeric_limits<s64>::max();
+    for (u32 index = buckets[OVERFLOW_BUCKET].head; index != INVALID; index = nodes[index].next) {
+        earliest = std::min(earliest, nodes[index].event.time);
+    }
+    now = std::max(now, earliest);
+    Reinsert(OVERFLOW_BUCKET);
+    return true;
+}
+
+void Timing::EventQueue::Reinsert(u32 bucket) {
+    u32 index = buckets[bucket].head;
+    buckets[bucket] = Bucket{};
+    if (bucket != OVERFLOW_BUCKET) {
+        occupied[bucket / SLOTS_PER_LEVEL] &= ~(u64{1} << (bucket % SLOTS_PER_LEVEL));
+    }
+    while (index != INVALID) {
+        const u32 next = nodes[index].next;
+        Link(index);
+        index = next;
+    }
+}
+
 Timing::Timing(std::size_t num_cores, u32 cpu_clock_percentage) {
     timers.resize(num_cores);
     for (std::size_t i = 0; i < num_cores; ++i) {
@@ -48,8 +236,9 @@ TimingEventType* Timing::RegisterEvent(const std::string& name, TimedCallback ca
     return event_type;
 }
 
-void Timing::ScheduleEvent(s64 cycles_into_future, const TimingEventType* event_type, u64 userdata,
-                           std::size_t core_id) {
+Timing::EventHandle Timing::ScheduleEvent(s64 cycles_into_future,
+                                          const TimingEventType* event_type, u64 userdata,
+                                          std::size_t core_id) {
     ASSERT(event_type != nullptr);
     std::shared_ptr<Timing::Timer> timer;
     if (core_id == std::numeric_limits<std::size_t>::max()) {
@@ -60,47 +249,35 @@ void Timing::ScheduleEvent(s64 cycles_into_future, const TimingEventType* event_
     }
 
     s64 timeout = timer->GetTicks() + cycles_into_future;
-    if (current_timer == timer) {
-        // If this event needs to be scheduled before the next advance(), force one early
-        if (!timer->is_timer_sane)
-            timer->ForceExceptionCheck(cycles_into_future);
-
-        timer->event_queue.emplace_back(
-            Event{timeout, timer->event_fifo_id++, userdata, event_type});
-        std::push_heap(timer->event_queue.begin(), timer->event_queue.end(), std::greater<>());
-    } else {
-        timer->ts_queue.Push(Event{static_cast<s64>(timer->GetTicks() + cycles_into_future), 0,
-                                   userdata, event_type});
+    // If this event needs to be scheduled before the next advance(), force one early. Only the
+    // slice of the running core is cut short, as other cores may already have run theirs.
+    if (current_timer == timer && !timer->is_timer_sane) {
+        timer->ForceExceptionCheck(cycles_into_future);
     }
+
+    // Events are only scheduled by the emulation thread, which is also the one that advances the
+    // timers, so they go into the queue of another core directly.
+    const EventQueue::Handle handle =
+        timer->event_queue.Push(Event{timeout, timer->event_fifo_id++, userdata, event_type});
+    return EventHandle{timer.get(), handle};
 }
 
 void Timing::UnscheduleEvent(const TimingEventType* event_type, u64 userdata) {
     for (auto timer : timers) {
-        auto itr = std::remove_if(
-            timer->event_queue.begin(), timer->event_queue.end(),
-            [&](const Event& e) { return e.type == event_type && e.userdata == userdata; });
-
-        // Removing random items breaks the invariant so we have to re-establish it.
-        if (itr != timer->event_queue.end()) {
-            timer->event_queue.erase(itr, timer->event_queue.end());
-            std::make_heap(timer->event_queue.begin(), timer->event_queue.end(), std::greater<>());
-        }
+        timer->event_queue.Remove(event_type, userdata);
+    }
+}
+
+void Timing::UnscheduleEvent(EventHandle handle) {
+    if (handle.timer != nullptr) {
+        handle.timer->event_queue.Remove(handle.handle);
     }
-    // TODO:remove events from ts_queue
 }
 
 void Timing::RemoveEvent(const TimingEventType* event_type) {
     for (auto timer : timers) {
-        auto itr = std::remove_if(timer->event_queue.begin(), timer->event_queue.end(),
-                                  [&](const Event& e) { return e.type == event_type; });
-
-        // Removing random items breaks the invariant so we have to re-establish it.
-        if (itr != timer->event_queue.end()) {
-            timer->event_queue.erase(itr, timer->event_queue.end());
-            std::make_heap(timer->event_queue.begin(), timer->event_queue.end(), std::greater<>());
-        }
+        timer->event_queue.Remove(event_type);
     }
-    // TODO:remove events from ts_queue
 }
 
 void Timing::SetCurrentTimer(std::size_t core_id) {
@@ -119,26 +296,36 @@ std::chrono::microseconds Timing::GetGlobalTimeUs() const {
     return std::chrono::microseconds{GetTicks() * 1000000 / BASE_CLOCK_RATE_ARM11};
 }
 
+Timing::IdleLoopStats Timing::GetIdleLoopStats() const {
+    IdleLoopStats stats;
+    for (const auto& timer : timers) {
+        stats.skips += timer->GetIdleLoopSkips();
+        stats.skipped_ticks += timer->GetSkippedIdleLoopTicks();
+    }
+    return stats;
+}
+
 std::shared_ptr<Timing::Timer> Timing::GetTimer(std::size_t cpu_id) {
     return timers[cpu_id];
 }
 
 Timing::Timer::Timer(double cpu_clock_scale_) : cpu_clock_scale(cpu_clock_scale_) {}
 
-Timing::Timer::~Timer() {
-    MoveEvents();
-}
+Timing::Timer::~Timer() = default;
 
 u64 Timing::Timer::GetTicks() const {
     u64 ticks = static_cast<u64>(executed_ticks);
     if (!is_timer_sane) {
-        ticks += slice_length - downcount;
+        ticks += slice_length - downcount.load(std::memory_order_relaxed);
     }
     return ticks;
 }
 
 void Timing::Timer::AddTicks(u64 ticks) {
-    downcount -= static_cast<u64>(ticks * cpu_clock_scale);
+    // Only the thread running the core writes the downcount, so it needs no atomic subtraction
+    const s64 new_downcount = downcount.load(std::memory_order_relaxed) -
+                              static_cast<s64>(ticks * cpu_clock_scale);
+    downcount.store(new_downcount, std::memory_order_relaxed);
 }
 
 u64 Timing::Timer::GetIdleTicks() const {
@@ -147,64 +334,71 @@ u64 Timing::Timer::GetIdleTicks() const {
 
 void Timing::Timer::ForceExceptionCheck(s64 cycles) {
     cycles = std::max<s64>(0, cycles);
-    if (downcount > cycles) {
-        slice_length -= downcount - cycles;
-        downcount = cycles;
+    const s64 current_downcount = downcount.load(std::memory_order_relaxed);
+    if (current_downcount > cycles) {
+        slice_length -= current_downcount - cycles;
+        downcount.store(cycles, std::memory_order_relaxed);
     }
 }
 
-void Timing::Timer::MoveEvents() {
-    for (Event ev; ts_queue.Pop(ev);) {
-        ev.fifo_order = event_fifo_id++;
-        event_queue.emplace_back(std::move(ev));
-        std::push_heap(event_queue.begin(), event_queue.end(), std::greater<>());
+s64 Timing::Timer::GetMaxSliceLength() {
+    const Event* next_event = event_queue.Front();
+    if (next_event == nullptr) {
+        return MAX_SLICE_LENGTH;
     }
-}
-
-s64 Timing::Timer::GetMaxSliceLength() const {
-    auto next_event = std::find_if(event_queue.begin(), event_queue.end(),
-                                   [&](const Event& e) { return e.time - executed_ticks > 0; });
-    if (next_event != event_queue.end()) {
+    if (next_event->time - executed_ticks > 0) {
         return next_event->time - executed_ticks;
     }
-    return MAX_SLICE_LENGTH;
+
+    // Events that are already due run on the next Advance() anyway, so look past them.
+    s64 max_slice = std::numeric_limits<s64>::max();
+    event_queue.ForEach([&](const Event& e) {
+        if (e.time - executed_ticks > 0) {
+            max_slice = std::min(max_slice, e.time - executed_ticks);
+        }
+    });
+    return max_slice == std::numeric_limits<s64>::max() ? MAX_SLICE_LENGTH : max_slice;
 }
 
 void Timing::Timer::Advance(s64 max_slice_length) {
-    MoveEvents();
-
-    s64 cycles_executed = slice_length - downcount;
+    s64 cycles_executed = slice_length - downcount.load(std::memory_order_relaxed);
     idled_cycles = 0;
     executed_ticks += cycles_executed;
     slice_length = max_slice_length;
 
     is_timer_sane = true;
 
-    while (!event_queue.empty() && event_queue.front().time <= executed_ticks) {
-        Event evt = std::move(event_queue.front());
-        std::pop_heap(event_queue.begin(), event_queue.end(), std::greater<>());
-        event_queue.pop_back();
+    for (const Event* next = event_queue.Front(); next && next->time <= executed_ticks;
+         next = event_queue.Front()) {
+        const Event evt = *next;
+        event_queue.PopFront();
         evt.type->callback(evt.userdata, executed_ticks - evt.time);
     }
 
     is_timer_sane = false;
 
     // Still events left (scheduled in the future)
-    if (!event_queue.empty()) {
-        slice_length = static_cast<int>(
-            std::min<s64>(event_queue.front().time - executed_ticks, max_slice_length));
+    if (const Event* next = event_queue.Front()) {
+        slice_length =
+            static_cast<int>(std::min<s64>(next->time - executed_ticks, max_slice_length));
     }
 
-    downcount = slice_length;
+    downcount.store(slice_length, std::memory_order_relaxed);
 }
 
 void Timing::Timer::Idle() {
-    idled_cycles += downcount;
-    downcount = 0;
+    idled_cycles += downcount.load(std::memory_order_relaxed);
+    downcount.store(0, std::memory_order_relaxed);
+}
+
+void Timing::Timer::SkipIdleLoop() {
+    ++idle_loop_skips;
+    skipped_idle_loop_ticks += std::max<s64>(downcount.load(std::memory_order_relaxed), 0);
+    Idle();
 }
 
 s64 Timing::Timer::GetDowncount() const {
-    return downcount;
+    return downcount.load(std::memory_order_relaxed);
 }
 
 } // namespace Core
@@ -17,6 +17,8 @@
  *   ScheduleEvent(periodInCycles - cyclesLate, callback, "whatever")
  */
 
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <functional>
 #include <limits>
@@ -25,7 +27,6 @@
 #include <vector>
 #include "common/common_types.h"
 #include "common/logging/log.h"
-#include "common/threadsafe_queue.h"
 
 // The timing we get from the assembly is 268,111,855.956 Hz
 // It is possible that this number isn't just an integer because the compiler could have
@@ -144,6 +145,118 @@ public:
         bool operator<(const Event& right) const;
     };
 
+    /**
+     * Priority queue of events, implemented as a hierarchical timing wheel.
+     *
+     * Each level splits time into SLOTS_PER_LEVEL slots, each of which covers a whole turn of the
+     * level below it. An event is placed on the level of the highest digit in which its time
+     * differs from the current position of the wheel, so inserting and removing events are O(1).
+     * Slots are only sorted once the wheel reaches them, by moving their events down a level.
+     * Events on the lowest level share the same time and are kept in FIFO order.
+     */
+    class EventQueue {
+    public:
+        /// Stable reference to a queued event, which stays valid until the event is removed.
+        struct Handle {
+            u32 index;
+            u32 generation;
+        };
+
+        EventQueue();
+        ~EventQueue();
+
+        Handle Push(const Event& event);
+
+        /// Removes the referenced event. Returns false if it was not queued anymore.
+        bool Remove(Handle handle);
+
+        /// Removes all events with the given type and userdata.
+        void Remove(const TimingEventType* type, u64 userdata);
+
+        /// Removes all events with the given type.
+        void Remove(const TimingEventType* type);
+
+        /// Returns the earliest event, or nullptr if the queue is empty.
+        const Event* Front();
+
+        /// Removes the earliest event. The queue must not be empty.
+        void PopFront();
+
+        bool Empty() const {
+            return size == 0;
+        }
+
+        std::size_t Size() const {
+            return size;
+        }
+
+        /// Calls func for each queued event, in no particular order.
+        template <typename Func>
+        void ForEach(Func&& func) const {
+            for (const Node& node : nodes) {
+                if (node.bucket != FREE) {
+                    func(node.event);
+                }
+            }
+        }
+
+    private:
+        static constexpr u32 LEVEL_BITS = 6;
+        static constexpr u32 SLOTS_PER_LEVEL = 1 << LEVEL_BITS;
+        static constexpr u32 NUM_LEVELS = 6;
+        /// Events too far into the future for the wheel wait unsorted in an extra bucket
+        static constexpr u32 OVERFLOW_BUCKET = NUM_LEVELS * SLOTS_PER_LEVEL;
+        static constexpr u32 NUM_BUCKETS = OVERFLOW_BUCKET + 1;
+        static constexpr u32 FREE = NUM_BUCKETS;
+        static constexpr u32 INVALID = std::numeric_limits<u32>::max();
+
+        struct Node {
+            Event event;
+            u32 prev;
+            u32 next;
+            /// Links to the other events with the same type and userdata
+            u32 key_prev;
+            u32 key_next;
+            u32 bucket;
+            u32 generation;
+        };
+
+        struct Bucket {
+            u32 head = INVALID;
+            u32 tail = INVALID;
+        };
+
+        struct Key {
+            const TimingEventType* type;
+            u64 userdata;
+
+            bool operator==(const Key& other) const {
+                return type == other.type && userdata == other.userdata;
+            }
+        };
+
+        struct KeyHash {
+            std::size_t operator()(const Key& key) const;
+        };
+
+        void Link(u32 index);
+        void Unlink(u32 index);
+        void Release(u32 index);
+        bool Cascade();
+        void Reinsert(u32 bucket);
+
+        std::vector<Node> nodes;
+        std::vector<u32> free_nodes;
+        std::array<Bucket, NUM_BUCKETS> buckets;
+        /// Bitmap of the non-empty slots of each level
+        std::array<u64, NUM_LEVELS> occupied{};
+        /// First event of each type and userdata
+        std::unordered_map<Key, u32, KeyHash> key_heads;
+        /// Current position of the wheel, which is never past the earliest event
+        s64 now = 0;
+        std::size_t size = 0;
+    };
+
     static constexpr int MAX_SLICE_LENGTH = 20000;
 
     class Timer {
@@ -151,34 +264,39 @@ public:
         Timer(double cpu_clock_scale);
         ~Timer();
 
-        s64 GetMaxSliceLength() const;
+        s64 GetMaxSliceLength();
 
         void Advance(s64 max_slice_length = MAX_SLICE_LENGTH);
 
         void Idle();
 
+        /**
+         * Skips the rest of the slice because the core is spinning in a loop that can't exit
+         * before the next event. Counted separately from Idle() to measure how often this happens.
+         */
+        void SkipIdleLoop();
+
         u64 GetTicks() const;
         u64 GetIdleTicks() const;
 
+        u64 GetIdleLoopSkips() const {
+            return idle_loop_skips;
+        }
+
+        u64 GetSkippedIdleLoopTicks() const {
+            return skipped_idle_loop_ticks;
+        }
+
         void AddTicks(u64 ticks);
 
         s64 GetDowncount() const;
 
         void ForceExceptionCheck(s64 cycles);
 
-        void MoveEvents();
-
     private:
         friend class Timing;
-        // The queue is a min-heap using std::make_heap/push_heap/pop_heap.
-        // We don't use std::priority_queue because we need to be able to serialize, unserialize and
-        // erase arbitrary events (RemoveEvent()) regardless of the queue order. These aren't
-        // accomodated by the standard adaptor class.
-        std::vector<Event> event_queue;
+        EventQueue event_queue;
         u64 event_fifo_id = 0;
-        // the queue for storing the events from other threads threadsafe until they will be added
-        // to the event_queue by the emu thread
-        Common::MPSCQueue<Event> ts_queue;
         // Are we in a function that has been called from Advance()
         // If events are sheduled from a function that gets called from Advance(),
         // don't change slice_length and downcount.
@@ -189,14 +307,24 @@ public:
         bool is_timer_sane = true;
 
         s64 slice_length = MAX_SLICE_LENGTH;
-        s64 downcount = MAX_SLICE_LENGTH;
+        // Atomic because the emulation thread reads the ticks of cores that run on their own host
+        // threads (see CPUThreads), e.g. to schedule an event on another core.
+        std::atomic<s64> downcount{MAX_SLICE_LENGTH};
         s64 executed_ticks = 0;
         u64 idled_cycles = 0;
+        u64 idle_loop_skips = 0;
+        u64 skipped_idle_loop_ticks = 0;
         // Stores a scaling for the internal clockspeed. Changing this number results in
         // under/overclocking the guest cpu
         double cpu_clock_scale = 1.0;
     };
 
+    /// Identifies a scheduled event, so that it can be unscheduled without looking it up.
+    struct EventHandle {
+        Timer* timer = nullptr;
+        EventQueue::Handle handle{};
+    };
+
     explicit Timing(std::size_t num_cores, u32 cpu_clock_percentage);
 
     ~Timing(){};
@@ -206,11 +334,15 @@ public:
      */
     TimingEventType* RegisterEvent(const std::string& name, TimedCallback callback);
 
-    void ScheduleEvent(s64 cycles_into_future, const TimingEventType* event_type, u64 userdata = 0,
-                       std::size_t core_id = std::numeric_limits<std::size_t>::max());
+    EventHandle ScheduleEvent(s64 cycles_into_future, const TimingEventType* event_type,
+                              u64 userdata = 0,
+                              std::size_t core_id = std::numeric_limits<std::size_t>::max());
 
     void UnscheduleEvent(const TimingEventType* event_type, u64 userdata);
 
+    /// Unschedules an event. Does nothing if it already ran or was unscheduled.
+    void UnscheduleEvent(EventHandle handle);
+
     /// We only permit one event of each type in the queue at a time.
     void RemoveEvent(const TimingEventType* event_type);
 
@@ -231,6 +363,14 @@ public:
 
     std::chrono::microseconds GetGlobalTimeUs() const;
 
+    struct IdleLoopStats {
+        u64 skips = 0;
+        u64 skipped_ticks = 0;
+    };
+
+    /// Returns how often and by how much the cores skipped ahead out of idle loops, in total.
+    IdleLoopStats GetIdleLoopStats() const;
+
     std::shared_ptr<Timer> GetTimer(std::size_t cpu_id);
 
 private:
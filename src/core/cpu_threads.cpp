@@ -0,0 +1,225 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <limits>
+#include <tuple>
+#include <fmt/format.h>
+#include "common/assert.h"
+#include "common/logging/log.h"
+#include "core/arm/arm_interface.h"
+#include "core/core_timing.h"
+#include "core/cpu_threads.h"
+#include "core/hle/kernel/kernel.h"
+#include "core/hle/kernel/thread.h"
+#include "core/hle/lock.h"
+#include "core/memory.h"
+
+namespace Core {
+
+namespace {
+/// The instance and core run by the calling host thread, if it is a core thread
+thread_local CPUThreads* thread_owner = nullptr;
+thread_local std::size_t thread_core_index = 0;
+/// Core whose request the emulation thread is serving
+thread_local ARM_Interface* serving_core = nullptr;
+
+constexpr u64 SLICE_FINISHED = std::numeric_limits<u64>::max();
+} // Anonymous namespace
+
+CPUThreads::CPUThreads(Kernel::KernelSystem& kernel, Memory::MemorySystem& memory,
+                       const std::vector<std::shared_ptr<ARM_Interface>>& cores, bool deterministic)
+    : kernel(kernel), memory(memory), cores(cores), deterministic(deterministic),
+      exclusive_monitor(cores.size()), slice_start(cores.size() + 1), core_idle(cores.size()),
+      core_page_tables(cores.size()), progress(cores.size()) {
+    LOG_INFO(Core, "Running {} cores on host threads ({})", cores.size(),
+             deterministic ? "deterministic" : "non-deterministic");
+    for (const auto& core : cores) {
+        core->SetExclusiveMonitor(&exclusive_monitor);
+    }
+    threads.reserve(cores.size());
+    for (std::size_t i = 0; i < cores.size(); ++i) {
+        threads.emplace_back(&CPUThreads::ThreadMain, this, i);
+    }
+}
+
+CPUThreads::~CPUThreads() {
+    stop_requested = true;
+    slice_start.Sync();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (const auto& core : cores) {
+        core->SetExclusiveMonitor(nullptr);
+    }
+}
+
+bool CPUThreads::IsSupported(const std::vector<std::shared_ptr<ARM_Interface>>& cores) {
+    return std::all_of(cores.begin(), cores.end(),
+                       [](const auto& core) { return core->SupportsExclusiveMonitor(); });
+}
+
+void CPUThreads::RunSlice() {
+    {
+        std::lock_guard lock{turn_mutex};
+        for (std::size_t i = 0; i < cores.size(); ++i) {
+            progress[i] = cores[i]->GetTimer()->GetTicks();
+        }
+    }
+
+    // The kernel is only touched by this thread, so it decides here which cores have nothing to
+    // run and which address space the others start in.
+    {
+        std::lock_guard lock{HLE::g_hle_lock};
+        for (std::size_t i = 0; i < cores.size(); ++i) {
+            ARM_Interface& core = *cores[i];
+            core_page_tables[i] = SwitchToCore(i);
+            core_idle[i] = kernel.GetCurrentThreadManager().GetCurrentThread() == nullptr;
+            if (core_idle[i]) {
+                LOG_TRACE(Core_ARM11, "Core {} idling", core.GetID());
+                core.GetTimer()->Idle();
+                kernel.PrepareReschedule();
+            }
+        }
+        serving_core = nullptr;
+    }
+
+    {
+        std::lock_guard lock{request_mutex};
+        num_running = cores.size();
+    }
+    slice_start.Sync();
+
+    std::unique_lock lock{request_mutex};
+    while (true) {
+        request_cv.wait(lock, [this] { return !requests.empty() || num_running == 0; });
+        if (requests.empty()) {
+            break;
+        }
+        Request* request = requests.front();
+        requests.pop_front();
+        lock.unlock();
+        {
+            std::lock_guard hle_lock{HLE::g_hle_lock};
+            SwitchToCore(request->core_index);
+            (*request->function)();
+            request->page_table = memory.GetCurrentPageTable();
+            serving_core = nullptr;
+        }
+        lock.lock();
+        request->done = true;
+        request_done_cv.notify_all();
+    }
+}
+
+ARM_Interface* CPUThreads::GetThreadCore() {
+    if (thread_owner == nullptr) {
+        return serving_core;
+    }
+    return thread_owner->cores[thread_core_index].get();
+}
+
+bool CPUThreads::IsCoreThread() {
+    return thread_owner != nullptr;
+}
+
+void CPUThreads::RunOnEmulationThread(const std::function<void()>& function) {
+    DEBUG_ASSERT_MSG(IsCoreThread(), "Not called from a core thread");
+    thread_owner->RunRequest(thread_core_index, function);
+}
+
+void CPUThreads::ThreadMain(std::size_t core_index) {
+    thread_owner = this;
+    thread_core_index = core_index;
+    Common::SetCurrentThreadName(fmt::format("CPUCore_{}", core_index).c_str());
+    memory.UseThreadLocalPageTable();
+
+    while (true) {
+        slice_start.Sync();
+        if (stop_requested) {
+            break;
+        }
+        RunCore(core_index);
+    }
+}
+
+void CPUThreads::RunCore(std::size_t core_index) {
+    ARM_Interface& core = *cores[core_index];
+    memory.SetCurrentPageTable(core_page_tables[core_index]);
+
+    if (!core_idle[core_index]) {
+        LOG_TRACE(Core_ARM11, "Core {} running for {} ticks", core.GetID(),
+                  core.GetTimer()->GetDowncount());
+        core.Run();
+    }
+
+    FinishSlice(core_index);
+}
+
+void CPUThreads::RunRequest(std::size_t core_index, const std::function<void()>& function) {
+    if (deterministic) {
+        WaitForTurn(core_index);
+    }
+
+    Request request{core_index, &function};
+    {
+        std::unique_lock lock{request_mutex};
+        requests.push_back(&request);
+        request_cv.notify_one();
+        request_done_cv.wait(lock, [&request] { return request.done; });
+    }
+
+    if (deterministic) {
+        ReleaseTurn();
+    }
+
+    // The kernel may have switched the core to another process
+    memory.SetCurrentPageTable(request.page_table);
+}
+
+Memory::PageTable* CPUThreads::SwitchToCore(std::size_t core_index) {
+    serving_core = cores[core_index].get();
+    kernel.SetRunningCPU(cores[core_index]);
+    return memory.GetCurrentPageTable();
+}
+
+void CPUThreads::WaitForTurn(std::size_t core_index) {
+    std::unique_lock lock{turn_mutex};
+    progress[core_index] = cores[core_index]->GetTimer()->GetTicks();
+    turn_cv.notify_all();
+    turn_cv.wait(lock, [this, core_index] { return !turn_taken && IsNextInTurn(core_index); });
+    turn_taken = true;
+}
+
+void CPUThreads::ReleaseTurn() {
+    std::lock_guard lock{turn_mutex};
+    turn_taken = false;
+    turn_cv.notify_all();
+}
+
+bool CPUThreads::IsNextInTurn(std::size_t core_index) const {
+    // Cores that are still running have not reached their next request yet, and it can't happen
+    // before the time of their previous one. Waiting for them to either make a request or finish
+    // the slice therefore serves requests strictly in emulated time order.
+    const auto key = std::make_tuple(progress[core_index], core_index);
+    for (std::size_t i = 0; i < progress.size(); ++i) {
+        if (i != core_index && std::make_tuple(progress[i], i) < key) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void CPUThreads::FinishSlice(std::size_t core_index) {
+    {
+        std::lock_guard lock{turn_mutex};
+        progress[core_index] = SLICE_FINISHED;
+        turn_cv.notify_all();
+    }
+    std::lock_guard lock{request_mutex};
+    --num_running;
+    request_cv.notify_one();
+}
+
+} // namespace Core
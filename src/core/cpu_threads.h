@@ -0,0 +1,123 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "common/common_types.h"
+#include "common/thread.h"
+#include "core/arm/exclusive_monitor.h"
+
+class ARM_Interface;
+
+namespace Kernel {
+class KernelSystem;
+}
+
+namespace Memory {
+class MemorySystem;
+struct PageTable;
+} // namespace Memory
+
+namespace Core {
+
+/**
+ * Runs each emulated core on its own host thread. All cores run the same timing slice in parallel,
+ * and the emulation thread waits until every one of them finished it, so timing events, HW updates
+ * and rescheduling are still handled by the emulation thread between slices.
+ *
+ * Everything beyond guest code and plain guest memory runs on the emulation thread as well: core
+ * threads hand SVCs, MMIO and rasterizer-cached memory accesses over to it with
+ * RunOnEmulationThread and wait for them. The GPU, its rasterizer and the kernel are therefore
+ * only ever used by the emulation thread, which owns the graphics context.
+ *
+ * In deterministic mode these requests are additionally served in order of the emulated time at
+ * which the cores make them (ties are broken by core ID), which makes all kernel and HLE
+ * interactions reproducible. Accesses of different cores to shared guest memory are not ordered
+ * in either mode. LDREX and STREX go through an exclusive monitor shared by all cores.
+ */
+class CPUThreads {
+public:
+    CPUThreads(Kernel::KernelSystem& kernel, Memory::MemorySystem& memory,
+               const std::vector<std::shared_ptr<ARM_Interface>>& cores, bool deterministic);
+    ~CPUThreads();
+
+    /// Returns whether every core supports the shared exclusive monitor, which is required.
+    static bool IsSupported(const std::vector<std::shared_ptr<ARM_Interface>>& cores);
+
+    /// Runs the current slice on all cores and waits until every one of them has finished it.
+    void RunSlice();
+
+    /**
+     * Returns the core the calling host thread acts for: the core run by a core thread, or the
+     * core whose request the emulation thread is serving. Returns nullptr otherwise.
+     */
+    static ARM_Interface* GetThreadCore();
+
+    /// Returns whether the calling host thread is a core thread.
+    static bool IsCoreThread();
+
+    /**
+     * Runs function on the emulation thread on behalf of the core of the calling core thread, with
+     * the HLE lock held and the kernel switched to that core, and waits until it returned.
+     */
+    static void RunOnEmulationThread(const std::function<void()>& function);
+
+private:
+    struct Request {
+        std::size_t core_index;
+        const std::function<void()>* function;
+        /// Page table of the core once the request was served, as the kernel may have changed it
+        Memory::PageTable* page_table = nullptr;
+        bool done = false;
+    };
+
+    void ThreadMain(std::size_t core_index);
+    void RunCore(std::size_t core_index);
+    void RunRequest(std::size_t core_index, const std::function<void()>& function);
+
+    /// Switches the kernel to a core and returns its page table. Only on the emulation thread.
+    Memory::PageTable* SwitchToCore(std::size_t core_index);
+
+    void WaitForTurn(std::size_t core_index);
+    void ReleaseTurn();
+    bool IsNextInTurn(std::size_t core_index) const;
+    void FinishSlice(std::size_t core_index);
+
+    Kernel::KernelSystem& kernel;
+    Memory::MemorySystem& memory;
+    std::vector<std::shared_ptr<ARM_Interface>> cores;
+    const bool deterministic;
+    ExclusiveMonitor exclusive_monitor;
+
+    std::vector<std::thread> threads;
+    Common::Barrier slice_start;
+    std::atomic<bool> stop_requested{false};
+
+    /// Set by the emulation thread before a slice starts, for each core
+    std::vector<bool> core_idle;
+    std::vector<Memory::PageTable*> core_page_tables;
+
+    /// Requests of the core threads and the number of cores still running the slice
+    std::mutex request_mutex;
+    std::condition_variable request_cv;
+    std::condition_variable request_done_cv;
+    std::deque<Request*> requests;
+    std::size_t num_running = 0;
+
+    /// Emulated time of the last request of each core, or ~0 once it finished its slice
+    std::vector<u64> progress;
+    bool turn_taken = false;
+    std::mutex turn_mutex;
+    std::condition_variable turn_cv;
+};
+
+} // namespace Core
@@ -0,0 +1,202 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <fmt/format.h>
+#include "common/common_funcs.h"
+#include "common/file_util.h"
+#include "common/hash.h"
+#include "common/logging/log.h"
+#include "core/file_sys/content_cache.h"
+#include "core/loader/loader.h"
+
+namespace FileSys {
+
+namespace {
+// A cache entry is a ContentCacheHeader, followed by a SectionEntry for each section and then the
+// data of the sections in the same order. data_hash covers everything after the header.
+constexpr u32 CONTENT_CACHE_MAGIC = Loader::MakeMagic('C', 'C', 'N', 'T');
+constexpr u32 CONTENT_CACHE_VERSION = 1;
+
+/// An ExeFS has at most 8 sections
+constexpr u32 MAX_SECTIONS = 8;
+
+struct ContentCacheHeader {
+    u32 magic;
+    u32 version;
+    u64 program_id;
+    u64 content_hash;
+    /// Seconds since the epoch when the entry was last read or written
+    u64 last_used;
+    u64 data_hash;
+    u32 num_sections;
+    INSERT_PADDING_WORDS(1);
+};
+static_assert(sizeof(ContentCacheHeader) == 48, "ContentCacheHeader has incorrect size");
+
+struct SectionEntry {
+    std::array<char, 8> name;
+    u32 size;
+    INSERT_PADDING_WORDS(1);
+};
+static_assert(sizeof(SectionEntry) == 16, "SectionEntry has incorrect size");
+
+std::string GetEntryPath(const std::string& cache_dir, u64 program_id, u64 content_hash) {
+    return fmt::format("{}{:016X}_{:016X}.bin", cache_dir, program_id, content_hash);
+}
+
+u64 GetCurrentTime() {
+    return static_cast<u64>(std::chrono::duration_cast<std::chrono::seconds>(
+                                std::chrono::system_clock::now().time_since_epoch())
+                                .count());
+}
+
+/// Removes the least recently used entries other than keep_path until the cache fits.
+void EvictEntries(const std::string& cache_dir, const std::string& keep_path, u64 size_limit) {
+    struct Entry {
+        std::string path;
+        u64 last_used;
+        u64 size;
+    };
+    std::vector<Entry> entries;
+    u64 total_size = 0;
+    FileUtil::ForeachDirectoryEntry(
+        nullptr, cache_dir,
+        [&](u64* /*num_entries_out*/, const std::string& /*directory*/, const std::string& name) {
+            const std::string path = cache_dir + name;
+            if (FileUtil::IsDirectory(path)) {
+                return true;
+            }
+            FileUtil::IOFile file(path, "rb");
+            ContentCacheHeader header{};
+            const u64 size = file.GetSize();
+            total_size += size;
+            if (path == keep_path) {
+                return true;
+            }
+            if (file.ReadBytes(&header, sizeof(header)) != sizeof(header) ||
+                header.magic != CONTENT_CACHE_MAGIC) {
+                // Leftovers of an interrupted write, or not ours. Remove them first.
+                header.last_used = 0;
+            }
+            entries.push_back({path, header.last_used, size});
+            return true;
+        });
+
+    std::sort(entries.begin(), entries.end(),
+              [](const Entry& a, const Entry& b) { return a.last_used < b.last_used; });
+    for (const Entry& entry : entries) {
+        if (total_size <= size_limit) {
+            break;
+        }
+        if (FileUtil::Delete(entry.path)) {
+            LOG_INFO(Service_FS, "Removed {} from the content cache", entry.path);
+            total_size -= entry.size;
+        }
+    }
+}
+} // Anonymous namespace
+
+std::optional<ExeFSSections> ReadContentCache(const std::string& cache_dir, u64 program_id,
+                                              u64 content_hash) {
+    const std::string path = GetEntryPath(cache_dir, program_id, content_hash);
+    if (!FileUtil::Exists(path)) {
+        return std::nullopt;
+    }
+
+    FileUtil::IOFile file(path, "r+b");
+    ContentCacheHeader header{};
+    std::vector<u8> data;
+    bool valid = file.ReadBytes(&header, sizeof(header)) == sizeof(header) &&
+                 header.magic == CONTENT_CACHE_MAGIC && header.version == CONTENT_CACHE_VERSION &&
+                 header.program_id == program_id && header.content_hash == content_hash &&
+                 header.num_sections <= MAX_SECTIONS;
+    if (valid) {
+        data.resize(file.GetSize() - sizeof(header));
+        valid = file.ReadBytes(data.data(), data.size()) == data.size() &&
+                Common::ComputeHash64(data.data(), data.size()) == header.data_hash &&
+                data.size() >= header.num_sections * sizeof(SectionEntry);
+    }
+
+    ExeFSSections sections;
+    std::size_t offset = header.num_sections * sizeof(SectionEntry);
+    for (u32 i = 0; valid && i < header.num_sections; ++i) {
+        SectionEntry entry;
+        std::memcpy(&entry, data.data() + i * sizeof(SectionEntry), sizeof(entry));
+        if (entry.size > data.size() - offset) {
+            valid = false;
+            break;
+        }
+        const auto name_end = std::find(entry.name.begin(), entry.name.end(), '\0');
+        const std::string name(entry.name.begin(), name_end);
+        sections[name].assign(data.begin() + offset, data.begin() + offset + entry.size);
+        offset += entry.size;
+    }
+    if (!valid) {
+        LOG_WARNING(Service_FS, "Content cache entry {} is corrupted, removing it", path);
+        file.Close();
+        FileUtil::Delete(path);
+        return std::nullopt;
+    }
+
+    header.last_used = GetCurrentTime();
+    file.Seek(offsetof(ContentCacheHeader, last_used), SEEK_SET);
+    file.WriteObject(header.last_used);
+    return sections;
+}
+
+bool WriteContentCache(const std::string& cache_dir, u64 program_id, u64 content_hash,
+                       const ExeFSSections& sections, u64 size_limit) {
+    if (sections.size() > MAX_SECTIONS || !FileUtil::CreateFullPath(cache_dir)) {
+        return false;
+    }
+
+    std::vector<u8> data(sections.size() * sizeof(SectionEntry));
+    std::size_t index = 0;
+    for (const auto& [name, section] : sections) {
+        SectionEntry entry{};
+        std::memcpy(entry.name.data(), name.data(), std::min(name.size(), entry.name.size()));
+        entry.size = static_cast<u32>(section.size());
+        std::memcpy(data.data() + index * sizeof(SectionEntry), &entry, sizeof(entry));
+        data.insert(data.end(), section.begin(), section.end());
+        ++index;
+    }
+
+    ContentCacheHeader header{};
+    header.magic = CONTENT_CACHE_MAGIC;
+    header.version = CONTENT_CACHE_VERSION;
+    header.program_id = program_id;
+    header.content_hash = content_hash;
+    header.last_used = GetCurrentTime();
+    header.data_hash = Common::ComputeHash64(data.data(), data.size());
+    header.num_sections = static_cast<u32>(sections.size());
+
+    // Written under another name first, so that an interrupted write never leaves a valid entry
+    const std::string path = GetEntryPath(cache_dir, program_id, content_hash);
+    const std::string temp_path = path + ".tmp";
+    {
+        FileUtil::IOFile file(temp_path, "wb");
+        if (file.WriteObject(header) != 1 ||
+            file.WriteBytes(data.data(), data.size()) != data.size()) {
+            LOG_ERROR(Service_FS, "Could not write the content cache entry {}", temp_path);
+            file.Close();
+            FileUtil::Delete(temp_path);
+            return false;
+        }
+    }
+    FileUtil::Delete(path);
+    if (!FileUtil::Rename(temp_path, path)) {
+        FileUtil::Delete(temp_path);
+        return false;
+    }
+
+    EvictEntries(cache_dir, path, size_limit);
+    return true;
+}
+
+} // namespace FileSys
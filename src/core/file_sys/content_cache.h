@@ -0,0 +1,36 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+#include "common/common_types.h"
+
+namespace FileSys {
+
+/// Decrypted and decompressed ExeFS sections of a content, by section name.
+using ExeFSSections = std::map<std::string, std::vector<u8>>;
+
+/**
+ * Reads the cached ExeFS sections of a content, and marks them as recently used.
+ * @param cache_dir Directory of the cache, with a trailing '/'
+ * @param program_id Program ID of the content
+ * @param content_hash Hash identifying the exact content, as titles can be updated
+ * @returns the sections, or std::nullopt if they are not cached or the cache entry is corrupted.
+ */
+std::optional<ExeFSSections> ReadContentCache(const std::string& cache_dir, u64 program_id,
+                                              u64 content_hash);
+
+/**
+ * Stores the ExeFS sections of a content in the cache. The least recently used entries of other
+ * contents are then removed until the cache is no larger than size_limit.
+ * @returns true on success.
+ */
+bool WriteContentCache(const std::string& cache_dir, u64 program_id, u64 content_hash,
+                       const ExeFSSections& sections, u64 size_limit);
+
+} // namespace FileSys
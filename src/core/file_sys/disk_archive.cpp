@@ -21,6 +21,9 @@ ResultVal<std::size_t> DiskFile::Read(const u64 offset, const std::size_t length
     if (!mode.read_flag)
         return ERROR_INVALID_OPEN_FLAGS;
 
+    if (read_ahead)
+        return MakeResult<std::size_t>(read_ahead->Read(offset, length, buffer));
+
     file->Seek(offset, SEEK_SET);
     return MakeResult<std::size_t>(file->ReadBytes(buffer, length));
 }
@@ -38,16 +41,22 @@ ResultVal<std::size_t> DiskFile::Write(const u64 offset, const std::size_t lengt
 }
 
 u64 DiskFile::GetSize() const {
+    if (read_ahead)
+        read_ahead->Wait();
     return file->GetSize();
 }
 
 bool DiskFile::SetSize(const u64 size) const {
+    if (read_ahead)
+        read_ahead->Invalidate();
     file->Resize(size);
     file->Flush();
     return true;
 }
 
 bool DiskFile::Close() const {
+    if (read_ahead)
+        read_ahead->Invalidate();
     return file->Close();
 }
 
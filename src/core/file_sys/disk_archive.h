@@ -13,6 +13,7 @@
 #include "core/file_sys/archive_backend.h"
 #include "core/file_sys/directory_backend.h"
 #include "core/file_sys/file_backend.h"
+#include "core/file_sys/read_ahead.h"
 #include "core/hle/result.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -27,6 +28,15 @@ public:
         : file(new FileUtil::IOFile(std::move(file_))) {
         delay_generator = std::move(delay_generator_);
         mode.hex = mode_.hex;
+        // Writable files would have to drop prefetched data on every write, so only read ahead
+        // in files that are only read
+        if (mode.read_flag && !mode.write_flag) {
+            read_ahead =
+                std::make_unique<ReadAhead>([this](u64 offset, std::size_t length, u8* buffer) {
+                    file->Seek(offset, SEEK_SET);
+                    return file->ReadBytes(buffer, length);
+                });
+        }
     }
 
     ResultVal<std::size_t> Read(u64 offset, std::size_t length, u8* buffer) const override;
@@ -37,12 +47,16 @@ public:
     bool Close() const override;
 
     void Flush() const override {
+        if (read_ahead)
+            read_ahead->Wait();
         file->Flush();
     }
 
 protected:
     Mode mode;
     std::unique_ptr<FileUtil::IOFile> file;
+    /// Only used for read-only files. Must be waited for before using the file outside of Read.
+    std::unique_ptr<ReadAhead> read_ahead;
 };
 
 class DiskDirectory : public DirectoryBackend {
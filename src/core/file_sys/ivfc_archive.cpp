@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <cstring>
 #include <memory>
 #include <utility>
@@ -90,14 +91,22 @@ u64 IVFCArchive::GetFreeBytes() const {
 
 IVFCFile::IVFCFile(std::shared_ptr<RomFSReader> file,
                    std::unique_ptr<DelayGenerator> delay_generator_)
-    : romfs_file(std::move(file)) {
+    : romfs_file(std::move(file)),
+      read_ahead(std::make_unique<ReadAhead>([this](u64 offset, std::size_t length, u8* buffer) {
+          // Reads ahead may go past the end, which not every RomFSReader accepts
+          const std::size_t size = romfs_file->GetSize();
+          if (offset >= size) {
+              return std::size_t{0};
+          }
+          return romfs_file->ReadFile(offset, std::min<std::size_t>(length, size - offset), buffer);
+      })) {
     delay_generator = std::move(delay_generator_);
 }
 
 ResultVal<std::size_t> IVFCFile::Read(const u64 offset, const std::size_t length,
                                       u8* buffer) const {
     LOG_TRACE(Service_FS, "called offset={}, length={}", offset, length);
-    return MakeResult<std::size_t>(romfs_file->ReadFile(offset, length, buffer));
+    return MakeResult<std::size_t>(read_ahead->Read(offset, length, buffer));
 }
 
 ResultVal<std::size_t> IVFCFile::Write(const u64 offset, const std::size_t length, const bool flush,
@@ -13,6 +13,7 @@
 #include "core/file_sys/archive_backend.h"
 #include "core/file_sys/directory_backend.h"
 #include "core/file_sys/file_backend.h"
+#include "core/file_sys/read_ahead.h"
 #include "core/file_sys/romfs_reader.h"
 #include "core/hle/result.h"
 
@@ -128,6 +129,7 @@ public:
 
 private:
     std::shared_ptr<RomFSReader> romfs_file;
+    std::unique_ptr<ReadAhead> read_ahead;
 };
 
 class IVFCDirectory : public DirectoryBackend {
@@ -6,12 +6,15 @@
 #include <cstring>
 #include "common/alignment.h"
 #include "common/assert.h"
+#include "common/common_funcs.h"
 #include "common/common_paths.h"
 #include "common/file_util.h"
+#include "common/hash.h"
 #include "common/string_util.h"
 #include "common/swap.h"
 #include "core/file_sys/layered_fs.h"
 #include "core/file_sys/patch.h"
+#include "core/loader/loader.h"
 
 namespace FileSys {
 
@@ -19,7 +22,9 @@ struct FileRelocationInfo {
     int type;                      // 0 - none, 1 - replaced / created, 2 - patched, 3 - removed
     u64 original_offset;           // Type 0. Offset is absolute
     std::string replace_file_path; // Type 1
-    std::vector<u8> patched_file;  // Type 2
+    std::vector<u8> patched_file;  // Type 2. Empty until first read when loaded from the cache
+    std::string patch_file_path;   // Type 2
+    u64 original_size;             // Type 2
     u64 size;                      // Relocated file size
 };
 struct LayeredFS::File {
@@ -51,15 +56,60 @@ struct FileMetadata {
 };
 static_assert(sizeof(FileMetadata) == 0x20, "Size of FileMetadata is not correct");
 
+// The metadata cache is a LayeredFSCacheHeader, followed by the rebuilt metadata, and then a
+// CachedFile with its path and source path for every file with data. data_hash covers everything
+// after the header.
+constexpr u32 CACHE_MAGIC = Loader::MakeMagic('L', 'F', 'S', 'C');
+constexpr u32 CACHE_VERSION = 1;
+
+struct LayeredFSCacheHeader {
+    u32_le magic;
+    u32_le version;
+    u64_le romfs_hash;
+    u64_le mods_hash;
+    u64_le data_hash;
+    u64_le metadata_size;
+    u64_le data_size;
+    u32_le num_files;
+    INSERT_PADDING_WORDS(1);
+};
+static_assert(sizeof(LayeredFSCacheHeader) == 0x38, "Size of LayeredFSCacheHeader is not correct");
+
+struct CachedFile {
+    u64_le data_offset;
+    u64_le original_offset;
+    u64_le original_size;
+    u64_le size;
+    u32_le type;
+    u32_le path_length;
+    u32_le source_path_length; // Replacement file for type 1, patch file for type 2
+    INSERT_PADDING_WORDS(1);
+};
+static_assert(sizeof(CachedFile) == 0x30, "Size of CachedFile is not correct");
+
+// Replacement files kept open by a LayeredFS
+constexpr std::size_t MAX_OPEN_FILES = 16;
+
 LayeredFS::LayeredFS(std::shared_ptr<RomFSReader> romfs_, std::string patch_path_,
-                     std::string patch_ext_path_, bool load_relocations)
+                     std::string patch_ext_path_, bool load_relocations, std::string cache_path_)
     : romfs(std::move(romfs_)), patch_path(std::move(patch_path_)),
-      patch_ext_path(std::move(patch_ext_path_)) {
+      patch_ext_path(std::move(patch_ext_path_)), cache_path(std::move(cache_path_)) {
 
     romfs->ReadFile(0, sizeof(header), reinterpret_cast<u8*>(&header));
 
     ASSERT_MSG(header.header_length == sizeof(header), "Header size is incorrect");
 
+    u64 romfs_hash = 0;
+    u64 mods_hash = 0;
+    if (!cache_path.empty()) {
+        romfs_hash = ComputeRomFSHash();
+        mods_hash = ComputeModsHash();
+        if (LoadCache(romfs_hash, mods_hash)) {
+            LOG_INFO(Service_FS, "LayeredFS loaded metadata from {}", cache_path);
+            return;
+        }
+    }
+
     // TODO: is root always the first directory in table?
     root.parent = &root;
     LoadDirectory(root, 0);
@@ -70,6 +120,10 @@ LayeredFS::LayeredFS(std::shared_ptr<RomFSReader> romfs_, std::string patch_path
     }
 
     RebuildMetadata();
+
+    if (!cache_path.empty()) {
+        SaveCache(romfs_hash, mods_hash);
+    }
 }
 
 LayeredFS::~LayeredFS() = default;
@@ -256,6 +310,8 @@ void LayeredFS::LoadExtRelocations() {
                 LOG_INFO(Service_FS, "LayeredFS patched file {}", file_path);
 
                 file.relocation.type = 2;
+                file.relocation.patch_file_path = entry.physicalName;
+                file.relocation.original_size = file.relocation.size;
                 file.relocation.size = buffer.size();
                 file.relocation.patched_file = std::move(buffer);
             } else {
@@ -481,6 +537,215 @@ void LayeredFS::RebuildMetadata() {
                 header.file_metadata_table.length);
 }
 
+namespace {
+/// Appends the path, size and modification time of everything in directory to fingerprint.
+void AppendDirectoryFingerprint(const std::string& directory, std::string& fingerprint) {
+    FileUtil::ForeachDirectoryEntry(
+        nullptr, directory,
+        [&fingerprint](u64* /*num_entries_out*/, const std::string& parent,
+                       const std::string& name) {
+            const std::string path = parent + name;
+            const bool is_directory = FileUtil::IsDirectory(path);
+            const u64 size = is_directory ? 0 : FileUtil::GetSize(path);
+            const s64 modification_time = FileUtil::GetModificationTime(path);
+            fingerprint += path;
+            fingerprint.push_back('\0');
+            fingerprint.append(reinterpret_cast<const char*>(&size), sizeof(size));
+            fingerprint.append(reinterpret_cast<const char*>(&modification_time),
+                               sizeof(modification_time));
+            if (is_directory) {
+                AppendDirectoryFingerprint(path + DIR_SEP, fingerprint);
+            }
+            return true;
+        });
+}
+} // Anonymous namespace
+
+u64 LayeredFS::ComputeRomFSHash() {
+    // The original header, hash tables and metadata tables identify the RomFS
+    std::vector<u8> original_metadata(header.file_data_offset);
+    romfs->ReadFile(0, original_metadata.size(), original_metadata.data());
+    return Common::ComputeHash64(original_metadata.data(), original_metadata.size());
+}
+
+u64 LayeredFS::ComputeModsHash() const {
+    std::string fingerprint;
+    for (const std::string& path : {patch_path, patch_ext_path}) {
+        fingerprint += path;
+        fingerprint.push_back('\0');
+        if (!path.empty() && FileUtil::IsDirectory(path)) {
+            AppendDirectoryFingerprint(path.back() == '/' || path.back() == '\\' ? path
+                                                                                  : path + DIR_SEP,
+                                       fingerprint);
+        }
+    }
+    return Common::ComputeHash64(fingerprint.data(), fingerprint.size());
+}
+
+bool LayeredFS::LoadCache(u64 romfs_hash, u64 mods_hash) {
+    if (!FileUtil::Exists(cache_path)) {
+        return false;
+    }
+
+    FileUtil::IOFile file(cache_path, "rb");
+    LayeredFSCacheHeader cache_header{};
+    if (file.ReadBytes(&cache_header, sizeof(cache_header)) != sizeof(cache_header) ||
+        cache_header.magic != CACHE_MAGIC || cache_header.version != CACHE_VERSION ||
+        cache_header.romfs_hash != romfs_hash || cache_header.mods_hash != mods_hash) {
+        return false;
+    }
+
+    std::vector<u8> data(file.GetSize() - sizeof(cache_header));
+    if (file.ReadBytes(data.data(), data.size()) != data.size() ||
+        Common::ComputeHash64(data.data(), data.size()) != cache_header.data_hash ||
+        cache_header.metadata_size < sizeof(RomFSHeader) ||
+        cache_header.metadata_size > data.size()) {
+        LOG_WARNING(Service_FS, "LayeredFS metadata cache {} is corrupted", cache_path);
+        return false;
+    }
+
+    std::vector<std::unique_ptr<File>> files;
+    std::map<u64, File*> offset_map;
+    std::size_t offset = cache_header.metadata_size;
+    for (u32 i = 0; i < cache_header.num_files; ++i) {
+        CachedFile entry;
+        if (data.size() - offset < sizeof(entry)) {
+            return false;
+        }
+        std::memcpy(&entry, data.data() + offset, sizeof(entry));
+        offset += sizeof(entry);
+        if (entry.type > 2 || data.size() - offset < entry.path_length ||
+            data.size() - offset - entry.path_length < entry.source_path_length ||
+            entry.data_offset + entry.size > cache_header.data_size) {
+            return false;
+        }
+
+        auto cached_file = std::make_unique<File>();
+        cached_file->path.assign(reinterpret_cast<const char*>(data.data() + offset),
+                                 entry.path_length);
+        offset += entry.path_length;
+        const std::string source_path(reinterpret_cast<const char*>(data.data() + offset),
+                                      entry.source_path_length);
+        offset += entry.source_path_length;
+
+        auto& relocation = cached_file->relocation;
+        relocation.type = entry.type;
+        relocation.original_offset = entry.original_offset;
+        relocation.original_size = entry.original_size;
+        relocation.size = entry.size;
+        if (relocation.type == 1) {
+            relocation.replace_file_path = source_path;
+        } else if (relocation.type == 2) {
+            relocation.patch_file_path = source_path;
+        }
+        cached_file->parent = &root;
+
+        offset_map.emplace(entry.data_offset, cached_file.get());
+        files.emplace_back(std::move(cached_file));
+    }
+
+    metadata.assign(data.begin(), data.begin() + cache_header.metadata_size);
+    current_data_offset = cache_header.data_size;
+    cached_files = std::move(files);
+    data_offset_map = std::move(offset_map);
+    return true;
+}
+
+void LayeredFS::SaveCache(u64 romfs_hash, u64 mods_hash) const {
+    std::vector<u8> data = metadata;
+    for (const auto& [data_offset, file] : data_offset_map) {
+        const auto& relocation = file->relocation;
+        std::string source_path;
+        if (relocation.type == 1) {
+            source_path = relocation.replace_file_path;
+        } else if (relocation.type == 2) {
+            source_path = relocation.patch_file_path;
+        }
+        CachedFile entry{};
+        entry.data_offset = data_offset;
+        entry.original_offset = relocation.original_offset;
+        entry.original_size = relocation.original_size;
+        entry.size = relocation.size;
+        entry.type = relocation.type;
+        entry.path_length = static_cast<u32>(file->path.size());
+        entry.source_path_length = static_cast<u32>(source_path.size());
+
+        const auto* entry_bytes = reinterpret_cast<const u8*>(&entry);
+        data.insert(data.end(), entry_bytes, entry_bytes + sizeof(entry));
+        data.insert(data.end(), file->path.begin(), file->path.end());
+        data.insert(data.end(), source_path.begin(), source_path.end());
+    }
+
+    LayeredFSCacheHeader cache_header{};
+    cache_header.magic = CACHE_MAGIC;
+    cache_header.version = CACHE_VERSION;
+    cache_header.romfs_hash = romfs_hash;
+    cache_header.mods_hash = mods_hash;
+    cache_header.data_hash = Common::ComputeHash64(data.data(), data.size());
+    cache_header.metadata_size = metadata.size();
+    cache_header.data_size = current_data_offset;
+    cache_header.num_files = static_cast<u32>(data_offset_map.size());
+
+    // Written under another name first, so that an interrupted write never leaves a valid cache
+    const std::string temp_path = cache_path + ".tmp";
+    if (!FileUtil::CreateFullPath(cache_path)) {
+        return;
+    }
+    {
+        FileUtil::IOFile file(temp_path, "wb");
+        if (file.WriteObject(cache_header) != 1 ||
+            file.WriteBytes(data.data(), data.size()) != data.size()) {
+            LOG_ERROR(Service_FS, "LayeredFS could not write metadata cache {}", temp_path);
+            file.Close();
+            FileUtil::Delete(temp_path);
+            return;
+        }
+    }
+    FileUtil::Delete(cache_path);
+    if (!FileUtil::Rename(temp_path, cache_path)) {
+        FileUtil::Delete(temp_path);
+    }
+}
+
+void LayeredFS::LoadPatchedFile(File& file) {
+    auto& relocation = file.relocation;
+    std::vector<u8> buffer(relocation.original_size);
+    romfs->ReadFile(relocation.original_offset, buffer.size(), buffer.data());
+
+    FileUtil::IOFile patch_file(relocation.patch_file_path, "rb");
+    std::vector<u8> patch(patch_file.GetSize());
+    bool ret = patch_file.ReadBytes(patch.data(), patch.size()) == patch.size();
+    if (ret) {
+        const auto& path = relocation.patch_file_path;
+        ret = path.substr(path.size() - 4) == ".ips" ? Patch::ApplyIpsPatch(patch, buffer)
+                                                      : Patch::ApplyBpsPatch(patch, buffer);
+    }
+    if (!ret || buffer.size() != relocation.size) {
+        LOG_ERROR(Service_FS, "LayeredFS failed to patch file {}", file.path);
+        buffer.resize(relocation.size);
+    }
+    relocation.patched_file = std::move(buffer);
+}
+
+FileUtil::IOFile* LayeredFS::OpenReplacementFile(const File& file) {
+    const auto it = std::find_if(open_files.begin(), open_files.end(),
+                                 [&file](const auto& entry) { return entry.first == &file; });
+    if (it != open_files.end()) {
+        open_files.splice(open_files.begin(), open_files, it);
+        return &open_files.front().second;
+    }
+
+    FileUtil::IOFile replace_file(file.relocation.replace_file_path, "rb");
+    if (!replace_file) {
+        return nullptr;
+    }
+    if (open_files.size() == MAX_OPEN_FILES) {
+        open_files.pop_back();
+    }
+    open_files.emplace_front(&file, std::move(replace_file));
+    return &open_files.front().second;
+}
+
 std::size_t LayeredFS::GetSize() const {
     return metadata.size() + current_data_offset;
 }
@@ -488,6 +753,7 @@ std::size_t LayeredFS::GetSize() const {
 std::size_t LayeredFS::ReadFile(std::size_t offset, std::size_t length, u8* buffer) {
     ASSERT_MSG(offset + length <= GetSize(), "Out of bound");
 
+    std::lock_guard lock{mutex};
     std::size_t read_size = 0;
     if (offset < metadata.size()) {
         // First read the metadata
@@ -520,15 +786,17 @@ std::size_t LayeredFS::ReadFile(std::size_t offset, std::size_t length, u8* buff
             romfs->ReadFile(relocation.original_offset + relative_offset, to_read,
                             buffer + read_size);
         } else if (relocation.type == 1) { // replace
-            FileUtil::IOFile replace_file(relocation.replace_file_path, "rb");
-            if (replace_file) {
-                replace_file.Seek(relative_offset, SEEK_SET);
-                replace_file.ReadBytes(buffer + read_size, to_read);
+            if (auto* replace_file = OpenReplacementFile(*current->second)) {
+                replace_file->Seek(relative_offset, SEEK_SET);
+                replace_file->ReadBytes(buffer + read_size, to_read);
             } else {
                 LOG_ERROR(Service_FS, "Could not open replacement file for {}",
                           current->second->path);
             }
         } else if (relocation.type == 2) { // patch
+            if (relocation.patched_file.size() != relocation.size) {
+                LoadPatchedFile(*current->second);
+            }
             std::memcpy(buffer + read_size, relocation.patched_file.data() + relative_offset,
                         to_read);
         } else {
@@ -4,12 +4,15 @@
 
 #pragma once
 
+#include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
 #include "common/common_types.h"
+#include "common/file_util.h"
 #include "common/swap.h"
 #include "core/file_sys/romfs_reader.h"
 
@@ -37,11 +40,15 @@ static_assert(sizeof(RomFSHeader) == 0x28, "Size of RomFSHeader is not correct")
  * patch_ext_path: Path for RomFS extensions. Files present in this path:
  *  - When with an extension of ".stub", remove the corresponding file in the RomFS.
  *  - When with an extension of ".ips" or ".bps", patch the file in the RomFS.
+ * cache_path: Optional file to keep the rebuilt metadata in. It is reused as long as the RomFS
+ * and the paths, sizes and modification times of everything in the patch paths are unchanged.
+ * A LayeredFS loaded from the cache has no directory tree, so it can't be dumped.
  */
 class LayeredFS : public RomFSReader {
 public:
     explicit LayeredFS(std::shared_ptr<RomFSReader> romfs, std::string patch_path,
-                       std::string patch_ext_path, bool load_relocations = true);
+                       std::string patch_ext_path, bool load_relocations = true,
+                       std::string cache_path = "");
     ~LayeredFS() override;
 
     std::size_t GetSize() const override;
@@ -92,9 +99,24 @@ private:
 
     void RebuildMetadata();
 
+    // Identify the RomFS and the contents of the patch paths, for the metadata cache
+    u64 ComputeRomFSHash();
+    u64 ComputeModsHash() const;
+
+    // Load the rebuilt metadata and relocations from the cache. Returns false if it is outdated.
+    bool LoadCache(u64 romfs_hash, u64 mods_hash);
+    void SaveCache(u64 romfs_hash, u64 mods_hash) const;
+
+    // Apply the patch of a patched file loaded from the cache
+    void LoadPatchedFile(File& file);
+
+    // Open the replacement file of a file, keeping the most recently used ones open
+    FileUtil::IOFile* OpenReplacementFile(const File& file);
+
     std::shared_ptr<RomFSReader> romfs;
     std::string patch_path;
     std::string patch_ext_path;
+    std::string cache_path;
 
     RomFSHeader header;
     Directory root;
@@ -102,6 +124,10 @@ private:
     std::unordered_map<std::string, Directory*> directory_path_map;
     std::map<u64, File*> data_offset_map; // assigned data offset -> file
     std::vector<u8> metadata;             // Includes header, hash table and metadata
+    std::vector<std::unique_ptr<File>> cached_files; // files loaded from the cache
+
+    std::mutex mutex; // Protects what ReadFile changes
+    std::list<std::pair<const File*, FileUtil::IOFile>> open_files; // most recently used first
 
     // Used for rebuilding header
     std::vector<u32_le> directory_hash_table;
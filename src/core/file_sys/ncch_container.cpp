@@ -2,13 +2,17 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <cinttypes>
 #include <cstring>
+#include <iterator>
 #include <memory>
 #include <cryptopp/aes.h>
 #include <cryptopp/modes.h>
 #include <cryptopp/sha.h>
+#include "common/common_paths.h"
 #include "common/common_types.h"
+#include "common/hash.h"
 #include "common/logging/log.h"
 #include "core/core.h"
 #include "core/file_sys/layered_fs.h"
@@ -17,6 +21,7 @@
 #include "core/file_sys/seed_db.h"
 #include "core/hw/aes/key.h"
 #include "core/loader/loader.h"
+#include "core/settings.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // FileSys namespace
@@ -468,6 +473,30 @@ Loader::ResultStatus NCCHContainer::LoadSectionExeFS(const char* name, std::vect
     if (!exefs_file.IsOpen())
         return Loader::ResultStatus::Error;
 
+    if (Settings::values.cache_decrypted_content && is_encrypted && !is_tainted) {
+        // Only booting a title fills the cache, and not e.g. reading its icon for the game list
+        if (!cached_exefs && std::strcmp(name, ".code") == 0) {
+            LoadExeFSCache();
+        }
+        if (cached_exefs) {
+            const auto it = cached_exefs->find(name);
+            if (it != cached_exefs->end()) {
+                // .code is only loaded once, so don't keep a copy of it around
+                if (it->first == ".code") {
+                    buffer = std::move(it->second);
+                    cached_exefs->erase(it);
+                } else {
+                    buffer = it->second;
+                }
+                return Loader::ResultStatus::Success;
+            }
+        }
+    }
+
+    return ReadExeFSSection(name, buffer);
+}
+
+Loader::ResultStatus NCCHContainer::ReadExeFSSection(const char* name, std::vector<u8>& buffer) {
     LOG_DEBUG(Service_FS, "{} sections:", kMaxSections);
     // Iterate through the ExeFs archive until we find a section with the specified name...
     for (unsigned section_number = 0; section_number < kMaxSections; section_number++) {
@@ -493,35 +522,59 @@ Loader::ResultStatus NCCHContainer::LoadSectionExeFS(const char* name, std::vect
                                                               exefs_ctr.data());
             dec.Seek(section.offset + sizeof(ExeFs_Header));
 
+            // Read the section straight out of a mapping of the file where possible
+            const FileUtil::MappedFile mapping(exefs_file);
+            const u8* mapped_section = nullptr;
+            if (mapping.IsOpen() &&
+                static_cast<u64>(section_offset) + section.size <= mapping.GetSize()) {
+                mapping.Advise(section_offset, section.size,
+                               FileUtil::MappedFile::AccessHint::Sequential);
+                mapped_section = mapping.Data() + section_offset;
+            }
+            // Reads the section into dest, decrypting it if needed
+            const auto read_section = [&](u8* dest) {
+                if (mapped_section) {
+                    if (is_encrypted) {
+                        dec.ProcessData(dest, mapped_section, section.size);
+                    } else {
+                        std::memcpy(dest, mapped_section, section.size);
+                    }
+                    return true;
+                }
+                if (exefs_file.ReadBytes(dest, section.size) != section.size)
+                    return false;
+                if (is_encrypted) {
+                    dec.ProcessData(dest, dest, section.size);
+                }
+                return true;
+            };
+
             if (strcmp(section.name, ".code") == 0 && is_compressed) {
                 // Section is compressed, read compressed .code section...
+                const u8* compressed = mapped_section;
                 std::unique_ptr<u8[]> temp_buffer;
-                try {
-                    temp_buffer.reset(new u8[section.size]);
-                } catch (std::bad_alloc&) {
-                    return Loader::ResultStatus::ErrorMemoryAllocationFailed;
-                }
-
-                if (exefs_file.ReadBytes(&temp_buffer[0], section.size) != section.size)
-                    return Loader::ResultStatus::Error;
+                if (!compressed || is_encrypted) {
+                    try {
+                        temp_buffer.reset(new u8[section.size]);
+                    } catch (std::bad_alloc&) {
+                        return Loader::ResultStatus::ErrorMemoryAllocationFailed;
+                    }
 
-                if (is_encrypted) {
-                    dec.ProcessData(&temp_buffer[0], &temp_buffer[0], section.size);
+                    if (!read_section(&temp_buffer[0]))
+                        return Loader::ResultStatus::Error;
+                    compressed = &temp_buffer[0];
                 }
 
                 // Decompress .code section...
-                u32 decompressed_size = LZSS_GetDecompressedSize(&temp_buffer[0], section.size);
+                u32 decompressed_size = LZSS_GetDecompressedSize(compressed, section.size);
                 buffer.resize(decompressed_size);
-                if (!LZSS_Decompress(&temp_buffer[0], section.size, &buffer[0], decompressed_size))
+                if (!LZSS_Decompress(compressed, section.size, &buffer[0], decompressed_size))
                     return Loader::ResultStatus::ErrorInvalidFormat;
             } else {
                 // Section is uncompressed...
                 buffer.resize(section.size);
-                if (exefs_file.ReadBytes(&buffer[0], section.size) != section.size)
+                if (!read_section(&buffer[0]))
                     return Loader::ResultStatus::Error;
-                if (is_encrypted) {
-                    dec.ProcessData(&buffer[0], &buffer[0], section.size);
-                }
             }
 
             return Loader::ResultStatus::Success;
@@ -530,6 +583,44 @@ Loader::ResultStatus NCCHContainer::LoadSectionExeFS(const char* name, std::vect
     return Loader::ResultStatus::ErrorNotUsed;
 }
 
+void NCCHContainer::LoadExeFSCache() {
+    const std::string cache_dir =
+        FileUtil::GetUserPath(FileUtil::UserPath::CacheDir) + "content" DIR_SEP;
+    // The ExeFS header holds the hashes of the sections, so together with the NCCH header it
+    // identifies the exact content
+    std::vector<u8> headers(sizeof(ncch_header) + sizeof(exefs_header));
+    std::memcpy(headers.data(), &ncch_header, sizeof(ncch_header));
+    std::memcpy(headers.data() + sizeof(ncch_header), &exefs_header, sizeof(exefs_header));
+    const u64 content_hash = Common::ComputeHash64(headers.data(), headers.size());
+
+    cached_exefs = ReadContentCache(cache_dir, ncch_header.program_id, content_hash);
+    if (cached_exefs) {
+        LOG_INFO(Service_FS, "Loaded the decrypted ExeFS of {:016X} from the content cache",
+                 ncch_header.program_id);
+        return;
+    }
+
+    ExeFSSections sections;
+    for (const auto& section : exefs_header.section) {
+        const std::string section_name(section.name,
+                                       std::find(section.name, std::end(section.name), '\0'));
+        if (section_name.empty()) {
+            continue;
+        }
+        std::vector<u8> data;
+        if (ReadExeFSSection(section_name.c_str(), data) != Loader::ResultStatus::Success) {
+            return;
+        }
+        sections.emplace(section_name, std::move(data));
+    }
+    const u64 size_limit = u64{Settings::values.content_cache_size_mb} << 20;
+    if (WriteContentCache(cache_dir, ncch_header.program_id, content_hash, sections, size_limit)) {
+        LOG_INFO(Service_FS, "Stored the decrypted ExeFS of {:016X} in the content cache",
+                 ncch_header.program_id);
+    }
+    cached_exefs = std::move(sections);
+}
+
 Loader::ResultStatus NCCHContainer::ApplyCodePatch(std::vector<u8>& code) const {
     struct PatchLocation {
         std::string path;
@@ -655,8 +746,11 @@ Loader::ResultStatus NCCHContainer::ReadRomFS(std::shared_ptr<RomFSReader>& romf
     if (use_layered_fs &&
         (FileUtil::Exists(path + "romfs/") || FileUtil::Exists(path + "romfs_ext/"))) {
 
+        const auto cache_path = fmt::format("{}layeredfs/{:016X}.bin",
+                                            FileUtil::GetUserPath(FileUtil::UserPath::CacheDir),
+                                            ncch_header.program_id);
         romfs_file = std::make_shared<LayeredFS>(std::move(direct_romfs), path + "romfs/",
-                                                 path + "romfs_ext/");
+                                                 path + "romfs_ext/", true, cache_path);
     } else {
         romfs_file = std::move(direct_romfs);
     }
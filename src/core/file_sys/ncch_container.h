@@ -6,6 +6,7 @@
 
 #include <cstddef>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 #include "common/bit_field.h"
@@ -13,6 +14,7 @@
 #include "common/file_util.h"
 #include "common/swap.h"
 #include "core/core.h"
+#include "core/file_sys/content_cache.h"
 #include "core/file_sys/romfs_reader.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -310,6 +312,17 @@ public:
     ExHeader_Header exheader_header;
 
 private:
+    /**
+     * Reads a section out of the ExeFS, decrypting and decompressing it as needed
+     * @param name Name of section to read out of the ExeFS
+     * @param buffer Vector to read data into
+     * @return ResultStatus result of function
+     */
+    Loader::ResultStatus ReadExeFSSection(const char* name, std::vector<u8>& buffer);
+
+    /// Loads the decrypted ExeFS from the content cache, or fills the cache if it isn't there
+    void LoadExeFSCache();
+
     bool has_header = false;
     bool has_exheader = false;
     bool has_exefs = false;
@@ -333,6 +346,9 @@ private:
     std::string filepath;
     FileUtil::IOFile file;
     FileUtil::IOFile exefs_file;
+
+    /// Decrypted ExeFS sections from the content cache, if loaded
+    std::optional<ExeFSSections> cached_exefs;
 };
 
 } // namespace FileSys
@@ -0,0 +1,188 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <thread>
+#include "common/thread.h"
+#include "core/file_sys/read_ahead.h"
+
+namespace FileSys {
+
+namespace {
+/// Amount of data read ahead of each sequentially read file
+constexpr std::size_t READ_AHEAD_SIZE = 0x100000;
+/// Files read ahead at the same time. Any more are read synchronously.
+constexpr std::size_t MAX_BUFFERS = 8;
+
+/// Thread running all background reads, and the pool of buffers they read into.
+class IOWorker {
+public:
+    static IOWorker& Instance() {
+        static IOWorker worker;
+        return worker;
+    }
+
+    ~IOWorker() {
+        {
+            std::lock_guard lock{mutex};
+            stop_requested = true;
+        }
+        jobs_available.notify_one();
+        thread.join();
+    }
+
+    void Push(std::function<void()> job) {
+        {
+            std::lock_guard lock{mutex};
+            jobs.push_back(std::move(job));
+        }
+        jobs_available.notify_one();
+    }
+
+    /// Takes a buffer from the pool, or returns an empty one if all are in use.
+    std::vector<u8> AcquireBuffer() {
+        std::lock_guard lock{mutex};
+        if (free_buffers.empty()) {
+            if (num_buffers == MAX_BUFFERS) {
+                return {};
+            }
+            ++num_buffers;
+            return std::vector<u8>(READ_AHEAD_SIZE);
+        }
+        std::vector<u8> buffer = std::move(free_buffers.back());
+        free_buffers.pop_back();
+        return buffer;
+    }
+
+    void ReleaseBuffer(std::vector<u8> buffer) {
+        std::lock_guard lock{mutex};
+        free_buffers.push_back(std::move(buffer));
+    }
+
+private:
+    IOWorker() : thread(&IOWorker::ThreadMain, this) {}
+
+    void ThreadMain() {
+        Common::SetCurrentThreadName("FileSys_ReadAhead");
+        std::unique_lock lock{mutex};
+        while (true) {
+            jobs_available.wait(lock, [this] { return stop_requested || !jobs.empty(); });
+            if (jobs.empty()) {
+                return;
+            }
+            std::function<void()> job = std::move(jobs.front());
+            jobs.pop_front();
+            lock.unlock();
+            job();
+            lock.lock();
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable jobs_available;
+    std::deque<std::function<void()>> jobs;
+    bool stop_requested = false;
+
+    std::vector<std::vector<u8>> free_buffers;
+    std::size_t num_buffers = 0;
+
+    std::thread thread;
+};
+} // Anonymous namespace
+
+ReadAhead::ReadAhead(ReadFunction read) : read(std::move(read)) {}
+
+ReadAhead::~ReadAhead() {
+    Invalidate();
+}
+
+std::size_t ReadAhead::Read(u64 offset, std::size_t length, u8* buffer) {
+    std::unique_lock lock{mutex};
+    WaitForPrefetch(lock);
+
+    const u64 prefetch_end = prefetch_offset + prefetch_size;
+    std::size_t copied = 0;
+    if (offset >= prefetch_offset && offset < prefetch_end) {
+        copied = std::min<std::size_t>(length, prefetch_end - offset);
+        std::memcpy(buffer, prefetch_data.data() + (offset - prefetch_offset), copied);
+    } else if (offset != next_offset) {
+        // The game moved elsewhere in the file
+        DropPrefetch();
+    }
+    if (copied < length) {
+        copied += read(offset + copied, length - copied, buffer + copied);
+    }
+
+    const bool sequential = offset == next_offset;
+    next_offset = offset + copied;
+    // Keep at least half a buffer ahead of the game, unless the end of the file was reached
+    const u64 end = offset + length;
+    const bool at_end = prefetch_reached_end && end >= prefetch_offset;
+    if (sequential && copied == length && !at_end &&
+        (end < prefetch_offset || end + READ_AHEAD_SIZE / 2 > prefetch_offset + prefetch_size)) {
+        StartPrefetch(end);
+    }
+    return copied;
+}
+
+void ReadAhead::Wait() {
+    std::unique_lock lock{mutex};
+    WaitForPrefetch(lock);
+}
+
+void ReadAhead::Invalidate() {
+    std::unique_lock lock{mutex};
+    WaitForPrefetch(lock);
+    DropPrefetch();
+    next_offset = ~0ULL;
+}
+
+void ReadAhead::WaitForPrefetch(std::unique_lock<std::mutex>& lock) {
+    prefetch_done.wait(lock, [this] { return !prefetch_pending; });
+}
+
+void ReadAhead::DropPrefetch() {
+    prefetch_size = 0;
+    prefetch_reached_end = false;
+    if (!prefetch_data.empty()) {
+        IOWorker::Instance().ReleaseBuffer(std::move(prefetch_data));
+        prefetch_data.clear();
+    }
+}
+
+void ReadAhead::StartPrefetch(u64 offset) {
+    if (prefetch_data.empty()) {
+        prefetch_data = IOWorker::Instance().AcquireBuffer();
+        if (prefetch_data.empty()) {
+            return;
+        }
+    }
+
+    // Keep what was already read past the offset and only read the rest
+    const u64 prefetch_end = prefetch_offset + prefetch_size;
+    std::size_t kept = 0;
+    if (offset >= prefetch_offset && offset < prefetch_end) {
+        kept = static_cast<std::size_t>(prefetch_end - offset);
+        std::memmove(prefetch_data.data(), prefetch_data.data() + (offset - prefetch_offset),
+                     kept);
+    }
+    prefetch_offset = offset;
+    prefetch_size = kept;
+    prefetch_pending = true;
+
+    IOWorker::Instance().Push([this, offset, kept] {
+        const std::size_t size =
+            read(offset + kept, READ_AHEAD_SIZE - kept, prefetch_data.data() + kept);
+        // Notify with the lock held, as the waiting thread may destroy this once it is released
+        std::lock_guard lock{mutex};
+        prefetch_size = kept + size;
+        prefetch_reached_end = size < READ_AHEAD_SIZE - kept;
+        prefetch_pending = false;
+        prefetch_done.notify_all();
+    });
+}
+
+} // namespace FileSys
@@ -0,0 +1,63 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <vector>
+#include "common/common_types.h"
+
+namespace FileSys {
+
+/**
+ * Reads a file ahead of the game when it is read sequentially. Once a read continues where the
+ * previous one ended, the data following it is read on a background I/O thread, so that the next
+ * read is served from memory. Games stream large assets in chunks and wait for the emulated read
+ * delay between them, which is the time the host I/O now overlaps with.
+ *
+ * The read function is never called concurrently by the same ReadAhead, but it may be called from
+ * the I/O thread. Anything else that uses the underlying file must call Wait or Invalidate first.
+ */
+class ReadAhead {
+public:
+    /// Reads up to length bytes at offset into buffer, returning the number of bytes read.
+    using ReadFunction = std::function<std::size_t(u64 offset, std::size_t length, u8* buffer)>;
+
+    explicit ReadAhead(ReadFunction read);
+    ~ReadAhead();
+
+    std::size_t Read(u64 offset, std::size_t length, u8* buffer);
+
+    /// Waits until the underlying file is no longer being read in the background.
+    void Wait();
+
+    /// Waits like Wait, then drops the data read ahead. Must be called when the file changed.
+    void Invalidate();
+
+private:
+    void WaitForPrefetch(std::unique_lock<std::mutex>& lock);
+    void DropPrefetch();
+    void StartPrefetch(u64 offset);
+
+    ReadFunction read;
+
+    std::mutex mutex;
+    std::condition_variable prefetch_done;
+    bool prefetch_pending = false;
+    /// Offset of the data read ahead
+    u64 prefetch_offset = 0;
+    /// Number of valid bytes in prefetch_data
+    std::size_t prefetch_size = 0;
+    /// Whether the data read ahead ends at the end of the file
+    bool prefetch_reached_end = false;
+    /// Buffer from the shared pool, or empty if this file holds none
+    std::vector<u8> prefetch_data;
+    /// Where the last read ended, to detect sequential reads
+    u64 next_offset = ~0ULL;
+};
+
+} // namespace FileSys
@@ -1,22 +1,117 @@
 #include <algorithm>
+#include <cstring>
+#include <iterator>
 #include <cryptopp/aes.h>
 #include <cryptopp/modes.h>
 #include "core/file_sys/romfs_reader.h"
 
 namespace FileSys {
 
+namespace {
+// Decrypting a whole block at once lets Crypto++ process many AES blocks in parallel
+constexpr std::size_t CACHE_BLOCK_SIZE = 0x10000;
+constexpr std::size_t MAX_CACHED_BLOCKS = 16;
+// Mapped reads of at least this size ask the OS to read the whole range in at once
+constexpr std::size_t MAPPED_READ_AHEAD_SIZE = 0x10000;
+} // Anonymous namespace
+
 std::size_t DirectRomFSReader::ReadFile(std::size_t offset, std::size_t length, u8* buffer) {
     if (length == 0)
         return 0; // Crypto++ does not like zero size buffer
-    file.Seek(file_offset + offset, SEEK_SET);
-    std::size_t read_length = std::min(length, data_size - offset);
-    read_length = file.ReadBytes(buffer, read_length);
-    if (is_encrypted) {
+    std::lock_guard lock{mutex};
+    if (offset >= data_size)
+        return 0;
+    const std::size_t read_length = std::min(length, data_size - offset);
+    if (!is_encrypted) {
+        return ReadRaw(offset, read_length, buffer);
+    }
+
+    // Large reads are unlikely to be repeated, so they bypass the cache
+    if (read_length >= CACHE_BLOCK_SIZE) {
+        return ReadDecrypted(offset, read_length, buffer);
+    }
+
+    std::size_t copied = 0;
+    while (copied < read_length) {
+        const std::size_t position = offset + copied;
+        const CachedBlock* block = GetBlock(position / CACHE_BLOCK_SIZE);
+        if (block == nullptr) {
+            break; // The file is shorter than expected, or could not be read
+        }
+        const std::size_t block_offset = position % CACHE_BLOCK_SIZE;
+        const std::size_t size = std::min(read_length - copied, block->data.size() - block_offset);
+        std::memcpy(buffer + copied, block->data.data() + block_offset, size);
+        copied += size;
+    }
+    return copied;
+}
+
+std::size_t DirectRomFSReader::ReadRaw(std::size_t offset, std::size_t length, u8* buffer) {
+    if (!mapping.IsOpen()) {
+        file.Seek(file_offset + offset, SEEK_SET);
+        return file.ReadBytes(buffer, length);
+    }
+    const std::size_t read_length = GetMappedLength(offset, length);
+    std::memcpy(buffer, mapping.Data() + file_offset + offset, read_length);
+    return read_length;
+}
+
+std::size_t DirectRomFSReader::GetMappedLength(std::size_t offset, std::size_t length) const {
+    const u64 position = file_offset + offset;
+    if (position >= mapping.GetSize()) {
+        return 0;
+    }
+    const std::size_t read_length =
+        static_cast<std::size_t>(std::min<u64>(length, mapping.GetSize() - position));
+    if (read_length >= MAPPED_READ_AHEAD_SIZE) {
+        mapping.Advise(position, read_length, FileUtil::MappedFile::AccessHint::WillNeed);
+    }
+    return read_length;
+}
+
+std::size_t DirectRomFSReader::ReadDecrypted(std::size_t offset, std::size_t length, u8* buffer) {
+    // Mapped data is decrypted straight out of the mapping, without being copied first
+    const u8* source = buffer;
+    std::size_t read_length;
+    if (mapping.IsOpen()) {
+        read_length = GetMappedLength(offset, length);
+        source = mapping.Data() + file_offset + offset;
+    } else {
+        read_length = ReadRaw(offset, length, buffer);
+    }
+    if (read_length != 0) {
         CryptoPP::CTR_Mode<CryptoPP::AES>::Decryption d(key.data(), key.size(), ctr.data());
         d.Seek(crypto_offset + offset);
-        d.ProcessData(buffer, buffer, read_length);
+        d.ProcessData(buffer, source, read_length);
     }
     return read_length;
 }
 
+const DirectRomFSReader::CachedBlock* DirectRomFSReader::GetBlock(std::size_t index) {
+    const auto it =
+        std::find_if(cached_blocks.begin(), cached_blocks.end(),
+                     [index](const CachedBlock& block) { return block.index == index; });
+    if (it != cached_blocks.end()) {
+        cached_blocks.splice(cached_blocks.begin(), cached_blocks, it);
+        return &cached_blocks.front();
+    }
+
+    // Reuse the buffer of the least recently used block
+    if (cached_blocks.size() < MAX_CACHED_BLOCKS) {
+        cached_blocks.emplace_front();
+    } else {
+        cached_blocks.splice(cached_blocks.begin(), cached_blocks, std::prev(cached_blocks.end()));
+    }
+    CachedBlock& block = cached_blocks.front();
+    block.index = index;
+    const std::size_t offset = index * CACHE_BLOCK_SIZE;
+    block.data.resize(std::min(CACHE_BLOCK_SIZE, data_size - offset));
+    if (ReadDecrypted(offset, block.data.size(), block.data.data()) != block.data.size()) {
+        // Don't keep an incomplete block around, a later read of it may well succeed
+        cached_blocks.pop_front();
+        return nullptr;
+    }
+    return &block;
+}
+
 } // namespace FileSys
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <array>
+#include <list>
+#include <mutex>
+#include <vector>
 #include "common/common_types.h"
 #include "common/file_util.h"
 
@@ -18,19 +21,21 @@ public:
 };
 
 /**
- * A RomFS reader that directly reads the RomFS file.
+ * A RomFS reader that directly reads the RomFS file, through a memory mapping if possible.
+ * Encrypted data is decrypted in blocks which are kept in a small cache, as games tend to make many
+ * small reads close to each other. Reads may come from several threads.
  */
 class DirectRomFSReader : public RomFSReader {
 public:
     DirectRomFSReader(FileUtil::IOFile&& file, std::size_t file_offset, std::size_t data_size)
-        : is_encrypted(false), file(std::move(file)), file_offset(file_offset),
-          data_size(data_size) {}
+        : is_encrypted(false), file(std::move(file)), mapping(this->file),
+          file_offset(file_offset), data_size(data_size) {}
 
     DirectRomFSReader(FileUtil::IOFile&& file, std::size_t file_offset, std::size_t data_size,
                       const std::array<u8, 16>& key, const std::array<u8, 16>& ctr,
                       std::size_t crypto_offset)
-        : is_encrypted(true), file(std::move(file)), key(key), ctr(ctr), file_offset(file_offset),
-          crypto_offset(crypto_offset), data_size(data_size) {}
+        : is_encrypted(true), file(std::move(file)), mapping(this->file), key(key), ctr(ctr),
+          file_offset(file_offset), crypto_offset(crypto_offset), data_size(data_size) {}
 
     ~DirectRomFSReader() override = default;
 
@@ -41,13 +46,37 @@ public:
     std::size_t ReadFile(std::size_t offset, std::size_t length, u8* buffer) override;
 
 private:
+    struct CachedBlock {
+        std::size_t index;
+        std::vector<u8> data;
+    };
+
+    /// Reads the data as stored in the file.
+    std::size_t ReadRaw(std::size_t offset, std::size_t length, u8* buffer);
+
+    /// Returns how much of a range is in the mapped file.
+    std::size_t GetMappedLength(std::size_t offset, std::size_t length) const;
+
+    /// Reads and decrypts the data.
+    std::size_t ReadDecrypted(std::size_t offset, std::size_t length, u8* buffer);
+
+    /// Gets a decrypted block, reading it if it isn't cached. Returns nullptr if the block could
+    /// not be read completely.
+    const CachedBlock* GetBlock(std::size_t index);
+
     bool is_encrypted;
     FileUtil::IOFile file;
+    /// Used instead of the file if it could be mapped
+    FileUtil::MappedFile mapping;
     std::array<u8, 16> key;
     std::array<u8, 16> ctr;
     std::size_t file_offset;
     std::size_t crypto_offset;
     std::size_t data_size;
+
+    std::mutex mutex;
+    /// Most recently used blocks first
+    std::list<CachedBlock> cached_blocks;
 };
 
 } // namespace FileSys
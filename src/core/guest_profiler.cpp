@@ -0,0 +1,194 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <ctime>
+#include <vector>
+#include <fmt/chrono.h>
+#include <fmt/format.h>
+#include "common/assert.h"
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "core/arm/arm_interface.h"
+#include "core/core.h"
+#include "core/core_timing.h"
+#include "core/guest_profiler.h"
+#include "core/hle/kernel/kernel.h"
+#include "core/hle/kernel/process.h"
+#include "core/hle/kernel/thread.h"
+
+namespace Core {
+
+namespace {
+/// Returns the entries of a histogram sorted by descending count.
+std::vector<std::pair<std::string, u64>> SortByCount(
+    const std::unordered_map<std::string, u64>& histogram) {
+    std::vector<std::pair<std::string, u64>> entries(histogram.begin(), histogram.end());
+    std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    });
+    return entries;
+}
+} // Anonymous namespace
+
+GuestProfiler::GuestProfiler() = default;
+
+GuestProfiler::~GuestProfiler() = default;
+
+void GuestProfiler::StartSampling(System& system, u32 samples_per_second) {
+    ASSERT(samples_per_second != 0);
+    sample_interval = std::max<s64>(1, BASE_CLOCK_RATE_ARM11 / samples_per_second);
+
+    Timing& timing = system.CoreTiming();
+    sample_event = timing.RegisterEvent(
+        "GuestProfiler::Sample", [this, &system](u64 userdata, s64 cycles_late) {
+            const auto core_id = static_cast<std::size_t>(userdata);
+            SampleCore(system, core_id);
+            system.CoreTiming().ScheduleEvent(sample_interval - cycles_late, sample_event,
+                                              userdata, core_id);
+        });
+    for (std::size_t core_id = 0; core_id < system.GetNumCores(); ++core_id) {
+        timing.ScheduleEvent(sample_interval, sample_event, core_id, core_id);
+    }
+    LOG_INFO(Core, "Sampling guest code {} times per second", samples_per_second);
+}
+
+void GuestProfiler::SampleCore(System& system, std::size_t core_id) {
+    const auto* thread =
+        system.Kernel().GetThreadManager(static_cast<u32>(core_id)).GetCurrentThread();
+    if (thread == nullptr || thread->owner_process == nullptr) {
+        AddIdleSample();
+        return;
+    }
+
+    const ARM_Interface& core = system.GetCore(static_cast<u32>(core_id));
+    const Kernel::Process& process = *thread->owner_process;
+    AddSample(process.process_id, process.codeset->name, thread->thread_id, core.GetPC(),
+              core.GetReg(14));
+}
+
+void GuestProfiler::AddSymbol(u32 process_id, VAddr address, u32 size, std::string name) {
+    std::lock_guard lock{mutex};
+    symbols[process_id][address] = Symbol{size, std::move(name)};
+}
+
+void GuestProfiler::RemoveSymbols(u32 process_id, VAddr address, u32 size) {
+    std::lock_guard lock{mutex};
+    const auto it = symbols.find(process_id);
+    if (it == symbols.end()) {
+        return;
+    }
+    auto& process_symbols = it->second;
+    process_symbols.erase(process_symbols.lower_bound(address),
+                          process_symbols.lower_bound(address + size));
+}
+
+void GuestProfiler::AddSample(u32 process_id, const std::string& process_name, u32 thread_id,
+                              VAddr pc, VAddr lr) {
+    std::lock_guard lock{mutex};
+    ProcessProfile& profile = profiles[process_id];
+    if (profile.total_samples++ == 0) {
+        profile.name = process_name;
+    }
+    ++profile.pc_samples[pc];
+    ++profile.edge_samples[{lr, pc}];
+    ++profile.thread_samples[thread_id];
+}
+
+void GuestProfiler::AddIdleSample() {
+    std::lock_guard lock{mutex};
+    ++idle_samples;
+}
+
+std::string GuestProfiler::Symbolize(u32 process_id, VAddr address) const {
+    const auto process_it = symbols.find(process_id);
+    if (process_it != symbols.end()) {
+        const auto& process_symbols = process_it->second;
+        auto it = process_symbols.upper_bound(address);
+        if (it != process_symbols.begin()) {
+            --it;
+            if (address - it->first < it->second.size) {
+                return it->second.name;
+            }
+        }
+    }
+    return fmt::format("0x{:08X}", address);
+}
+
+void GuestProfiler::AppendProcessReport(std::string& report, u32 process_id,
+                                        const ProcessProfile& profile,
+                                        std::size_t max_entries) const {
+    const auto percent = [&profile](u64 count) {
+        return 100.0 * static_cast<double>(count) / static_cast<double>(profile.total_samples);
+    };
+
+    report += fmt::format("\nProcess {} \"{}\": {} samples\n", process_id, profile.name,
+                          profile.total_samples);
+
+    report += "  Threads:\n";
+    for (const auto& [thread_id, count] : profile.thread_samples) {
+        report += fmt::format("    {:>10} {:6.2f}%  thread {}\n", count, percent(count), thread_id);
+    }
+
+    std::unordered_map<std::string, u64> functions;
+    for (const auto& [pc, count] : profile.pc_samples) {
+        functions[Symbolize(process_id, pc)] += count;
+    }
+    report += "  Flat profile:\n";
+    const auto sorted_functions = SortByCount(functions);
+    for (std::size_t i = 0; i < std::min(max_entries, sorted_functions.size()); ++i) {
+        const auto& [name, count] = sorted_functions[i];
+        report += fmt::format("    {:>10} {:6.2f}%  {}\n", count, percent(count), name);
+    }
+
+    // The return address points behind the call, so look up the byte before it instead. Bit 0
+    // only marks calls from Thumb code.
+    std::unordered_map<std::string, u64> edges;
+    for (const auto& [edge, count] : profile.edge_samples) {
+        const VAddr call_site = (edge.first & ~1u) - 1;
+        edges[fmt::format("{} -> {}", Symbolize(process_id, call_site),
+                          Symbolize(process_id, edge.second))] += count;
+    }
+    report += "  Call graph (caller -> function):\n";
+    const auto sorted_edges = SortByCount(edges);
+    for (std::size_t i = 0; i < std::min(max_entries, sorted_edges.size()); ++i) {
+        const auto& [name, count] = sorted_edges[i];
+        report += fmt::format("    {:>10} {:6.2f}%  {}\n", count, percent(count), name);
+    }
+}
+
+std::string GuestProfiler::GetReport(std::size_t max_entries) const {
+    std::lock_guard lock{mutex};
+
+    u64 total_samples = idle_samples;
+    for (const auto& [process_id, profile] : profiles) {
+        total_samples += profile.total_samples;
+    }
+
+    std::string report = fmt::format("Guest profile: {} samples, {} idle\n", total_samples,
+                                     idle_samples);
+    for (const auto& [process_id, profile] : profiles) {
+        AppendProcessReport(report, process_id, profile, max_entries);
+    }
+    return report;
+}
+
+std::string GuestProfiler::WriteReport(u64 title_id) const {
+    constexpr std::size_t MaxReportEntries = 100;
+
+    const std::time_t t = std::time(nullptr);
+    const std::string& path = FileUtil::GetUserPath(FileUtil::UserPath::LogDir);
+    // %F Date format expanded is "%Y-%m-%d"
+    const std::string filename =
+        fmt::format("{}/{:%F-%H-%M}_{:016X}_profile.txt", path, *std::localtime(&t), title_id);
+    FileUtil::IOFile file(filename, "w");
+    const std::string report = GetReport(MaxReportEntries);
+    if (file.WriteString(report) != report.size()) {
+        LOG_ERROR(Core, "Failed to write the guest profile to {}", filename);
+        return "";
+    }
+    return filename;
+}
+
+} // namespace Core
@@ -0,0 +1,87 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include "common/common_types.h"
+
+namespace Core {
+
+class System;
+struct TimingEventType;
+
+/**
+ * Statistical profiler for guest code. While sampling is running, the PC and LR of each core are
+ * recorded at a fixed rate of emulated time together with the thread running on it, and aggregated
+ * per process. Samples are attributed to functions using the symbols registered by the loaders
+ * (ELF symbol tables and the named exports of CROs), falling back to the raw address.
+ *
+ * The call graph is built from LR alone, so it is only accurate for samples taken in leaf
+ * functions. It is meant to find the hot spots of a title, not to replace a real profiler.
+ */
+class GuestProfiler {
+public:
+    GuestProfiler();
+    ~GuestProfiler();
+
+    /// Starts sampling every core of the system the given number of times per emulated second.
+    void StartSampling(System& system, u32 samples_per_second);
+
+    /// Registers a symbol of a process covering size bytes from address.
+    void AddSymbol(u32 process_id, VAddr address, u32 size, std::string name);
+
+    /// Removes all symbols of a process that start in the given range, e.g. on unloading a CRO.
+    void RemoveSymbols(u32 process_id, VAddr address, u32 size);
+
+    /// Records a sample of a core that was running the given thread.
+    void AddSample(u32 process_id, const std::string& process_name, u32 thread_id, VAddr pc,
+                   VAddr lr);
+
+    /// Records a sample of a core that had no thread to run.
+    void AddIdleSample();
+
+    /// Returns the flat and call graph report, listing at most max_entries lines per table.
+    std::string GetReport(std::size_t max_entries) const;
+
+    /// Writes the report to a file in the log directory. Returns the path, or "" on failure.
+    std::string WriteReport(u64 title_id) const;
+
+private:
+    struct Symbol {
+        u32 size;
+        std::string name;
+    };
+
+    struct ProcessProfile {
+        std::string name;
+        u64 total_samples = 0;
+        std::unordered_map<VAddr, u64> pc_samples;
+        /// Samples by (return address, PC)
+        std::map<std::pair<VAddr, VAddr>, u64> edge_samples;
+        std::map<u32, u64> thread_samples;
+    };
+
+    void SampleCore(System& system, std::size_t core_id);
+
+    /// Returns the name of the function containing address, or the address itself if unknown.
+    std::string Symbolize(u32 process_id, VAddr address) const;
+
+    void AppendProcessReport(std::string& report, u32 process_id, const ProcessProfile& profile,
+                             std::size_t max_entries) const;
+
+    mutable std::mutex mutex;
+    std::unordered_map<u32, std::map<VAddr, Symbol>> symbols;
+    std::map<u32, ProcessProfile> profiles;
+    u64 idle_samples = 0;
+
+    TimingEventType* sample_event = nullptr;
+    s64 sample_interval = 0;
+};
+
+} // namespace Core
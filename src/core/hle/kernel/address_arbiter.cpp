@@ -19,50 +19,56 @@ namespace Kernel {
 void AddressArbiter::WaitThread(std::shared_ptr<Thread> thread, VAddr wait_address) {
     thread->wait_address = wait_address;
     thread->status = ThreadStatus::WaitArb;
-    waiting_threads.emplace_back(std::move(thread));
+    waiting_threads[wait_address].emplace_back(std::move(thread));
 }
 
 void AddressArbiter::ResumeAllThreads(VAddr address) {
-    // Determine which threads are waiting on this address, those should be woken up.
-    auto itr = std::stable_partition(waiting_threads.begin(), waiting_threads.end(),
-                                     [address](const auto& thread) {
-                                         ASSERT_MSG(thread->status == ThreadStatus::WaitArb,
-                                                    "Inconsistent AddressArbiter state");
-                                         return thread->wait_address != address;
-                                     });
-
-    // Wake up all the found threads
-    std::for_each(itr, waiting_threads.end(), [](auto& thread) { thread->ResumeFromWait(); });
-
-    // Remove the woken up threads from the wait list.
-    waiting_threads.erase(itr, waiting_threads.end());
+    auto list = waiting_threads.find(address);
+    if (list == waiting_threads.end())
+        return;
+
+    // Wake up all the threads waiting on this address and drop their list
+    std::vector<std::shared_ptr<Thread>> threads = std::move(list->second);
+    waiting_threads.erase(list);
+    for (auto& thread : threads) {
+        ASSERT_MSG(thread->status == ThreadStatus::WaitArb, "Inconsistent AddressArbiter state");
+        thread->ResumeFromWait();
+    }
 }
 
-std::shared_ptr<Thread> AddressArbiter::ResumeHighestPriorityThread(VAddr address) {
-    // Determine which threads are waiting on this address, those should be considered for wakeup.
-    auto matches_start = std::stable_partition(
-        waiting_threads.begin(), waiting_threads.end(), [address](const auto& thread) {
-            ASSERT_MSG(thread->status == ThreadStatus::WaitArb,
-                       "Inconsistent AddressArbiter state");
-            return thread->wait_address != address;
-        });
+void AddressArbiter::ResumeHighestPriorityThreads(VAddr address, u32 count) {
+    auto list = waiting_threads.find(address);
+    if (list == waiting_threads.end())
+        return;
+    auto& threads = list->second;
 
     // Iterate through threads, find highest priority thread that is waiting to be arbitrated.
     // Note: The real kernel will pick the first thread in the list if more than one have the
     // same highest priority value. Lower priority values mean higher priority.
-    auto itr = std::min_element(matches_start, waiting_threads.end(),
-                                [](const auto& lhs, const auto& rhs) {
-                                    return lhs->current_priority < rhs->current_priority;
-                                });
-
-    if (itr == waiting_threads.end())
-        return nullptr;
+    for (u32 i = 0; i < count && !threads.empty(); ++i) {
+        auto itr = std::min_element(threads.begin(), threads.end(),
+                                    [](const auto& lhs, const auto& rhs) {
+                                        return lhs->current_priority < rhs->current_priority;
+                                    });
+        ASSERT_MSG((*itr)->status == ThreadStatus::WaitArb, "Inconsistent AddressArbiter state");
+        (*itr)->ResumeFromWait();
+        threads.erase(itr);
+    }
 
-    auto thread = *itr;
-    thread->ResumeFromWait();
+    if (threads.empty()) {
+        waiting_threads.erase(list);
+    }
+}
 
-    waiting_threads.erase(itr);
-    return thread;
+void AddressArbiter::RemoveWaitingThread(const std::shared_ptr<Thread>& thread) {
+    auto list = waiting_threads.find(thread->wait_address);
+    if (list == waiting_threads.end())
+        return;
+    auto& threads = list->second;
+    threads.erase(std::remove(threads.begin(), threads.end(), thread), threads.end());
+    if (threads.empty()) {
+        waiting_threads.erase(list);
+    }
 }
 
 AddressArbiter::AddressArbiter(KernelSystem& kernel) : Object(kernel), kernel(kernel) {}
@@ -83,8 +89,7 @@ ResultCode AddressArbiter::ArbitrateAddress(std::shared_ptr<Thread> thread, Arbi
                                    std::shared_ptr<WaitObject> object) {
         ASSERT(reason == ThreadWakeupReason::Timeout);
         // Remove the newly-awakened thread from the Arbiter's waiting list.
-        waiting_threads.erase(std::remove(waiting_threads.begin(), waiting_threads.end(), thread),
-                              waiting_threads.end());
+        RemoveWaitingThread(thread);
     };
 
     switch (type) {
@@ -96,8 +101,7 @@ ResultCode AddressArbiter::ArbitrateAddress(std::shared_ptr<Thread> thread, Arbi
             ResumeAllThreads(address);
         } else {
             // Resume first N threads
-            for (int i = 0; i < value; i++)
-                ResumeHighestPriorityThread(address);
+            ResumeHighestPriorityThreads(address, static_cast<u32>(value));
         }
         break;
 
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <memory>
+#include <unordered_map>
 #include <vector>
 #include "common/common_types.h"
 #include "core/hle/kernel/object.h"
@@ -61,12 +62,16 @@ private:
     /// Resume all threads found to be waiting on the address under this address arbiter
     void ResumeAllThreads(VAddr address);
 
-    /// Resume one thread found to be waiting on the address under this address arbiter and return
-    /// the resumed thread.
-    std::shared_ptr<Thread> ResumeHighestPriorityThread(VAddr address);
+    /// Resume up to count threads waiting on the address under this address arbiter, in order of
+    /// priority.
+    void ResumeHighestPriorityThreads(VAddr address, u32 count);
 
-    /// Threads waiting for the address arbiter to be signaled.
-    std::vector<std::shared_ptr<Thread>> waiting_threads;
+    /// Removes a thread whose wait has timed out from the wait list.
+    void RemoveWaitingThread(const std::shared_ptr<Thread>& thread);
+
+    /// Threads waiting for the address arbiter to be signaled, by the address they wait on. Each
+    /// list is in the order the threads started waiting.
+    std::unordered_map<VAddr, std::vector<std::shared_ptr<Thread>>> waiting_threads;
 };
 
 } // namespace Kernel
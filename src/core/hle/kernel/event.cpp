@@ -6,6 +6,7 @@
 #include <map>
 #include <vector>
 #include "common/assert.h"
+#include "common/slab_allocator.h"
 #include "core/hle/kernel/event.h"
 #include "core/hle/kernel/kernel.h"
 #include "core/hle/kernel/thread.h"
@@ -16,7 +17,7 @@ Event::Event(KernelSystem& kernel) : WaitObject(kernel) {}
 Event::~Event() {}
 
 std::shared_ptr<Event> KernelSystem::CreateEvent(ResetType reset_type, std::string name) {
-    auto evt{std::make_shared<Event>(*this)};
+    auto evt{Common::MakeSlabShared<Event>(*this)};
 
     evt->signaled = false;
     evt->reset_type = reset_type;
@@ -36,22 +36,31 @@ void SessionRequestHandler::ClientDisconnected(std::shared_ptr<ServerSession> se
 std::shared_ptr<Event> HLERequestContext::SleepClientThread(const std::string& reason,
                                                             std::chrono::nanoseconds timeout,
                                                             WakeupCallback&& callback) {
+    client_thread_sleeping = true;
+
+    // The context has to outlive the request. A pooled context is kept alive by the callback
+    // instead of being recycled, any other one is copied.
+    std::shared_ptr<HLERequestContext> context = weak_from_this().lock();
+    if (context == nullptr) {
+        context = std::make_shared<HLERequestContext>(*this);
+    }
+
     // Put the client thread to sleep until the wait event is signaled or the timeout expires.
-    thread->wakeup_callback = [context = *this,
+    thread->wakeup_callback = [context = std::move(context),
                                callback](ThreadWakeupReason reason, std::shared_ptr<Thread> thread,
                                          std::shared_ptr<WaitObject> object) mutable {
         ASSERT(thread->status == ThreadStatus::WaitHleEvent);
-        callback(thread, context, reason);
+        callback(thread, *context, reason);
 
         auto& process = thread->owner_process;
         // We must copy the entire command buffer *plus* the entire static buffers area, since
         // the translation might need to read from it in order to retrieve the StaticBuffer
         // target addresses.
         std::array<u32_le, IPC::COMMAND_BUFFER_LENGTH + 2 * IPC::MAX_STATIC_BUFFERS> cmd_buff;
-        Memory::MemorySystem& memory = context.kernel.memory;
+        Memory::MemorySystem& memory = context->kernel.memory;
         memory.ReadBlock(*process, thread->GetCommandBufferAddress(), cmd_buff.data(),
                          cmd_buff.size() * sizeof(u32));
-        context.WriteToOutgoingCommandBuffer(cmd_buff.data(), *process);
+        context->WriteToOutgoingCommandBuffer(cmd_buff.data(), *process);
         // Copy the translated command buffer back into the thread's command buffer area.
         memory.WriteBlock(*process, thread->GetCommandBufferAddress(), cmd_buff.data(),
                           cmd_buff.size() * sizeof(u32));
@@ -76,6 +85,18 @@ HLERequestContext::HLERequestContext(KernelSystem& kernel, std::shared_ptr<Serve
 
 HLERequestContext::~HLERequestContext() = default;
 
+void HLERequestContext::Reset(std::shared_ptr<ServerSession> session, Thread* thread) {
+    this->session = std::move(session);
+    this->thread = thread;
+    cmd_buf[0] = 0;
+    client_thread_sleeping = false;
+    request_handles.clear();
+    request_mapped_buffers.clear();
+    for (auto& buffer : static_buffers) {
+        buffer.clear();
+    }
+}
+
 std::shared_ptr<Object> HLERequestContext::GetIncomingHandle(u32 id_from_cmdbuf) const {
     ASSERT(id_from_cmdbuf < request_handles.size());
     return request_handles[id_from_cmdbuf];
@@ -94,7 +115,11 @@ const std::vector<u8>& HLERequestContext::GetStaticBuffer(u8 buffer_id) const {
     return static_buffers[buffer_id];
 }
 
-void HLERequestContext::AddStaticBuffer(u8 buffer_id, std::vector<u8> data) {
+void HLERequestContext::AddStaticBuffer(u8 buffer_id, const std::vector<u8>& data) {
+    static_buffers[buffer_id].assign(data.begin(), data.end());
+}
+
+void HLERequestContext::AddStaticBuffer(u8 buffer_id, std::vector<u8>&& data) {
     static_buffers[buffer_id] = std::move(data);
 }
 
@@ -148,11 +173,11 @@ ResultCode HLERequestContext::PopulateFromIncomingCommandBuffer(const u32_le* sr
             VAddr source_address = src_cmdbuf[i];
             IPC::StaticBufferDescInfo buffer_info{descriptor};
 
-            // Copy the input buffer into our own vector and store it.
-            std::vector<u8> data(buffer_info.size);
+            // Copy the input buffer into our own vector, reusing its memory if possible.
+            std::vector<u8>& data = static_buffers[buffer_info.buffer_id];
+            data.resize(buffer_info.size);
             kernel.memory.ReadBlock(src_process, source_address, data.data(), data.size());
 
-            AddStaticBuffer(buffer_info.buffer_id, std::move(data));
             cmd_buf[i++] = source_address;
             break;
         }
@@ -255,6 +280,22 @@ ResultCode HLERequestContext::WriteToOutgoingCommandBuffer(u32_le* dst_cmdbuf,
     return RESULT_SUCCESS;
 }
 
+std::size_t HLERequestContext::GetStaticBufferBytes() const {
+    std::size_t bytes = 0;
+    for (const auto& buffer : static_buffers) {
+        bytes += buffer.size();
+    }
+    return bytes;
+}
+
+std::size_t HLERequestContext::GetMappedBufferBytes() const {
+    std::size_t bytes = 0;
+    for (const auto& buffer : request_mapped_buffers) {
+        bytes += buffer.GetSize();
+    }
+    return bytes;
+}
+
 MappedBuffer& HLERequestContext::GetMappedBuffer(u32 id_from_cmdbuf) {
     ASSERT_MSG(id_from_cmdbuf < request_mapped_buffers.size(), "Mapped Buffer ID out of range!");
     return request_mapped_buffers[id_from_cmdbuf];
@@ -266,6 +307,28 @@ void HLERequestContext::ReportUnimplemented() const {
     }
 }
 
+std::shared_ptr<HLERequestContext> KernelSystem::AcquireRequestContext(
+    std::shared_ptr<ServerSession> session, Thread* thread) {
+    if (request_context_pool.empty()) {
+        return std::make_shared<HLERequestContext>(*this, std::move(session), thread);
+    }
+    std::shared_ptr<HLERequestContext> context = std::move(request_context_pool.back());
+    request_context_pool.pop_back();
+    context->Reset(std::move(session), thread);
+    return context;
+}
+
+void KernelSystem::ReleaseRequestContext(std::shared_ptr<HLERequestContext> context) {
+    // Enough for every core to have a request in flight, including nested ones
+    constexpr std::size_t MaxPooledContexts = 16;
+    if (context.use_count() != 1 || request_context_pool.size() >= MaxPooledContexts) {
+        return;
+    }
+    // Drop the references to the objects of the finished request right away
+    context->Reset(nullptr, nullptr);
+    request_context_pool.push_back(std::move(context));
+}
+
 MappedBuffer::MappedBuffer(Memory::MemorySystem& memory, const Process& process, u32 descriptor,
                            VAddr address, u32 id)
     : memory(&memory), id(id), address(address), process(&process) {
@@ -286,4 +349,14 @@ void MappedBuffer::Write(const void* src_buffer, std::size_t offset, std::size_t
     memory->WriteBlock(*process, address + static_cast<VAddr>(offset), src_buffer, size);
 }
 
+std::vector<Memory::MemorySpan> MappedBuffer::GetSpans(std::size_t offset, std::size_t size,
+                                                       std::optional<Memory::FlushMode> mode) {
+    if (mode) {
+        ASSERT(*mode == Memory::FlushMode::Invalidate || (perms & IPC::R));
+        ASSERT(*mode == Memory::FlushMode::Flush || (perms & IPC::W));
+    }
+    ASSERT(offset + size <= this->size);
+    return memory->GetSpans(*process, address + static_cast<VAddr>(offset), size, mode);
+}
+
 } // namespace Kernel
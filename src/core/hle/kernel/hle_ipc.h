@@ -8,6 +8,7 @@
 #include <array>
 #include <chrono>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 #include <boost/container/small_vector.hpp>
@@ -23,7 +24,9 @@ class ServiceFrameworkBase;
 
 namespace Memory {
 class MemorySystem;
-}
+struct MemorySpan;
+enum class FlushMode;
+} // namespace Memory
 
 namespace Kernel {
 
@@ -104,6 +107,10 @@ public:
     // interface for service
     void Read(void* dest_buffer, std::size_t offset, std::size_t size);
     void Write(const void* src_buffer, std::size_t offset, std::size_t size);
+    /// Gets the guest memory of a part of the buffer for in-place access. See
+    /// Memory::MemorySystem::GetSpans.
+    std::vector<Memory::MemorySpan> GetSpans(std::size_t offset, std::size_t size,
+                                             std::optional<Memory::FlushMode> mode);
     std::size_t GetSize() const {
         return size;
     }
@@ -156,11 +163,17 @@ private:
  * id of the memory interface and let kernel convert it back to client vaddr. No real unmapping is
  * needed in this case, though.
  */
-class HLERequestContext {
+class HLERequestContext : public std::enable_shared_from_this<HLERequestContext> {
 public:
     HLERequestContext(KernelSystem& kernel, std::shared_ptr<ServerSession> session, Thread* thread);
     ~HLERequestContext();
 
+    /**
+     * Prepares a recycled context for a new request. All objects and buffers of the previous
+     * request are dropped, but the memory of the static buffers is kept for reuse.
+     */
+    void Reset(std::shared_ptr<ServerSession> session, Thread* thread);
+
     /// Returns a pointer to the IPC command buffer for this request.
     u32* CommandBuffer() {
         return cmd_buf.data();
@@ -219,9 +232,12 @@ public:
 
     /**
      * Sets up a static buffer that will be copied to the target process when the request is
-     * translated.
+     * translated. The data is copied into the memory the context already holds for the buffer.
      */
-    void AddStaticBuffer(u8 buffer_id, std::vector<u8> data);
+    void AddStaticBuffer(u8 buffer_id, const std::vector<u8>& data);
+
+    /// Sets up a static buffer by taking over a vector the caller no longer needs.
+    void AddStaticBuffer(u8 buffer_id, std::vector<u8>&& data);
 
     /**
      * Gets a memory interface by the id from the request command buffer. See the "HLE mapped buffer
@@ -237,6 +253,17 @@ public:
     /// Reports an unimplemented function.
     void ReportUnimplemented() const;
 
+    /// Returns the total size of the static buffers of the request and the reply.
+    std::size_t GetStaticBufferBytes() const;
+
+    /// Returns the total size of the mapped buffers of the request.
+    std::size_t GetMappedBufferBytes() const;
+
+    /// Returns whether SleepClientThread has been called for this request.
+    bool IsClientThreadSleeping() const {
+        return client_thread_sleeping;
+    }
+
 private:
     KernelSystem& kernel;
     std::array<u32, IPC::COMMAND_BUFFER_LENGTH> cmd_buf;
@@ -244,10 +271,12 @@ private:
     Thread* thread;
     // TODO(yuriks): Check common usage of this and optimize size accordingly
     boost::container::small_vector<std::shared_ptr<Object>, 8> request_handles;
-    // The static buffers will be created when the IPC request is translated.
+    // The static buffers will be filled when the IPC request is translated. Their memory is reused
+    // when the context is recycled.
     std::array<std::vector<u8>, IPC::MAX_STATIC_BUFFERS> static_buffers;
     // The mapped buffers will be created when the IPC request is translated
     boost::container::small_vector<MappedBuffer, 8> request_mapped_buffers;
+    bool client_thread_sleeping = false;
 };
 
 } // namespace Kernel
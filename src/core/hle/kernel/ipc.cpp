@@ -26,9 +26,10 @@ ResultCode TranslateCommandBuffer(Kernel::KernelSystem& kernel, Memory::MemorySy
     auto& src_process = src_thread->owner_process;
     auto& dst_process = dst_thread->owner_process;
 
-    IPC::Header header;
+    std::array<u32, IPC::COMMAND_BUFFER_LENGTH> cmd_buf;
     // TODO(Subv): Replace by Memory::Read32 when possible.
-    memory.ReadBlock(*src_process, src_address, &header.raw, sizeof(header.raw));
+    memory.ReadBlock(*src_process, src_address, cmd_buf.data(), sizeof(u32));
+    IPC::Header header{cmd_buf[0]};
 
     std::size_t untranslated_size = 1u + header.normal_params_size;
     std::size_t command_size = untranslated_size + header.translate_params_size;
@@ -36,8 +37,9 @@ ResultCode TranslateCommandBuffer(Kernel::KernelSystem& kernel, Memory::MemorySy
     // Note: The real kernel does not check that the command length fits into the IPC buffer area.
     ASSERT(command_size <= IPC::COMMAND_BUFFER_LENGTH);
 
-    std::array<u32, IPC::COMMAND_BUFFER_LENGTH> cmd_buf;
-    memory.ReadBlock(*src_process, src_address, cmd_buf.data(), command_size * sizeof(u32));
+    // The header has already been read
+    memory.ReadBlock(*src_process, src_address + sizeof(u32), cmd_buf.data() + 1,
+                     (command_size - 1) * sizeof(u32));
 
     const bool should_record = kernel.GetIPCRecorder().IsEnabled();
 
@@ -99,9 +101,6 @@ ResultCode TranslateCommandBuffer(Kernel::KernelSystem& kernel, Memory::MemorySy
             IPC::StaticBufferDescInfo bufferInfo{descriptor};
             VAddr static_buffer_src_address = cmd_buf[i];
 
-            std::vector<u8> data(bufferInfo.size);
-            memory.ReadBlock(*src_process, static_buffer_src_address, data.data(), data.size());
-
             // Grab the address that the target thread set up to receive the response static buffer
             // and write our data there. The static buffers area is located right after the command
             // buffer area.
@@ -121,10 +120,12 @@ ResultCode TranslateCommandBuffer(Kernel::KernelSystem& kernel, Memory::MemorySy
 
             // Note: The real kernel doesn't seem to have any error recovery mechanisms for this
             // case.
-            ASSERT_MSG(target_buffer.descriptor.size >= data.size(),
+            ASSERT_MSG(target_buffer.descriptor.size >= bufferInfo.size,
                        "Static buffer data is too big");
 
-            memory.WriteBlock(*dst_process, target_buffer.address, data.data(), data.size());
+            // Copied directly between the processes, without going through a temporary buffer
+            memory.CopyBlock(*dst_process, *src_process, target_buffer.address,
+                             static_buffer_src_address, bufferInfo.size);
 
             cmd_buf[i++] = target_buffer.address;
             break;
@@ -77,12 +77,20 @@ void KernelSystem::SetCurrentMemoryPageTable(Memory::PageTable* page_table) {
     }
 }
 
+void KernelSystem::UnregisterPageTable(Memory::PageTable* page_table) {
+    memory.UnregisterPageTable(page_table);
+    for (const auto& cpu : cpus) {
+        cpu->PageTableDestroyed(page_table);
+    }
+}
+
 void KernelSystem::SetCPUs(std::vector<std::shared_ptr<ARM_Interface>> cpus) {
     ASSERT(cpus.size() == thread_managers.size());
     u32 i = 0;
     for (const auto& cpu : cpus) {
         thread_managers[i++]->SetCPU(*cpu);
     }
+    this->cpus = std::move(cpus);
 }
 
 void KernelSystem::SetRunningCPU(std::shared_ptr<ARM_Interface> cpu) {
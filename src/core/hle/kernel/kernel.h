@@ -50,6 +50,7 @@ class ClientPort;
 class ServerPort;
 class ClientSession;
 class ServerSession;
+class HLERequestContext;
 class ResourceLimitList;
 class SharedMemory;
 class ThreadManager;
@@ -215,6 +216,9 @@ public:
 
     void SetCurrentMemoryPageTable(Memory::PageTable* page_table);
 
+    /// Unregisters a page table that is being destroyed and drops the code the CPUs translated.
+    void UnregisterPageTable(Memory::PageTable* page_table);
+
     void SetCPUs(std::vector<std::shared_ptr<ARM_Interface>> cpu);
 
     void SetRunningCPU(std::shared_ptr<ARM_Interface> cpu);
@@ -236,6 +240,16 @@ public:
     IPCDebugger::Recorder& GetIPCRecorder();
     const IPCDebugger::Recorder& GetIPCRecorder() const;
 
+    /**
+     * Gets a context for handling an HLE request. Contexts are recycled, so that handling a
+     * request does not allocate once their buffers have grown to the sizes used by the services.
+     */
+    std::shared_ptr<HLERequestContext> AcquireRequestContext(
+        std::shared_ptr<ServerSession> session, Thread* thread);
+
+    /// Returns a context to the pool, unless it is still kept alive by a sleeping client thread.
+    void ReleaseRequestContext(std::shared_ptr<HLERequestContext> context);
+
     MemoryRegionInfo* GetMemoryRegion(MemoryRegion region);
 
     void HandleSpecialMapping(VMManager& address_space, const AddressMapping& mapping);
@@ -267,6 +281,8 @@ private:
 
     std::function<void()> prepare_reschedule_callback;
 
+    std::vector<std::shared_ptr<ARM_Interface>> cpus;
+
     std::unique_ptr<ResourceLimitList> resource_limits;
     std::atomic<u32> next_object_id{0};
 
@@ -296,6 +312,8 @@ private:
 
     std::unique_ptr<IPCDebugger::Recorder> ipc_recorder;
 
+    std::vector<std::shared_ptr<HLERequestContext>> request_context_pool;
+
     u32 next_thread_id;
 };
 
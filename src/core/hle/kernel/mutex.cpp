@@ -5,6 +5,7 @@
 #include <map>
 #include <vector>
 #include "common/assert.h"
+#include "common/slab_allocator.h"
 #include "core/core.h"
 #include "core/hle/kernel/errors.h"
 #include "core/hle/kernel/kernel.h"
@@ -27,7 +28,7 @@ Mutex::Mutex(KernelSystem& kernel) : WaitObject(kernel), kernel(kernel) {}
 Mutex::~Mutex() {}
 
 std::shared_ptr<Mutex> KernelSystem::CreateMutex(bool initial_locked, std::string name) {
-    auto mutex{std::make_shared<Mutex>(*this)};
+    auto mutex{Common::MakeSlabShared<Mutex>(*this)};
 
     mutex->lock_count = 0;
     mutex->name = std::move(name);
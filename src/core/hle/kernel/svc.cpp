@@ -12,6 +12,7 @@
 #include "core/arm/arm_interface.h"
 #include "core/core.h"
 #include "core/core_timing.h"
+#include "core/cpu_threads.h"
 #include "core/hle/kernel/address_arbiter.h"
 #include "core/hle/kernel/client_port.h"
 #include "core/hle/kernel/client_session.h"
@@ -38,6 +39,7 @@
 #include "core/hle/lock.h"
 #include "core/hle/result.h"
 #include "core/hle/service/service.h"
+#include "core/settings.h"
 
 namespace Kernel {
 
@@ -164,6 +166,7 @@ private:
     ResultCode CancelTimer(Handle handle);
     void SleepThread(s64 nanoseconds);
     s64 GetSystemTick();
+    void SkipIdlePolling();
     ResultCode CreateMemoryBlock(Handle* out_handle, u32 addr, u32 size, u32 my_permission,
                                  u32 other_permission);
     ResultCode CreatePort(Handle* server_port, Handle* client_port, VAddr name_address,
@@ -474,12 +477,13 @@ ResultCode SVC::WaitSynchronizationN(s32* out, VAddr handles_address, s32 handle
     using ObjectPtr = std::shared_ptr<WaitObject>;
     std::vector<ObjectPtr> objects(handle_count);
 
+    const HandleTable& handle_table = kernel.GetCurrentProcess()->handle_table;
     for (int i = 0; i < handle_count; ++i) {
         Handle handle = memory.Read32(handles_address + i * sizeof(Handle));
-        auto object = kernel.GetCurrentProcess()->handle_table.Get<WaitObject>(handle);
+        auto object = handle_table.Get<WaitObject>(handle);
         if (object == nullptr)
             return ERR_INVALID_HANDLE;
-        objects[i] = object;
+        objects[i] = std::move(object);
     }
 
     if (wait_all) {
@@ -506,8 +510,9 @@ ResultCode SVC::WaitSynchronizationN(s32* out, VAddr handles_address, s32 handle
         thread->status = ThreadStatus::WaitSynchAll;
 
         // Add the thread to each of the objects' waiting threads.
+        const std::shared_ptr<Thread> shared_thread = SharedFrom(thread);
         for (auto& object : objects) {
-            object->AddWaitingThread(SharedFrom(thread));
+            object->AddWaitingThread(shared_thread);
         }
 
         thread->wait_objects = std::move(objects);
@@ -562,9 +567,9 @@ ResultCode SVC::WaitSynchronizationN(s32* out, VAddr handles_address, s32 handle
         thread->status = ThreadStatus::WaitSynchAny;
 
         // Add the thread to each of the objects' waiting threads.
-        for (std::size_t i = 0; i < objects.size(); ++i) {
-            WaitObject* object = objects[i].get();
-            object->AddWaitingThread(SharedFrom(thread));
+        const std::shared_ptr<Thread> shared_thread = SharedFrom(thread);
+        for (auto& object : objects) {
+            object->AddWaitingThread(shared_thread);
         }
 
         thread->wait_objects = std::move(objects);
@@ -723,9 +728,9 @@ ResultCode SVC::ReplyAndReceive(s32* index, VAddr handles_address, s32 handle_co
     thread->status = ThreadStatus::WaitSynchAny;
 
     // Add the thread to each of the objects' waiting threads.
-    for (std::size_t i = 0; i < objects.size(); ++i) {
-        WaitObject* object = objects[i].get();
-        object->AddWaitingThread(SharedFrom(thread));
+    const std::shared_ptr<Thread> shared_thread = SharedFrom(thread);
+    for (auto& object : objects) {
+        object->AddWaitingThread(shared_thread);
     }
 
     thread->wait_objects = std::move(objects);
@@ -1224,8 +1229,10 @@ void SVC::SleepThread(s64 nanoseconds) {
 
     // Don't attempt to yield execution if there are no available threads to run,
     // this way we avoid a useless reschedule to the idle thread.
-    if (nanoseconds == 0 && !thread_manager.HaveReadyThreads())
+    if (nanoseconds == 0 && !thread_manager.HaveReadyThreads()) {
+        SkipIdlePolling();
         return;
+    }
 
     // Sleep current thread and check for next thread to schedule
     thread_manager.WaitCurrentThread_Sleep();
@@ -1243,9 +1250,27 @@ s64 SVC::GetSystemTick() {
     // Advance time to defeat dumb games (like Cubic Ninja) that busy-wait for the frame to end.
     // Measured time between two calls on a 9.2 o3DS with Ninjhax 1.1b
     system.GetRunningCore().GetTimer()->AddTicks(150);
+    SkipIdlePolling();
     return result;
 }
 
+/// Skips the rest of the slice if the current thread repeats an SVC call that can't change
+/// anything, from the same place, with barely any work and no change to its loop state in between.
+/// Such a thread is polling for a result that nothing but the next event can change.
+void SVC::SkipIdlePolling() {
+    if (!Settings::values.skip_idle_loops) {
+        return;
+    }
+
+    Thread* thread = kernel.GetCurrentThreadManager().GetCurrentThread();
+    ARM_Interface& core = system.GetRunningCore();
+    const auto timer = core.GetTimer();
+    if (thread->RepeatsIdlePoll(core, timer->GetTicks())) {
+        timer->SkipIdleLoop();
+        core.PrepareReschedule();
+    }
+}
+
 /// Creates a memory block at the specified address with the specified permissions and size
 ResultCode SVC::CreateMemoryBlock(Handle* out_handle, u32 addr, u32 size, u32 my_permission,
                                   u32 other_permission) {
@@ -1583,6 +1608,12 @@ const SVC::FunctionDef* SVC::GetSVCInfo(u32 func_num) {
 MICROPROFILE_DEFINE(Kernel_SVC, "Kernel", "SVC", MP_RGB(70, 200, 70));
 
 void SVC::CallSVC(u32 immediate) {
+    // Cores running on their own host thread leave the kernel to the emulation thread
+    if (Core::CPUThreads::IsCoreThread()) {
+        Core::CPUThreads::RunOnEmulationThread([this, immediate] { CallSVC(immediate); });
+        return;
+    }
+
     MICROPROFILE_SCOPE(Kernel_SVC);
 
     // Lock the global kernel mutex when we enter the kernel HLE.
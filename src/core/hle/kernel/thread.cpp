@@ -10,6 +10,7 @@
 #include "common/common_types.h"
 #include "common/logging/log.h"
 #include "common/math_util.h"
+#include "common/slab_allocator.h"
 #include "core/arm/arm_interface.h"
 #include "core/arm/skyeye_common/armstate.h"
 #include "core/core.h"
@@ -44,7 +45,7 @@ Thread* ThreadManager::GetCurrentThread() const {
 
 void Thread::Stop() {
     // Cancel any outstanding wakeup events for this thread
-    thread_manager.kernel.timing.UnscheduleEvent(thread_manager.ThreadWakeupEventType, thread_id);
+    thread_manager.kernel.timing.UnscheduleEvent(wakeup_event);
     thread_manager.wakeup_callback_table.erase(thread_id);
 
     // Clean up thread from ready queue
@@ -97,7 +98,7 @@ void ThreadManager::SwitchContext(Thread* new_thread) {
                    "Thread must be ready to become running.");
 
         // Cancel any outstanding wakeup events for this thread
-        timing.UnscheduleEvent(ThreadWakeupEventType, new_thread->thread_id);
+        timing.UnscheduleEvent(new_thread->wakeup_event);
 
         auto previous_process = kernel.GetCurrentProcess();
 
@@ -114,6 +115,7 @@ void ThreadManager::SwitchContext(Thread* new_thread) {
         cpu->SetCP15Register(CP15_THREAD_URO, new_thread->GetTLSAddress());
     } else {
         current_thread = nullptr;
+        cpu->UnloadContext();
         // Note: We do not reset the current process and current page table when idling because
         // technically we haven't changed processes, our threads are just paused.
     }
@@ -180,8 +182,33 @@ void Thread::WakeAfterDelay(s64 nanoseconds) {
     if (nanoseconds == -1)
         return;
 
-    thread_manager.kernel.timing.ScheduleEvent(nsToCycles(nanoseconds),
-                                               thread_manager.ThreadWakeupEventType, thread_id);
+    Core::Timing& timing = thread_manager.kernel.timing;
+    timing.UnscheduleEvent(wakeup_event);
+    wakeup_event = timing.ScheduleEvent(nsToCycles(nanoseconds),
+                                        thread_manager.ThreadWakeupEventType, thread_id);
+}
+
+bool Thread::RepeatsIdlePoll(const ARM_Interface& core, u64 ticks) {
+    // Generous compared to the GetSystemTick adjustment and a short polling loop
+    constexpr u64 MAX_POLL_INTERVAL = 1000;
+
+    // A loop keeps its state in r4-r11, sp and the flags across SVC calls, while r0-r3 and r12
+    // only carry the arguments and results of the call itself. If the state changed in between,
+    // the thread did some work, e.g. one step of a loop with a time budget.
+    std::array<u32, 11> state;
+    for (int reg = 4; reg <= 11; ++reg) {
+        state[reg - 4] = core.GetReg(reg);
+    }
+    state[8] = core.GetReg(13);
+    state[9] = core.GetReg(14);
+    state[10] = core.GetCPSR();
+
+    const bool repeated = last_poll_address == state[9] && state == last_poll_state &&
+                          ticks - last_poll_ticks <= MAX_POLL_INTERVAL;
+    last_poll_address = state[9];
+    last_poll_ticks = ticks;
+    last_poll_state = state;
+    return repeated;
 }
 
 void Thread::ResumeFromWait() {
@@ -305,10 +332,9 @@ ResultVal<std::shared_ptr<Thread>> KernelSystem::CreateThread(std::string name,
                           ErrorSummary::InvalidArgument, ErrorLevel::Permanent);
     }
 
-    auto thread{std::make_shared<Thread>(*this, processor_id)};
+    auto thread{Common::MakeSlabShared<Thread>(*this, processor_id)};
 
     thread_managers[processor_id]->thread_list.push_back(thread);
-    thread_managers[processor_id]->ready_queue.prepare(priority);
 
     thread->thread_id = NewThreadId();
     thread->status = ThreadStatus::Dormant;
@@ -377,8 +403,6 @@ void Thread::SetPriority(u32 priority) {
     // If thread was ready, adjust queues
     if (status == ThreadStatus::Ready)
         thread_manager.ready_queue.move(this, current_priority, priority);
-    else
-        thread_manager.ready_queue.prepare(priority);
 
     nominal_priority = current_priority = priority;
 }
@@ -396,8 +420,6 @@ void Thread::BoostPriority(u32 priority) {
     // If thread was ready, adjust queues
     if (status == ThreadStatus::Ready)
         thread_manager.ready_queue.move(this, current_priority, priority);
-    else
-        thread_manager.ready_queue.prepare(priority);
     current_priority = priority;
 }
 
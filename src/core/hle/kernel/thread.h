@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <array>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -207,6 +208,15 @@ public:
      */
     void WakeAfterDelay(s64 nanoseconds);
 
+    /**
+     * Records an SVC call of this thread that found nothing to do
+     * @param core The core running this thread, which holds its registers at the call
+     * @param ticks The current CPU tick
+     * @returns Whether the call repeats the previous one from the same place, shortly after and
+     *          with the loop state unchanged, i.e. the thread is polling in a tight loop
+     */
+    bool RepeatsIdlePoll(const ARM_Interface& core, u64 ticks);
+
     /**
      * Sets the result after the thread awakens (from either WaitSynchronization SVC)
      * @param result Value to set to the returned result
@@ -271,6 +281,14 @@ public:
 
     u64 last_running_ticks; ///< CPU tick when thread was last running
 
+    Core::Timing::EventHandle wakeup_event; ///< Pending wakeup of the thread after a timeout
+
+    /// Return address, CPU tick and callee-saved registers and flags at the last SVC call that
+    /// found nothing to do, used to detect threads that poll in a tight loop
+    VAddr last_poll_address = 0;
+    u64 last_poll_ticks = 0;
+    std::array<u32, 11> last_poll_state{};
+
     s32 processor_id;
 
     VAddr tls_address; ///< Virtual address of the Thread Local Storage of the thread
@@ -6,6 +6,7 @@
 #include <unordered_map>
 #include "common/assert.h"
 #include "common/logging/log.h"
+#include "common/slab_allocator.h"
 #include "core/core.h"
 #include "core/hle/kernel/handle_table.h"
 #include "core/hle/kernel/object.h"
@@ -22,7 +23,7 @@ Timer::~Timer() {
 }
 
 std::shared_ptr<Timer> KernelSystem::CreateTimer(ResetType reset_type, std::string name) {
-    auto timer{std::make_shared<Timer>(*this)};
+    auto timer{Common::MakeSlabShared<Timer>(*this)};
 
     timer->reset_type = reset_type;
     timer->signaled = false;
@@ -57,13 +58,13 @@ void Timer::Set(s64 initial, s64 interval) {
         // Immediately invoke the callback
         Signal(0);
     } else {
-        kernel.timing.ScheduleEvent(nsToCycles(initial), timer_manager.timer_callback_event_type,
-                                    callback_id);
+        callback_event = kernel.timing.ScheduleEvent(
+            nsToCycles(initial), timer_manager.timer_callback_event_type, callback_id);
     }
 }
 
 void Timer::Cancel() {
-    kernel.timing.UnscheduleEvent(timer_manager.timer_callback_event_type, callback_id);
+    kernel.timing.UnscheduleEvent(callback_event);
 }
 
 void Timer::Clear() {
@@ -87,8 +88,9 @@ void Timer::Signal(s64 cycles_late) {
 
     if (interval_delay != 0) {
         // Reschedule the timer with the interval delay
-        kernel.timing.ScheduleEvent(nsToCycles(interval_delay) - cycles_late,
-                                    timer_manager.timer_callback_event_type, callback_id);
+        callback_event =
+            kernel.timing.ScheduleEvent(nsToCycles(interval_delay) - cycles_late,
+                                        timer_manager.timer_callback_event_type, callback_id);
     }
 }
 
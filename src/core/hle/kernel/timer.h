@@ -98,6 +98,8 @@ private:
 
     /// ID used as userdata to reference this object when inserting into the CoreTiming queue.
     u64 callback_id;
+    /// Pending event that fires the timer
+    Core::Timing::EventHandle callback_event;
 
     KernelSystem& kernel;
     TimerManager& timer_manager;
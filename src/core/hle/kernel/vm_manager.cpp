@@ -44,6 +44,7 @@ VMManager::~VMManager() = default;
 
 void VMManager::Reset() {
     vma_map.clear();
+    last_vma = vma_map.end();
 
     // Initialize the map with a single free region covering the entire managed space.
     VirtualMemoryArea initial_vma;
@@ -59,16 +60,21 @@ void VMManager::Reset() {
 VMManager::VMAHandle VMManager::FindVMA(VAddr target) const {
     if (target >= MAX_ADDRESS) {
         return vma_map.end();
-    } else {
-        return std::prev(vma_map.upper_bound(target));
     }
+
+    // Lookups tend to hit the same area repeatedly, e.g. while walking an IPC buffer
+    if (last_vma != vma_map.end() && target - last_vma->second.base < last_vma->second.size) {
+        return last_vma;
+    }
+    last_vma = std::prev(vma_map.upper_bound(target));
+    return last_vma;
 }
 
 ResultVal<VAddr> VMManager::MapBackingMemoryToBase(VAddr base, u32 region_size, u8* memory,
                                                    u32 size, MemoryState state) {
 
-    // Find the first Free VMA.
-    VMAHandle vma_handle = std::find_if(vma_map.begin(), vma_map.end(), [&](const auto& vma) {
+    // Find the first Free VMA. Those before the one containing the base all end before it.
+    VMAHandle vma_handle = std::find_if(FindVMA(base), vma_map.cend(), [&](const auto& vma) {
         if (vma.second.type != VMAType::Free)
             return false;
 
@@ -76,11 +82,15 @@ ResultVal<VAddr> VMManager::MapBackingMemoryToBase(VAddr base, u32 region_size,
         return vma_end > base && vma_end >= base + size;
     });
 
-    VAddr target = std::max(base, vma_handle->second.base);
-
     // Do not try to allocate the block if there are no available addresses within the desired
     // region.
-    if (vma_handle == vma_map.end() || target + size > base + region_size) {
+    if (vma_handle == vma_map.end()) {
+        return ResultCode(ErrorDescription::OutOfMemory, ErrorModule::Kernel,
+                          ErrorSummary::OutOfResource, ErrorLevel::Permanent);
+    }
+
+    VAddr target = std::max(base, vma_handle->second.base);
+    if (target + size > base + region_size) {
         return ResultCode(ErrorDescription::OutOfMemory, ErrorModule::Kernel,
                           ErrorSummary::OutOfResource, ErrorLevel::Permanent);
     }
@@ -154,11 +164,11 @@ ResultCode VMManager::ChangeMemoryState(VAddr target, u32 size, MemoryState expe
 
     const VMAIter end = vma_map.end();
     // The comparison against the end of the range must be done using addresses since VMAs can be
-    // merged during this process, causing invalidation of the iterators.
+    // merged during this process, causing invalidation of the iterators. The page table doesn't
+    // track states or permissions, so it is left as is.
     while (vma != end && vma->second.base < target_end) {
         vma->second.permissions = new_perms;
         vma->second.meminfo_state = new_state;
-        UpdatePageTableForVMA(vma->second);
         vma = std::next(MergeAdjacent(vma));
     }
 
@@ -174,8 +184,6 @@ VMManager::VMAIter VMManager::Unmap(VMAIter vma_handle) {
     vma.backing_memory = nullptr;
     vma.paddr = 0;
 
-    UpdatePageTableForVMA(vma);
-
     return MergeAdjacent(vma_handle);
 }
 
@@ -189,6 +197,8 @@ ResultCode VMManager::UnmapRange(VAddr target, u32 size) {
     while (vma != end && vma->second.base < target_end) {
         vma = std::next(Unmap(vma));
     }
+    // Update the pages of the whole range at once rather than VMA by VMA
+    memory.UnmapRegion(page_table, target, size);
 
     ASSERT(FindVMA(target)->second.size >= size);
     return RESULT_SUCCESS;
@@ -197,9 +207,8 @@ ResultCode VMManager::UnmapRange(VAddr target, u32 size) {
 VMManager::VMAHandle VMManager::Reprotect(VMAHandle vma_handle, VMAPermission new_perms) {
     VMAIter iter = StripIterConstness(vma_handle);
 
-    VirtualMemoryArea& vma = iter->second;
-    vma.permissions = new_perms;
-    UpdatePageTableForVMA(vma);
+    // The page table doesn't track permissions, so only the VMA needs to change
+    iter->second.permissions = new_perms;
 
     return MergeAdjacent(iter);
 }
@@ -333,6 +342,7 @@ VMManager::VMAIter VMManager::MergeAdjacent(VMAIter iter) {
     const VMAIter next_vma = std::next(iter);
     if (next_vma != vma_map.end() && iter->second.CanBeMergedWith(next_vma->second)) {
         iter->second.size += next_vma->second.size;
+        last_vma = vma_map.end();
         vma_map.erase(next_vma);
     }
 
@@ -340,6 +350,7 @@ VMManager::VMAIter VMManager::MergeAdjacent(VMAIter iter) {
         VMAIter prev_vma = std::prev(iter);
         if (prev_vma->second.CanBeMergedWith(iter->second)) {
             prev_vma->second.size += iter->second.size;
+            last_vma = vma_map.end();
             vma_map.erase(iter);
             iter = prev_vma;
         }
@@ -366,9 +377,9 @@ ResultVal<std::vector<std::pair<u8*, u32>>> VMManager::GetBackingBlocksForRange(
                                                                                 u32 size) {
     std::vector<std::pair<u8*, u32>> backing_blocks;
     VAddr interval_target = address;
-    while (interval_target != address + size) {
-        auto vma = FindVMA(interval_target);
-        if (vma->second.type != VMAType::BackingMemory) {
+    // VMAs are contiguous, so the range is covered by consecutive ones
+    for (auto vma = FindVMA(interval_target); interval_target != address + size; ++vma) {
+        if (vma == vma_map.end() || vma->second.type != VMAType::BackingMemory) {
             LOG_ERROR(Kernel, "Trying to use already freed memory");
             return ERR_INVALID_ADDRESS_STATE;
         }
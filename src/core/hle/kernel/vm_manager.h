@@ -198,7 +198,7 @@ private:
     /// Converts a VMAHandle to a mutable VMAIter.
     VMAIter StripIterConstness(const VMAHandle& iter);
 
-    /// Unmaps the given VMA.
+    /// Marks the given VMA as free, without updating the page table.
     VMAIter Unmap(VMAIter vma);
 
     /**
@@ -228,6 +228,9 @@ private:
     /// Updates the pages corresponding to this VMA so they match the VMA's attributes.
     void UpdatePageTableForVMA(const VirtualMemoryArea& vma);
 
+    /// The VMA found by the last FindVMA call, or `vma_map.end()`. Reset whenever a VMA is erased.
+    mutable VMAHandle last_vma;
+
     Memory::MemorySystem& memory;
 };
 } // namespace Kernel
@@ -9,6 +9,7 @@
 #include "core/hle/kernel/errors.h"
 #include "core/hle/kernel/kernel.h"
 #include "core/hle/kernel/memory.h"
+#include "core/hle/kernel/mutex.h"
 #include "core/hle/kernel/process.h"
 #include "core/hle/kernel/resource_limit.h"
 #include "core/hle/kernel/thread.h"
@@ -32,34 +33,36 @@ void WaitObject::RemoveWaitingThread(Thread* thread) {
         waiting_threads.erase(itr);
 }
 
+bool WaitObject::IsReadyToRun(const Thread* thread) const {
+    // The list of waiting threads must not contain threads that are not waiting to be awakened.
+    ASSERT_MSG(thread->status == ThreadStatus::WaitSynchAny ||
+                   thread->status == ThreadStatus::WaitSynchAll ||
+                   thread->status == ThreadStatus::WaitHleEvent,
+               "Inconsistent thread statuses in waiting_threads");
+
+    if (ShouldWait(thread))
+        return false;
+
+    // A thread is ready to run if it's either in ThreadStatus::WaitSynchAny or
+    // in ThreadStatus::WaitSynchAll and the rest of the objects it is waiting on are ready.
+    if (thread->status == ThreadStatus::WaitSynchAll) {
+        return std::none_of(thread->wait_objects.begin(), thread->wait_objects.end(),
+                            [this, thread](const std::shared_ptr<WaitObject>& object) {
+                                return object.get() != this && object->ShouldWait(thread);
+                            });
+    }
+    return true;
+}
+
 std::shared_ptr<Thread> WaitObject::GetHighestPriorityReadyThread() const {
     Thread* candidate = nullptr;
     u32 candidate_priority = ThreadPrioLowest + 1;
 
     for (const auto& thread : waiting_threads) {
-        // The list of waiting threads must not contain threads that are not waiting to be awakened.
-        ASSERT_MSG(thread->status == ThreadStatus::WaitSynchAny ||
-                       thread->status == ThreadStatus::WaitSynchAll ||
-                       thread->status == ThreadStatus::WaitHleEvent,
-                   "Inconsistent thread statuses in waiting_threads");
-
         if (thread->current_priority >= candidate_priority)
             continue;
 
-        if (ShouldWait(thread.get()))
-            continue;
-
-        // A thread is ready to run if it's either in ThreadStatus::WaitSynchAny or
-        // in ThreadStatus::WaitSynchAll and the rest of the objects it is waiting on are ready.
-        bool ready_to_run = true;
-        if (thread->status == ThreadStatus::WaitSynchAll) {
-            ready_to_run = std::none_of(thread->wait_objects.begin(), thread->wait_objects.end(),
-                                        [&thread](const std::shared_ptr<WaitObject>& object) {
-                                            return object->ShouldWait(thread.get());
-                                        });
-        }
-
-        if (ready_to_run) {
+        if (IsReadyToRun(thread.get())) {
             candidate = thread.get();
             candidate_priority = thread->current_priority;
         }
@@ -68,26 +71,84 @@ std::shared_ptr<Thread> WaitObject::GetHighestPriorityReadyThread() const {
     return SharedFrom(candidate);
 }
 
-void WaitObject::WakeupAllWaitingThreads() {
-    while (auto thread = GetHighestPriorityReadyThread()) {
-        if (!thread->IsSleepingOnWaitAll()) {
-            Acquire(thread.get());
-        } else {
-            for (auto& object : thread->wait_objects) {
-                object->Acquire(thread.get());
-            }
+void WaitObject::WakeupThread(const std::shared_ptr<Thread>& thread) {
+    if (!thread->IsSleepingOnWaitAll()) {
+        Acquire(thread.get());
+    } else {
+        for (auto& object : thread->wait_objects) {
+            object->Acquire(thread.get());
         }
+    }
 
-        // Invoke the wakeup callback before clearing the wait objects
-        if (thread->wakeup_callback)
-            thread->wakeup_callback(ThreadWakeupReason::Signal, thread, SharedFrom(this));
+    // Invoke the wakeup callback before clearing the wait objects
+    if (thread->wakeup_callback)
+        thread->wakeup_callback(ThreadWakeupReason::Signal, thread, SharedFrom(this));
 
-        for (auto& object : thread->wait_objects)
-            object->RemoveWaitingThread(thread.get());
-        thread->wait_objects.clear();
+    for (auto& object : thread->wait_objects)
+        object->RemoveWaitingThread(thread.get());
+    thread->wait_objects.clear();
 
-        thread->ResumeFromWait();
+    thread->ResumeFromWait();
+}
+
+/// Current priorities of the threads holding a mutex that the thread waits on. Waking the thread
+/// removes it from those mutexes, which can take away the priority their holders inherited from it.
+static std::vector<std::pair<std::shared_ptr<Thread>, u32>> GetMutexHolderPriorities(
+    const Thread& thread) {
+    std::vector<std::pair<std::shared_ptr<Thread>, u32>> holders;
+    for (const auto& mutex : thread.pending_mutexes) {
+        if (mutex->holding_thread) {
+            holders.emplace_back(mutex->holding_thread, mutex->holding_thread->current_priority);
+        }
     }
+    return holders;
+}
+
+void WaitObject::WakeupAllWaitingThreads() {
+    // Acquiring an object never makes it more available, so a thread that can't run yet won't
+    // become ready as others are woken up. A single pass over the waiting threads in priority
+    // order then wakes them in the same order as repeatedly picking the highest priority ready
+    // thread would, without rescanning the list after each one. Equal priorities keep the order in
+    // which the threads started waiting. The wakeup callbacks of the wait SVCs only set the
+    // results of the wait, but those of threads paused by an HLE service run the rest of the
+    // service call, which can signal or release objects, so the pass starts over after each of
+    // them. It also starts over when a wakeup changes the priority of a mutex holder through
+    // priority inheritance, as the holder may be waiting here too.
+    bool restart;
+    do {
+        restart = false;
+        if (waiting_threads.empty()) {
+            break;
+        }
+        if (waiting_threads.size() == 1) {
+            const std::shared_ptr<Thread> thread = waiting_threads.front();
+            if (IsReadyToRun(thread.get())) {
+                restart = thread->status == ThreadStatus::WaitHleEvent;
+                WakeupThread(thread);
+            }
+            continue;
+        }
+
+        std::vector<std::shared_ptr<Thread>> candidates = waiting_threads;
+        std::stable_sort(candidates.begin(), candidates.end(),
+                         [](const auto& lhs, const auto& rhs) {
+                             return lhs->current_priority < rhs->current_priority;
+                         });
+        for (const auto& thread : candidates) {
+            if (!IsReadyToRun(thread.get()))
+                continue;
+            restart = thread->status == ThreadStatus::WaitHleEvent;
+            const auto holders = GetMutexHolderPriorities(*thread);
+            WakeupThread(thread);
+            const bool holder_priority_changed =
+                std::any_of(holders.begin(), holders.end(), [](const auto& holder) {
+                    return holder.first->current_priority != holder.second;
+                });
+            restart = restart || holder_priority_changed;
+            if (restart)
+                break;
+        }
+    } while (restart);
 
     if (hle_notifier)
         hle_notifier();
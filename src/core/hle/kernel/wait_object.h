@@ -57,6 +57,12 @@ public:
     void SetHLENotifier(std::function<void()> callback);
 
 private:
+    /// Checks if a thread waiting on this object can be woken up by it.
+    bool IsReadyToRun(const Thread* thread) const;
+
+    /// Acquires the objects the thread waits on for it and resumes it.
+    void WakeupThread(const std::shared_ptr<Thread>& thread);
+
     /// Threads waiting for this object to become available
     std::vector<std::shared_ptr<Thread>> waiting_threads;
 
@@ -12,6 +12,7 @@
 #include "core/hle/kernel/event.h"
 #include "core/hle/kernel/server_session.h"
 #include "core/hle/service/fs/file.h"
+#include "core/memory.h"
 
 namespace Service::FS {
 
@@ -58,16 +59,50 @@ void File::Read(Kernel::HLERequestContext& ctx) {
 
     IPC::RequestBuilder rb = rp.MakeBuilder(2, 2);
 
-    std::vector<u8> data(length);
-    ResultVal<std::size_t> read = backend->Read(offset, data.size(), data.data());
-    if (read.Failed()) {
-        rb.Push(read.Code());
-        rb.Push<u32>(0);
-    } else {
-        buffer.Write(data.data(), 0, *read);
-        rb.Push(RESULT_SUCCESS);
-        rb.Push<u32>(static_cast<u32>(*read));
+    // Read straight into the guest buffer where it is backed by memory. Rasterizer-cached parts
+    // are only invalidated once the bytes read into them are known, so that a short read doesn't
+    // discard cached data past its end.
+    ResultCode result = RESULT_SUCCESS;
+    std::size_t read = 0;
+    std::vector<u8> data;
+    const std::size_t in_buffer = std::min<std::size_t>(length, buffer.GetSize());
+    for (const auto& span : buffer.GetSpans(0, in_buffer, std::nullopt)) {
+        u8* dest = span.pointer;
+        if (dest == nullptr) {
+            data.resize(span.size);
+            dest = data.data();
+        }
+        const ResultVal<std::size_t> span_read = backend->Read(offset + read, span.size, dest);
+        if (span_read.Failed()) {
+            result = span_read.Code();
+            break;
+        }
+        if (span.pointer == nullptr) {
+            buffer.Write(dest, read, *span_read);
+        } else if (span.rasterizer_cached && *span_read != 0) {
+            Memory::RasterizerFlushVirtualRegion(span.vaddr, static_cast<u32>(*span_read),
+                                                 Memory::FlushMode::Invalidate);
+        }
+        read += *span_read;
+        if (*span_read != span.size) {
+            break;
+        }
+    }
+
+    // A request longer than its buffer is still read in full, and writing past the end of the
+    // buffer fails the same way as it always has
+    if (result.IsSuccess() && read == in_buffer && in_buffer != length) {
+        data.resize(length - in_buffer);
+        const ResultVal<std::size_t> rest = backend->Read(offset + read, data.size(), data.data());
+        if (rest.Failed()) {
+            result = rest.Code();
+        } else {
+            buffer.Write(data.data(), read, *rest);
+            read += *rest;
+        }
     }
+    rb.Push(result);
+    rb.Push<u32>(result.IsError() ? 0 : static_cast<u32>(read));
     rb.PushMappedBuffer(buffer);
 
     std::chrono::nanoseconds read_timeout_ns{backend->GetReadDelayNs(length)};
@@ -100,20 +135,40 @@ void File::Write(Kernel::HLERequestContext& ctx) {
         return;
     }
 
-    std::vector<u8> data(length);
-    buffer.Read(data.data(), 0, data.size());
-    ResultVal<std::size_t> written = backend->Write(offset, data.size(), flush != 0, data.data());
+    // Write straight from the guest buffer where it is backed by memory
+    const auto spans = buffer.GetSpans(0, length, Memory::FlushMode::Flush);
+    ResultCode result = RESULT_SUCCESS;
+    std::size_t written = 0;
+    std::vector<u8> data;
+    if (spans.empty() && flush != 0) {
+        // Empty writes still flush the file
+        result = backend->Write(offset, 0, true, nullptr).Code();
+    }
+    for (std::size_t i = 0; i < spans.size(); ++i) {
+        const u8* src = spans[i].pointer;
+        if (src == nullptr) {
+            data.resize(spans[i].size);
+            buffer.Read(data.data(), written, data.size());
+            src = data.data();
+        }
+        const bool last = i == spans.size() - 1;
+        const ResultVal<std::size_t> span_written =
+            backend->Write(offset + written, spans[i].size, last && flush != 0, src);
+        if (span_written.Failed()) {
+            result = span_written.Code();
+            break;
+        }
+        written += *span_written;
+        if (*span_written != spans[i].size) {
+            break;
+        }
+    }
 
     // Update file size
     file->size = backend->GetSize();
 
-    if (written.Failed()) {
-        rb.Push(written.Code());
-        rb.Push<u32>(0);
-    } else {
-        rb.Push(RESULT_SUCCESS);
-        rb.Push<u32>(static_cast<u32>(*written));
-    }
+    rb.Push(result);
+    rb.Push<u32>(result.IsError() ? 0 : static_cast<u32>(written));
     rb.PushMappedBuffer(buffer);
 }
 
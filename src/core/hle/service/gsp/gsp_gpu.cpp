@@ -2,6 +2,8 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <cstring>
 #include <vector>
 #include "common/bit_field.h"
 #include "common/microprofile.h"
@@ -474,6 +476,39 @@ void GSP_GPU::SignalInterrupt(InterruptId interrupt_id) {
 MICROPROFILE_DEFINE(GPU_GSP_DMA, "GPU", "GSP DMA", MP_RGB(100, 0, 255));
 
 /// Executes the next GSP command
+/**
+ * Performs a GX DMA copy within the address space of a process. The source is flushed from and the
+ * destination invalidated in the rasterizer cache once each, and memory-backed parts are copied in
+ * place. Parts that are not backed by memory fall back to CopyBlock.
+ */
+static void DmaCopy(Memory::MemorySystem& memory, const Kernel::Process& process, VAddr dest_addr,
+                    VAddr src_addr, u32 size) {
+    const auto src_spans = memory.GetSpans(process, src_addr, size, Memory::FlushMode::Flush);
+    const auto dest_spans =
+        memory.GetSpans(process, dest_addr, size, Memory::FlushMode::Invalidate);
+
+    auto src = src_spans.begin();
+    std::size_t src_offset = 0;
+    for (const auto& dest : dest_spans) {
+        std::size_t dest_offset = 0;
+        while (dest_offset < dest.size) {
+            const std::size_t amount = std::min(dest.size - dest_offset, src->size - src_offset);
+            if (dest.pointer != nullptr && src->pointer != nullptr) {
+                std::memmove(dest.pointer + dest_offset, src->pointer + src_offset, amount);
+            } else {
+                memory.CopyBlock(process, dest.vaddr + static_cast<VAddr>(dest_offset),
+                                 src->vaddr + static_cast<VAddr>(src_offset), amount);
+            }
+            dest_offset += amount;
+            src_offset += amount;
+            if (src_offset == src->size) {
+                ++src;
+                src_offset = 0;
+            }
+        }
+    }
+}
+
 static void ExecuteCommand(const Command& command, u32 thread_id) {
     // Utility function to convert register ID to address
     static auto WriteGPURegister = [](u32 id, u32 data) {
@@ -489,17 +524,12 @@ static void ExecuteCommand(const Command& command, u32 thread_id) {
 
         // TODO: Consider attempting rasterizer-accelerated surface blit if that usage is ever
         // possible/likely
-        Memory::RasterizerFlushVirtualRegion(command.dma_request.source_address,
-                                             command.dma_request.size, Memory::FlushMode::Flush);
-        Memory::RasterizerFlushVirtualRegion(command.dma_request.dest_address,
-                                             command.dma_request.size,
-                                             Memory::FlushMode::Invalidate);
 
         // TODO(Subv): These memory accesses should not go through the application's memory mapping.
         // They should go through the GSP module's memory mapping.
-        memory.CopyBlock(*Core::System::GetInstance().Kernel().GetCurrentProcess(),
-                         command.dma_request.dest_address, command.dma_request.source_address,
-                         command.dma_request.size);
+        DmaCopy(memory, *Core::System::GetInstance().Kernel().GetCurrentProcess(),
+                command.dma_request.dest_address, command.dma_request.source_address,
+                command.dma_request.size);
         SignalInterrupt(InterruptId::DMA);
         break;
     }
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include "common/alignment.h"
 #include "common/logging/log.h"
 #include "common/scope_exit.h"
@@ -1533,4 +1534,41 @@ std::tuple<VAddr, u32> CROHelper::GetExecutablePages() const {
     return std::make_tuple(0, 0);
 }
 
+std::vector<CROHelper::ExportedSymbol> CROHelper::GetExportNamedSymbols() const {
+    u32 segment_num = GetField(SegmentNum);
+    u32 export_named_symbol_num = GetField(ExportNamedSymbolNum);
+    u32 export_strings_size = GetField(ExportStringsSize);
+
+    std::vector<ExportedSymbol> symbols;
+    symbols.reserve(export_named_symbol_num);
+    for (u32 i = 0; i < export_named_symbol_num; ++i) {
+        ExportNamedSymbolEntry entry;
+        GetEntry(system.Memory(), i, entry);
+        if (entry.name_offset == 0 || entry.symbol_position.segment_index >= segment_num)
+            continue;
+
+        SegmentEntry segment;
+        GetEntry(system.Memory(), entry.symbol_position.segment_index, segment);
+        if (entry.symbol_position.offset_into_segment >= segment.size)
+            continue;
+
+        symbols.push_back({system.Memory().ReadCString(entry.name_offset, export_strings_size),
+                           segment.offset + entry.symbol_position.offset_into_segment,
+                           segment.size - entry.symbol_position.offset_into_segment});
+    }
+
+    // The export table has no sizes, so each symbol ends where the next one starts
+    std::sort(symbols.begin(), symbols.end(),
+              [](const auto& a, const auto& b) { return a.address < b.address; });
+    for (std::size_t i = 0, next = 0; i < symbols.size(); ++i) {
+        while (next < symbols.size() && symbols[next].address <= symbols[i].address) {
+            ++next;
+        }
+        if (next < symbols.size()) {
+            symbols[i].size = std::min(symbols[i].size, symbols[next].address - symbols[i].address);
+        }
+    }
+    return symbols;
+}
+
 } // namespace Service::LDR
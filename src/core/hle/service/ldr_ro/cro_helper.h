@@ -5,7 +5,9 @@
 #pragma once
 
 #include <array>
+#include <string>
 #include <tuple>
+#include <vector>
 #include "common/common_types.h"
 #include "common/swap.h"
 #include "core/hle/result.h"
@@ -140,6 +142,20 @@ public:
      */
     std::tuple<VAddr, u32> GetExecutablePages() const;
 
+    /// A named symbol exported from this module.
+    struct ExportedSymbol {
+        std::string name;
+        VAddr address;
+        u32 size; ///< up to the next exported symbol or the end of its segment
+    };
+
+    /**
+     * Gets the named symbols exported from this module. Only valid after rebasing and before
+     * fixing the module, as fixing may discard the export table.
+     * @returns the symbols sorted by address.
+     */
+    std::vector<ExportedSymbol> GetExportNamedSymbols() const;
+
 private:
     const VAddr module_address; ///< the virtual address of this module
     Kernel::Process& process;   ///< the owner process of this module
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <fmt/format.h>
 #include "common/alignment.h"
 #include "common/common_types.h"
 #include "common/logging/log.h"
@@ -132,6 +133,13 @@ void RO::Initialize(Kernel::HLERequestContext& ctx) {
         return;
     }
 
+    if (auto* profiler = system.GetGuestProfiler()) {
+        for (auto& symbol : crs.GetExportNamedSymbols()) {
+            profiler->AddSymbol(process->process_id, symbol.address, symbol.size,
+                                std::move(symbol.name));
+        }
+    }
+
     slot->loaded_crs = crs_address;
 
     rb.Push(RESULT_SUCCESS);
@@ -291,6 +299,14 @@ void RO::LoadCRO(Kernel::HLERequestContext& ctx, bool link_on_load_bug_fix) {
 
     cro.Register(slot->loaded_crs, auto_link);
 
+    if (auto* profiler = system.GetGuestProfiler()) {
+        const std::string module_name = cro.ModuleName();
+        for (const auto& symbol : cro.GetExportNamedSymbols()) {
+            profiler->AddSymbol(process->process_id, symbol.address, symbol.size,
+                                fmt::format("{}!{}", module_name, symbol.name));
+        }
+    }
+
     u32 fix_size = cro.Fix(fix_level);
 
     if (fix_size != cro_size) {
@@ -387,6 +403,10 @@ void RO::UnloadCRO(Kernel::HLERequestContext& ctx) {
 
     cro.Unrebase(false);
 
+    if (auto* profiler = system.GetGuestProfiler()) {
+        profiler->RemoveSymbols(process->process_id, cro_address, fixed_size);
+    }
+
     result = process->Unmap(cro_address, cro_buffer_ptr, fixed_size,
                             Kernel::VMAPermission::ReadWrite, true);
     if (result.IsError()) {
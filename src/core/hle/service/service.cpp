@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <chrono>
 #include <fmt/format.h>
 #include "common/assert.h"
 #include "common/logging/log.h"
@@ -47,6 +48,7 @@
 #include "core/hle/service/pxi/pxi.h"
 #include "core/hle/service/qtm/qtm.h"
 #include "core/hle/service/service.h"
+#include "core/hle/service/service_metrics.h"
 #include "core/hle/service/sm/sm.h"
 #include "core/hle/service/sm/srv.h"
 #include "core/hle/service/soc_u.h"
@@ -129,20 +131,65 @@ ServiceFrameworkBase::~ServiceFrameworkBase() = default;
 void ServiceFrameworkBase::InstallAsService(SM::ServiceManager& service_manager) {
     auto port = service_manager.RegisterService(service_name, max_sessions).Unwrap();
     port->SetHleHandler(shared_from_this());
+    AttachMetrics(service_manager.GetServiceMetrics());
 }
 
-void ServiceFrameworkBase::InstallAsNamedPort(Kernel::KernelSystem& kernel) {
+void ServiceFrameworkBase::InstallAsNamedPort(Kernel::KernelSystem& kernel,
+                                              ServiceMetrics& metrics) {
     auto [server_port, client_port] = kernel.CreatePortPair(max_sessions, service_name);
     server_port->SetHleHandler(shared_from_this());
     kernel.AddNamedPort(service_name, std::move(client_port));
+    AttachMetrics(metrics);
 }
 
+void ServiceFrameworkBase::AttachMetrics(ServiceMetrics& metrics_) {
+    metrics = &metrics_;
+    metrics_index = metrics->RegisterService(service_name);
+}
+
+namespace {
+/// Marks command IDs without a handler in the handler table
+constexpr u16 NO_HANDLER = 0xFFFF;
+/// Commands with higher IDs are looked up in the map instead
+constexpr u32 MAX_TABLE_COMMAND_ID = 0x1000;
+} // Anonymous namespace
+
 void ServiceFrameworkBase::RegisterHandlersBase(const FunctionInfoBase* functions, std::size_t n) {
     handlers.reserve(handlers.size() + n);
     for (std::size_t i = 0; i < n; ++i) {
         // Usually this array is sorted by id already, so hint to insert at the end
         handlers.emplace_hint(handlers.cend(), functions[i].expected_header, functions[i]);
     }
+    ASSERT(handlers.size() < NO_HANDLER);
+
+    // Inserting may have moved the existing handlers, so the table is rebuilt from scratch. If
+    // several headers share a command ID, the first one goes into the table and the others are
+    // found through the map.
+    handler_table.clear();
+    for (auto itr = handlers.begin(); itr != handlers.end(); ++itr) {
+        const u32 command_id = itr->first >> 16;
+        if (command_id >= MAX_TABLE_COMMAND_ID) {
+            continue;
+        }
+        if (command_id >= handler_table.size()) {
+            handler_table.resize(command_id + 1, NO_HANDLER);
+        }
+        if (handler_table[command_id] == NO_HANDLER) {
+            handler_table[command_id] = static_cast<u16>(itr - handlers.begin());
+        }
+    }
+}
+
+const ServiceFrameworkBase::FunctionInfoBase* ServiceFrameworkBase::FindHandler(u32 header) const {
+    const u32 command_id = header >> 16;
+    if (command_id < handler_table.size() && handler_table[command_id] != NO_HANDLER) {
+        const FunctionInfoBase& info = handlers.nth(handler_table[command_id])->second;
+        if (info.expected_header == header) {
+            return &info;
+        }
+    }
+    auto itr = handlers.find(header);
+    return itr == handlers.end() ? nullptr : &itr->second;
 }
 
 void ServiceFrameworkBase::ReportUnimplementedFunction(u32* cmd_buf, const FunctionInfoBase* info) {
@@ -168,8 +215,7 @@ void ServiceFrameworkBase::ReportUnimplementedFunction(u32* cmd_buf, const Funct
 
 void ServiceFrameworkBase::HandleSyncRequest(Kernel::HLERequestContext& context) {
     u32 header_code = context.CommandBuffer()[0];
-    auto itr = handlers.find(header_code);
-    const FunctionInfoBase* info = itr == handlers.end() ? nullptr : &itr->second;
+    const FunctionInfoBase* info = FindHandler(header_code);
     if (info == nullptr || info->handler_callback == nullptr) {
         context.ReportUnimplemented();
         return ReportUnimplementedFunction(context.CommandBuffer(), info);
@@ -177,15 +223,32 @@ void ServiceFrameworkBase::HandleSyncRequest(Kernel::HLERequestContext& context)
 
     LOG_TRACE(Service, "{}",
               MakeFunctionString(info->name, GetServiceName(), context.CommandBuffer()));
+    if (metrics == nullptr || !metrics->IsEnabled()) {
+        handler_invoker(this, info->handler_callback, context);
+        return;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
     handler_invoker(this, info->handler_callback, context);
+    const auto end = std::chrono::steady_clock::now();
+
+    CommandMetrics call;
+    call.calls = 1;
+    call.host_time_ns = static_cast<u64>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    call.static_buffer_bytes = context.GetStaticBufferBytes();
+    call.mapped_buffer_bytes = context.GetMappedBufferBytes();
+    call.client_sleeps = context.IsClientThreadSleeping() ? 1 : 0;
+    metrics->Record(metrics_index, header_code, info->name, call);
 }
 
 std::string ServiceFrameworkBase::GetFunctionName(u32 header) const {
-    if (!handlers.count(header)) {
+    const FunctionInfoBase* info = FindHandler(header);
+    if (info == nullptr) {
         return "";
     }
 
-    return handlers.at(header).name;
+    return info->name;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -9,6 +9,7 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 #include <boost/container/flat_map.hpp>
 #include "common/common_types.h"
 #include "core/hle/kernel/hle_ipc.h"
@@ -32,6 +33,8 @@ namespace SM {
 class ServiceManager;
 }
 
+class ServiceMetrics;
+
 static const int kMaxPortSize = 8; ///< Maximum size of a port name (8 characters)
 /// Arbitrary default number of maximum connections to an HLE service.
 static const u32 DefaultMaxSessions = 10;
@@ -60,7 +63,7 @@ public:
     /// Creates a port pair and registers this service with the given ServiceManager.
     void InstallAsService(SM::ServiceManager& service_manager);
     /// Creates a port pair and registers it on the kernel's global port registry.
-    void InstallAsNamedPort(Kernel::KernelSystem& kernel);
+    void InstallAsNamedPort(Kernel::KernelSystem& kernel, ServiceMetrics& metrics);
 
     void HandleSyncRequest(Kernel::HLERequestContext& context) override;
 
@@ -91,6 +94,12 @@ private:
     void RegisterHandlersBase(const FunctionInfoBase* functions, std::size_t n);
     void ReportUnimplementedFunction(u32* cmd_buf, const FunctionInfoBase* info);
 
+    /// Returns the handler registered for a command header, or nullptr if there is none.
+    const FunctionInfoBase* FindHandler(u32 header) const;
+
+    /// Registers this service with the collector that its calls are recorded in.
+    void AttachMetrics(ServiceMetrics& metrics);
+
     /// Identifier string used to connect to the service.
     std::string service_name;
     /// Maximum number of concurrent sessions that this service can handle.
@@ -99,6 +108,14 @@ private:
     /// Function used to safely up-cast pointers to the derived class before invoking a handler.
     InvokerFn* handler_invoker;
     boost::container::flat_map<u32, FunctionInfoBase> handlers;
+
+    /// Index into handlers by command ID, rebuilt whenever handlers are registered. Command IDs
+    /// are small and dense, so this avoids searching the map on every request.
+    std::vector<u16> handler_table;
+
+    /// Collector of the call statistics, and the index this service is registered under in it
+    ServiceMetrics* metrics = nullptr;
+    std::size_t metrics_index = 0;
 };
 
 /**
@@ -0,0 +1,128 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <ctime>
+#include <iterator>
+#include <fmt/chrono.h>
+#include <fmt/format.h>
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "core/hle/service/service_metrics.h"
+
+namespace Service {
+
+namespace {
+/// Quotes a string for use in JSON.
+std::string QuoteJson(const std::string& str) {
+    std::string quoted = "\"";
+    for (const char c : str) {
+        if (c == '"' || c == '\\') {
+            quoted += '\\';
+            quoted += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            quoted += fmt::format("\\u{:04x}", static_cast<int>(c));
+        } else {
+            quoted += c;
+        }
+    }
+    quoted += '"';
+    return quoted;
+}
+} // Anonymous namespace
+
+CommandMetrics& CommandMetrics::operator+=(const CommandMetrics& other) {
+    calls += other.calls;
+    host_time_ns += other.host_time_ns;
+    static_buffer_bytes += other.static_buffer_bytes;
+    mapped_buffer_bytes += other.mapped_buffer_bytes;
+    client_sleeps += other.client_sleeps;
+    return *this;
+}
+
+std::size_t ServiceMetrics::RegisterService(std::string service_name) {
+    std::lock_guard lock{mutex};
+    services.push_back({std::move(service_name), {}});
+    return services.size() - 1;
+}
+
+void ServiceMetrics::Record(std::size_t service_index, u32 header, const char* function_name,
+                            const CommandMetrics& call) {
+    std::lock_guard lock{mutex};
+    CommandEntry& entry = services[service_index].commands[header];
+    if (entry.metrics.calls == 0 && function_name != nullptr) {
+        entry.function_name = function_name;
+    }
+    entry.metrics += call;
+}
+
+ServiceMetrics::Snapshot ServiceMetrics::GetSnapshot() const {
+    std::lock_guard lock{mutex};
+    Snapshot snapshot;
+    for (const ServiceEntry& service : services) {
+        if (service.commands.empty()) {
+            continue;
+        }
+        auto& commands = snapshot[service.name];
+        for (const auto& [header, entry] : service.commands) {
+            CommandEntry& merged = commands[header];
+            if (merged.metrics.calls == 0) {
+                merged.function_name = entry.function_name;
+            }
+            merged.metrics += entry.metrics;
+        }
+    }
+    return snapshot;
+}
+
+void ServiceMetrics::Reset() {
+    std::lock_guard lock{mutex};
+    services.clear();
+}
+
+std::string ServiceMetrics::ToJson() const {
+    const Snapshot snapshot = GetSnapshot();
+
+    std::string json = "{\n";
+    for (auto service = snapshot.begin(); service != snapshot.end(); ++service) {
+        CommandMetrics total;
+        for (const auto& [header, entry] : service->second) {
+            total += entry.metrics;
+        }
+
+        json += fmt::format("  {}: {{\n    \"calls\": {},\n    \"host_time_ns\": {},\n"
+                            "    \"commands\": [\n",
+                            QuoteJson(service->first), total.calls, total.host_time_ns);
+        for (auto command = service->second.begin(); command != service->second.end();
+             ++command) {
+            const CommandMetrics& metrics = command->second.metrics;
+            json += fmt::format(
+                "      {{\"header\": \"{:#010x}\", \"name\": {}, \"calls\": {}, "
+                "\"host_time_ns\": {}, \"static_buffer_bytes\": {}, "
+                "\"mapped_buffer_bytes\": {}, \"client_sleeps\": {}}}{}\n",
+                command->first, QuoteJson(command->second.function_name), metrics.calls,
+                metrics.host_time_ns, metrics.static_buffer_bytes, metrics.mapped_buffer_bytes,
+                metrics.client_sleeps, std::next(command) == service->second.end() ? "" : ",");
+        }
+        json += fmt::format("    ]\n  }}{}\n", std::next(service) == snapshot.end() ? "" : ",");
+    }
+    json += "}\n";
+    return json;
+}
+
+std::string ServiceMetrics::WriteJson(u64 title_id) const {
+    const std::time_t t = std::time(nullptr);
+    const std::string& path = FileUtil::GetUserPath(FileUtil::UserPath::LogDir);
+    // %F Date format expanded is "%Y-%m-%d"
+    const std::string filename = fmt::format("{}/{:%F-%H-%M}_{:016X}_service_metrics.json", path,
+                                             *std::localtime(&t), title_id);
+    FileUtil::IOFile file(filename, "w");
+    const std::string json = ToJson();
+    if (file.WriteString(json) != json.size()) {
+        LOG_ERROR(Service, "Failed to write the service metrics to {}", filename);
+        return "";
+    }
+    return filename;
+}
+
+} // namespace Service
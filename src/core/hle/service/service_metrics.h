@@ -0,0 +1,85 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "common/common_types.h"
+
+namespace Service {
+
+/// Accumulated statistics of one command of an HLE service.
+struct CommandMetrics {
+    u64 calls = 0;
+    /// Host time spent in the handler
+    u64 host_time_ns = 0;
+    u64 static_buffer_bytes = 0;
+    u64 mapped_buffer_bytes = 0;
+    /// Number of calls that put the client thread to sleep
+    u64 client_sleeps = 0;
+
+    CommandMetrics& operator+=(const CommandMetrics& other);
+};
+
+/**
+ * Collects per-command statistics of HLE service calls. Services register once when they are
+ * installed and record their calls by the returned index. Recording is disabled by default;
+ * callers check IsEnabled() before timing a request, so a disabled collector costs one load.
+ */
+class ServiceMetrics {
+public:
+    struct CommandEntry {
+        std::string function_name;
+        CommandMetrics metrics;
+    };
+
+    /// Commands of each service, by command header
+    using Snapshot = std::map<std::string, std::map<u32, CommandEntry>>;
+
+    bool IsEnabled() const {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    void SetEnabled(bool enable) {
+        enabled.store(enable, std::memory_order_relaxed);
+    }
+
+    /// Adds a service and returns the index to record its calls with.
+    std::size_t RegisterService(std::string service_name);
+
+    /// Adds the statistics of a single call to a registered service.
+    void Record(std::size_t service_index, u32 header, const char* function_name,
+                const CommandMetrics& call);
+
+    /// Returns a copy of the statistics collected so far. Services registered under the same name
+    /// are merged.
+    Snapshot GetSnapshot() const;
+
+    /// Discards the statistics and all registered services.
+    void Reset();
+
+    /// Returns the statistics as a JSON document.
+    std::string ToJson() const;
+
+    /// Writes the statistics as JSON to a file in the log directory. Returns the path, or "" on
+    /// failure.
+    std::string WriteJson(u64 title_id) const;
+
+private:
+    struct ServiceEntry {
+        std::string name;
+        std::map<u32, CommandEntry> commands;
+    };
+
+    std::atomic<bool> enabled{false};
+    mutable std::mutex mutex;
+    std::vector<ServiceEntry> services;
+};
+
+} // namespace Service
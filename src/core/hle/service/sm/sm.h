@@ -23,6 +23,10 @@ class ClientSession;
 class SessionRequestHandler;
 } // namespace Kernel
 
+namespace Service {
+class ServiceMetrics;
+}
+
 namespace Service::SM {
 
 class SRV;
@@ -54,6 +58,9 @@ public:
     // For IPC Recorder
     std::string GetServiceNameByPortId(u32 port) const;
 
+    /// Returns the collector that the installed services record their call statistics in.
+    ServiceMetrics& GetServiceMetrics();
+
     template <typename T>
     std::shared_ptr<T> GetService(const std::string& service_name) const {
         static_assert(std::is_base_of_v<Kernel::SessionRequestHandler, T>,
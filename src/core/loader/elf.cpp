@@ -2,9 +2,11 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <cstring>
 #include <memory>
 #include <string>
+#include <vector>
 #include "common/common_types.h"
 #include "common/file_util.h"
 #include "common/logging/log.h"
@@ -154,6 +156,10 @@ struct Elf32_Phdr {
     Elf32_Word p_align;
 };
 
+// Symbol types
+#define STT_FUNC 2
+#define ELF32_ST_TYPE(info) ((info)&0xF)
+
 // Symbol table entry
 struct Elf32_Sym {
     Elf32_Word st_name;
@@ -245,6 +251,12 @@ public:
     bool DidRelocate() const {
         return relocate;
     }
+
+    /// Calls callback(address, size, name) for each function in the symbol tables. A function
+    /// without a size extends up to the next function or the end of its section. Only valid after
+    /// LoadInto().
+    template <typename Callback>
+    void ForEachFunctionSymbol(u32 vaddr, Callback&& callback) const;
 };
 
 ElfReader::ElfReader(void* ptr) {
@@ -349,6 +361,63 @@ std::shared_ptr<CodeSet> ElfReader::LoadInto(u32 vaddr) {
     return codeset;
 }
 
+template <typename Callback>
+void ElfReader::ForEachFunctionSymbol(u32 vaddr, Callback&& callback) const {
+    struct FunctionSymbol {
+        u32 address;
+        u32 size;
+        bool sized; ///< Whether the size comes from the symbol table
+        std::string name;
+    };
+
+    const u32 base_addr = relocate ? vaddr : 0;
+    std::vector<FunctionSymbol> functions;
+    for (int i = 0; i < header->e_shnum; ++i) {
+        const Elf32_Shdr& symtab = sections[i];
+        if (symtab.sh_type != SHT_SYMTAB || symtab.sh_link >= header->e_shnum)
+            continue;
+
+        const auto* strings = reinterpret_cast<const char*>(GetSectionDataPtr(symtab.sh_link));
+        const u32 strings_size = sections[symtab.sh_link].sh_size;
+        const auto* symbols = reinterpret_cast<const Elf32_Sym*>(GetSectionDataPtr(i));
+        if (strings == nullptr || symbols == nullptr)
+            continue;
+
+        for (u32 j = 0; j < symtab.sh_size / sizeof(Elf32_Sym); ++j) {
+            const Elf32_Sym& symbol = symbols[j];
+            if (ELF32_ST_TYPE(symbol.st_info) != STT_FUNC || symbol.st_name >= strings_size)
+                continue;
+            // Bit 0 of the address only marks Thumb functions
+            const u32 address = base_addr + (symbol.st_value & ~1u);
+            u32 size = symbol.st_size;
+            if (size == 0 && symbol.st_shndx < header->e_shnum) {
+                const Elf32_Shdr& section = sections[symbol.st_shndx];
+                const u32 section_end = base_addr + section.sh_addr + section.sh_size;
+                size = section_end > address ? section_end - address : 0;
+            }
+            functions.push_back({address, size, symbol.st_size != 0,
+                                 std::string(strings + symbol.st_name,
+                                             strnlen(strings + symbol.st_name,
+                                                     strings_size - symbol.st_name))});
+        }
+    }
+
+    std::sort(functions.begin(), functions.end(),
+              [](const auto& a, const auto& b) { return a.address < b.address; });
+    for (std::size_t i = 0, next = 0; i < functions.size(); ++i) {
+        FunctionSymbol& function = functions[i];
+        while (next < functions.size() && functions[next].address <= function.address) {
+            ++next;
+        }
+        if (!function.sized && next < functions.size()) {
+            function.size = std::min(function.size, functions[next].address - function.address);
+        }
+        if (function.size != 0) {
+            callback(function.address, function.size, std::move(function.name));
+        }
+    }
+}
+
 SectionID ElfReader::GetSectionByName(const char* name, int firstSection) const {
     for (int i = firstSection; i < header->e_shnum; i++) {
         const char* secname = GetSectionName(i);
@@ -396,6 +465,13 @@ ResultStatus AppLoader_ELF::Load(std::shared_ptr<Kernel::Process>& process) {
     codeset->name = filename;
 
     process = Core::System::GetInstance().Kernel().CreateProcess(std::move(codeset));
+    if (auto* profiler = Core::System::GetInstance().GetGuestProfiler()) {
+        elf_reader.ForEachFunctionSymbol(Memory::PROCESS_IMAGE_VADDR,
+                                         [&](u32 address, u32 size, std::string name) {
+                                             profiler->AddSymbol(process->process_id, address,
+                                                                 size, std::move(name));
+                                         });
+    }
     process->svc_access_mask.set();
     process->address_mappings = default_address_mappings;
 
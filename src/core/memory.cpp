@@ -2,8 +2,10 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <array>
 #include <cstring>
+#include <limits>
 #include "audio_core/dsp_interface.h"
 #include "common/assert.h"
 #include "common/common_types.h"
@@ -11,6 +13,7 @@
 #include "common/swap.h"
 #include "core/arm/arm_interface.h"
 #include "core/core.h"
+#include "core/cpu_threads.h"
 #include "core/hle/kernel/memory.h"
 #include "core/hle/kernel/process.h"
 #include "core/hle/lock.h"
@@ -67,17 +70,122 @@ public:
     std::vector<PageTable*> page_table_list;
 
     AudioCore::DspInterface* dsp = nullptr;
+
+    PageTable* CurrentPageTable() const;
+
+    u8* GetPointerForRasterizerCache(VAddr addr) const;
+
+    /**
+     * Splits a range of guest memory into runs that can be accessed in the same way and calls
+     * `func(vaddr, type, pointer, size)` for each of them. Pages backed by host memory, including
+     * rasterizer-cached ones, are merged while they are contiguous in host memory, and `pointer`
+     * points to the host memory of the run. Special pages are reported one at a time, since each
+     * one may belong to a different MMIO handler. The first rasterizer-cached page flushes the
+     * rest of the range with `mode`, if any, so that it is flushed at most once.
+     */
+    template <typename Func>
+    void WalkBlock(const PageTable& page_table, VAddr addr, std::size_t size,
+                   std::optional<FlushMode> mode, Func&& func);
 };
 
+u8* MemorySystem::Impl::GetPointerForRasterizerCache(VAddr addr) const {
+    if (addr >= LINEAR_HEAP_VADDR && addr < LINEAR_HEAP_VADDR_END) {
+        return fcram.get() + (addr - LINEAR_HEAP_VADDR);
+    }
+    if (addr >= NEW_LINEAR_HEAP_VADDR && addr < NEW_LINEAR_HEAP_VADDR_END) {
+        return fcram.get() + (addr - NEW_LINEAR_HEAP_VADDR);
+    }
+    if (addr >= VRAM_VADDR && addr < VRAM_VADDR_END) {
+        return vram.get() + (addr - VRAM_VADDR);
+    }
+    UNREACHABLE();
+}
+
+template <typename Func>
+void MemorySystem::Impl::WalkBlock(const PageTable& page_table, VAddr addr, std::size_t size,
+                                   std::optional<FlushMode> mode, Func&& func) {
+    bool flushed = !mode.has_value();
+    const auto get_pointer = [&](VAddr vaddr, PageType type) -> u8* {
+        switch (type) {
+        case PageType::Unmapped:
+        case PageType::Special:
+            return nullptr;
+        case PageType::Memory:
+            DEBUG_ASSERT(page_table.pointers[vaddr >> PAGE_BITS]);
+            return page_table.pointers[vaddr >> PAGE_BITS] + (vaddr & PAGE_MASK);
+        case PageType::RasterizerCachedMemory:
+            if (!flushed) {
+                RasterizerFlushVirtualRegion(vaddr, static_cast<u32>(size - (vaddr - addr)), *mode);
+                flushed = true;
+            }
+            return GetPointerForRasterizerCache(vaddr);
+        default:
+            UNREACHABLE();
+        }
+    };
+
+    while (size > 0) {
+        const PageType type = page_table.attributes[addr >> PAGE_BITS];
+        u8* const pointer = get_pointer(addr, type);
+        std::size_t run_size = std::min<std::size_t>(PAGE_SIZE - (addr & PAGE_MASK), size);
+
+        if (type != PageType::Special) {
+            while (run_size < size) {
+                const VAddr next = addr + static_cast<VAddr>(run_size);
+                if (page_table.attributes[next >> PAGE_BITS] != type ||
+                    (pointer != nullptr && get_pointer(next, type) != pointer + run_size)) {
+                    break;
+                }
+                run_size += std::min<std::size_t>(PAGE_SIZE, size - run_size);
+            }
+        }
+
+        func(addr, type, pointer, run_size);
+        addr += static_cast<VAddr>(run_size);
+        size -= run_size;
+    }
+}
+
+namespace {
+/// Page table of the calling host thread, used instead of the shared one by threads running a
+/// single core
+thread_local bool uses_thread_page_table = false;
+thread_local PageTable* thread_page_table = nullptr;
+
+/// Runs an access to emulated hardware. Host threads running a single core hand it over to the
+/// emulation thread, which owns the GPU and its rasterizer.
+template <typename Function>
+void AccessHardware(Function&& access) {
+    if (Core::CPUThreads::IsCoreThread()) {
+        Core::CPUThreads::RunOnEmulationThread(access);
+    } else {
+        access();
+    }
+}
+} // Anonymous namespace
+
+PageTable* MemorySystem::Impl::CurrentPageTable() const {
+    return uses_thread_page_table ? thread_page_table : current_page_table;
+}
+
 MemorySystem::MemorySystem() : impl(std::make_unique<Impl>()) {}
 MemorySystem::~MemorySystem() = default;
 
 void MemorySystem::SetCurrentPageTable(PageTable* page_table) {
-    impl->current_page_table = page_table;
+    if (uses_thread_page_table) {
+        thread_page_table = page_table;
+    } else {
+        impl->current_page_table = page_table;
+    }
 }
 
 PageTable* MemorySystem::GetCurrentPageTable() const {
-    return impl->current_page_table;
+    return impl->CurrentPageTable();
+}
+
+void MemorySystem::UseThreadLocalPageTable() {
+    thread_page_table = impl->current_page_table;
+    uses_thread_page_table = true;
 }
 
 void MemorySystem::MapPages(PageTable& page_table, u32 base, u32 size, u8* memory, PageType type) {
@@ -87,22 +195,22 @@ void MemorySystem::MapPages(PageTable& page_table, u32 base, u32 size, u8* memor
     RasterizerFlushVirtualRegion(base << PAGE_BITS, size * PAGE_SIZE,
                                  FlushMode::FlushAndInvalidate);
 
-    u32 end = base + size;
-    while (base != end) {
-        ASSERT_MSG(base < PAGE_TABLE_NUM_ENTRIES, "out of range mapping at {:08X}", base);
-
-        page_table.attributes[base] = type;
-        page_table.pointers[base] = memory;
-
-        // If the memory to map is already rasterizer-cached, mark the page
-        if (type == PageType::Memory && impl->cache_marker.IsCached(base * PAGE_SIZE)) {
-            page_table.attributes[base] = PageType::RasterizerCachedMemory;
-            page_table.pointers[base] = nullptr;
+    const u32 end = base + size;
+    ASSERT_MSG(end <= PAGE_TABLE_NUM_ENTRIES, "out of range mapping at {:08X}", base);
+
+    std::fill_n(page_table.attributes.begin() + base, size, type);
+    if (type != PageType::Memory) {
+        std::fill_n(page_table.pointers.begin() + base, size, nullptr);
+    } else {
+        for (u32 page = base; page != end; ++page, memory += PAGE_SIZE) {
+            // If the memory to map is already rasterizer-cached, mark the page
+            if (impl->cache_marker.IsCached(page * PAGE_SIZE)) {
+                page_table.attributes[page] = PageType::RasterizerCachedMemory;
+                page_table.pointers[page] = nullptr;
+            } else {
+                page_table.pointers[page] = memory;
+            }
         }
-
-        base += 1;
-        if (memory != nullptr)
-            memory += PAGE_SIZE;
     }
 }
 
@@ -119,6 +227,23 @@ void MemorySystem::MapIoRegion(PageTable& page_table, VAddr base, u32 size,
     MapPages(page_table, base / PAGE_SIZE, size / PAGE_SIZE, nullptr, PageType::Special);
 
     page_table.special_regions.emplace_back(SpecialRegion{base, size, mmio_handler});
+    ASSERT_MSG(page_table.special_regions.size() <= std::numeric_limits<u16>::max(),
+               "too many IO regions");
+    const auto index = static_cast<u16>(page_table.special_regions.size());
+
+    constexpr std::size_t CHUNK_PAGES = PageTable::SPECIAL_INDEX_CHUNK_PAGES;
+    auto& chunks = page_table.special_region_index;
+    chunks.resize(PAGE_TABLE_NUM_ENTRIES / CHUNK_PAGES);
+    const std::size_t first_page = base / PAGE_SIZE;
+    const std::size_t end_page = first_page + size / PAGE_SIZE;
+    for (std::size_t page = first_page; page < end_page;) {
+        auto& chunk = chunks[page / CHUNK_PAGES];
+        chunk.resize(CHUNK_PAGES);
+        const std::size_t offset = page % CHUNK_PAGES;
+        const std::size_t count = std::min(end_page - page, CHUNK_PAGES - offset);
+        std::fill_n(chunk.begin() + offset, count, index);
+        page += count;
+    }
 }
 
 void MemorySystem::UnmapRegion(PageTable& page_table, VAddr base, u32 size) {
@@ -128,16 +253,7 @@ void MemorySystem::UnmapRegion(PageTable& page_table, VAddr base, u32 size) {
 }
 
 u8* MemorySystem::GetPointerForRasterizerCache(VAddr addr) {
-    if (addr >= LINEAR_HEAP_VADDR && addr < LINEAR_HEAP_VADDR_END) {
-        return impl->fcram.get() + (addr - LINEAR_HEAP_VADDR);
-    }
-    if (addr >= NEW_LINEAR_HEAP_VADDR && addr < NEW_LINEAR_HEAP_VADDR_END) {
-        return impl->fcram.get() + (addr - NEW_LINEAR_HEAP_VADDR);
-    }
-    if (addr >= VRAM_VADDR && addr < VRAM_VADDR_END) {
-        return impl->vram.get() + (addr - VRAM_VADDR);
-    }
-    UNREACHABLE();
+    return impl->GetPointerForRasterizerCache(addr);
 }
 
 void MemorySystem::RegisterPageTable(PageTable* page_table) {
@@ -153,9 +269,12 @@ void MemorySystem::UnregisterPageTable(PageTable* page_table) {
  * This function should only be called for virtual addreses with attribute `PageType::Special`.
  */
 static MMIORegionPointer GetMMIOHandler(const PageTable& page_table, VAddr vaddr) {
-    for (const auto& region : page_table.special_regions) {
-        if (vaddr >= region.base && vaddr < (region.base + region.size)) {
-            return region.handler;
+    constexpr std::size_t CHUNK_PAGES = PageTable::SPECIAL_INDEX_CHUNK_PAGES;
+    const std::size_t page = vaddr >> PAGE_BITS;
+    if (!page_table.special_region_index.empty()) {
+        const auto& chunk = page_table.special_region_index[page / CHUNK_PAGES];
+        if (!chunk.empty() && chunk[page % CHUNK_PAGES] != 0) {
+            return page_table.special_regions[chunk[page % CHUNK_PAGES] - 1].handler;
         }
     }
     ASSERT_MSG(false, "Mapped IO page without a handler @ {:08X}", vaddr);
@@ -167,7 +286,7 @@ T ReadMMIO(MMIORegionPointer mmio_handler, VAddr addr);
 
 template <typename T>
 T MemorySystem::Read(const VAddr vaddr) {
-    const u8* page_pointer = impl->current_page_table->pointers[vaddr >> PAGE_BITS];
+    const u8* page_pointer = impl->CurrentPageTable()->pointers[vaddr >> PAGE_BITS];
     if (page_pointer) {
         // NOTE: Avoid adding any extra logic to this fast-path block
         T value;
@@ -175,7 +294,7 @@ T MemorySystem::Read(const VAddr vaddr) {
         return value;
     }
 
-    PageType type = impl->current_page_table->attributes[vaddr >> PAGE_BITS];
+    PageType type = impl->CurrentPageTable()->attributes[vaddr >> PAGE_BITS];
     switch (type) {
     case PageType::Unmapped:
         LOG_ERROR(HW_Memory, "unmapped Read{} @ 0x{:08X}", sizeof(T) * 8, vaddr);
@@ -184,14 +303,19 @@ T MemorySystem::Read(const VAddr vaddr) {
         ASSERT_MSG(false, "Mapped memory page without a pointer @ {:08X}", vaddr);
         break;
     case PageType::RasterizerCachedMemory: {
-        RasterizerFlushVirtualRegion(vaddr, sizeof(T), FlushMode::Flush);
-
         T value;
-        std::memcpy(&value, GetPointerForRasterizerCache(vaddr), sizeof(T));
+        AccessHardware([&] {
+            RasterizerFlushVirtualRegion(vaddr, sizeof(T), FlushMode::Flush);
+            std::memcpy(&value, GetPointerForRasterizerCache(vaddr), sizeof(T));
+        });
+        return value;
+    }
+    case PageType::Special: {
+        const auto mmio_handler = GetMMIOHandler(*impl->CurrentPageTable(), vaddr);
+        T value;
+        AccessHardware([&] { value = ReadMMIO<T>(mmio_handler, vaddr); });
         return value;
     }
-    case PageType::Special:
-        return ReadMMIO<T>(GetMMIOHandler(*impl->current_page_table, vaddr), vaddr);
     default:
         UNREACHABLE();
     }
@@ -202,14 +326,14 @@ void WriteMMIO(MMIORegionPointer mmio_handler, VAddr addr, const T data);
 
 template <typename T>
 void MemorySystem::Write(const VAddr vaddr, const T data) {
-    u8* page_pointer = impl->current_page_table->pointers[vaddr >> PAGE_BITS];
+    u8* page_pointer = impl->CurrentPageTable()->pointers[vaddr >> PAGE_BITS];
     if (page_pointer) {
         // NOTE: Avoid adding any extra logic to this fast-path block
         std::memcpy(&page_pointer[vaddr & PAGE_MASK], &data, sizeof(T));
         return;
     }
 
-    PageType type = impl->current_page_table->attributes[vaddr >> PAGE_BITS];
+    PageType type = impl->CurrentPageTable()->attributes[vaddr >> PAGE_BITS];
     switch (type) {
     case PageType::Unmapped:
         LOG_ERROR(HW_Memory, "unmapped Write{} 0x{:08X} @ 0x{:08X}", sizeof(data) * 8, (u32)data,
@@ -219,13 +343,17 @@ void MemorySystem::Write(const VAddr vaddr, const T data) {
         ASSERT_MSG(false, "Mapped memory page without a pointer @ {:08X}", vaddr);
         break;
     case PageType::RasterizerCachedMemory: {
-        RasterizerFlushVirtualRegion(vaddr, sizeof(T), FlushMode::Invalidate);
-        std::memcpy(GetPointerForRasterizerCache(vaddr), &data, sizeof(T));
+        AccessHardware([&] {
+            RasterizerFlushVirtualRegion(vaddr, sizeof(T), FlushMode::Invalidate);
+            std::memcpy(GetPointerForRasterizerCache(vaddr), &data, sizeof(T));
+        });
         break;
     }
-    case PageType::Special:
-        WriteMMIO<T>(GetMMIOHandler(*impl->current_page_table, vaddr), vaddr, data);
+    case PageType::Special: {
+        const auto mmio_handler = GetMMIOHandler(*impl->CurrentPageTable(), vaddr);
+        AccessHardware([&] { WriteMMIO<T>(mmio_handler, vaddr, data); });
         break;
+    }
     default:
         UNREACHABLE();
     }
@@ -257,12 +385,12 @@ bool MemorySystem::IsValidPhysicalAddress(const PAddr paddr) {
 }
 
 u8* MemorySystem::GetPointer(const VAddr vaddr) {
-    u8* page_pointer = impl->current_page_table->pointers[vaddr >> PAGE_BITS];
+    u8* page_pointer = impl->CurrentPageTable()->pointers[vaddr >> PAGE_BITS];
     if (page_pointer) {
         return page_pointer + (vaddr & PAGE_MASK);
     }
 
-    if (impl->current_page_table->attributes[vaddr >> PAGE_BITS] ==
+    if (impl->CurrentPageTable()->attributes[vaddr >> PAGE_BITS] ==
         PageType::RasterizerCachedMemory) {
         return GetPointerForRasterizerCache(vaddr);
     }
@@ -485,52 +613,31 @@ u64 MemorySystem::Read64(const VAddr addr) {
 
 void MemorySystem::ReadBlock(const Kernel::Process& process, const VAddr src_addr,
                              void* dest_buffer, const std::size_t size) {
-    auto& page_table = process.vm_manager.page_table;
-
-    std::size_t remaining_size = size;
-    std::size_t page_index = src_addr >> PAGE_BITS;
-    std::size_t page_offset = src_addr & PAGE_MASK;
-
-    while (remaining_size > 0) {
-        const std::size_t copy_amount = std::min(PAGE_SIZE - page_offset, remaining_size);
-        const VAddr current_vaddr = static_cast<VAddr>((page_index << PAGE_BITS) + page_offset);
-
-        switch (page_table.attributes[page_index]) {
-        case PageType::Unmapped: {
-            LOG_ERROR(HW_Memory,
-                      "unmapped ReadBlock @ 0x{:08X} (start address = 0x{:08X}, size = {})",
-                      current_vaddr, src_addr, size);
-            std::memset(dest_buffer, 0, copy_amount);
-            break;
-        }
-        case PageType::Memory: {
-            DEBUG_ASSERT(page_table.pointers[page_index]);
-
-            const u8* src_ptr = page_table.pointers[page_index] + page_offset;
-            std::memcpy(dest_buffer, src_ptr, copy_amount);
-            break;
-        }
-        case PageType::Special: {
-            MMIORegionPointer handler = GetMMIOHandler(page_table, current_vaddr);
-            DEBUG_ASSERT(handler);
-            handler->ReadBlock(current_vaddr, dest_buffer, copy_amount);
-            break;
-        }
-        case PageType::RasterizerCachedMemory: {
-            RasterizerFlushVirtualRegion(current_vaddr, static_cast<u32>(copy_amount),
-                                         FlushMode::Flush);
-            std::memcpy(dest_buffer, GetPointerForRasterizerCache(current_vaddr), copy_amount);
-            break;
-        }
-        default:
-            UNREACHABLE();
-        }
-
-        page_index++;
-        page_offset = 0;
-        dest_buffer = static_cast<u8*>(dest_buffer) + copy_amount;
-        remaining_size -= copy_amount;
-    }
+    const auto& page_table = process.vm_manager.page_table;
+    u8* dest = static_cast<u8*>(dest_buffer);
+
+    impl->WalkBlock(page_table, src_addr, size, FlushMode::Flush,
+                    [&](VAddr current_vaddr, PageType type, u8* pointer, std::size_t copy_amount) {
+                        switch (type) {
+                        case PageType::Unmapped:
+                            LOG_ERROR(HW_Memory,
+                                      "unmapped ReadBlock @ 0x{:08X} (start address = 0x{:08X}, "
+                                      "size = {})",
+                                      current_vaddr, src_addr, size);
+                            std::memset(dest, 0, copy_amount);
+                            break;
+                        case PageType::Special: {
+                            MMIORegionPointer handler = GetMMIOHandler(page_table, current_vaddr);
+                            DEBUG_ASSERT(handler);
+                            handler->ReadBlock(current_vaddr, dest, copy_amount);
+                            break;
+                        }
+                        default:
+                            std::memcpy(dest, pointer, copy_amount);
+                            break;
+                        }
+                        dest += copy_amount;
+                    });
 }
 
 void MemorySystem::Write8(const VAddr addr, const u8 data) {
@@ -551,99 +658,58 @@ void MemorySystem::Write64(const VAddr addr, const u64 data) {
 
 void MemorySystem::WriteBlock(const Kernel::Process& process, const VAddr dest_addr,
                               const void* src_buffer, const std::size_t size) {
-    auto& page_table = process.vm_manager.page_table;
-    std::size_t remaining_size = size;
-    std::size_t page_index = dest_addr >> PAGE_BITS;
-    std::size_t page_offset = dest_addr & PAGE_MASK;
-
-    while (remaining_size > 0) {
-        const std::size_t copy_amount = std::min(PAGE_SIZE - page_offset, remaining_size);
-        const VAddr current_vaddr = static_cast<VAddr>((page_index << PAGE_BITS) + page_offset);
-
-        switch (page_table.attributes[page_index]) {
-        case PageType::Unmapped: {
-            LOG_ERROR(HW_Memory,
-                      "unmapped WriteBlock @ 0x{:08X} (start address = 0x{:08X}, size = {})",
-                      current_vaddr, dest_addr, size);
-            break;
-        }
-        case PageType::Memory: {
-            DEBUG_ASSERT(page_table.pointers[page_index]);
-
-            u8* dest_ptr = page_table.pointers[page_index] + page_offset;
-            std::memcpy(dest_ptr, src_buffer, copy_amount);
-            break;
-        }
-        case PageType::Special: {
-            MMIORegionPointer handler = GetMMIOHandler(page_table, current_vaddr);
-            DEBUG_ASSERT(handler);
-            handler->WriteBlock(current_vaddr, src_buffer, copy_amount);
-            break;
-        }
-        case PageType::RasterizerCachedMemory: {
-            RasterizerFlushVirtualRegion(current_vaddr, static_cast<u32>(copy_amount),
-                                         FlushMode::Invalidate);
-            std::memcpy(GetPointerForRasterizerCache(current_vaddr), src_buffer, copy_amount);
-            break;
-        }
-        default:
-            UNREACHABLE();
-        }
-
-        page_index++;
-        page_offset = 0;
-        src_buffer = static_cast<const u8*>(src_buffer) + copy_amount;
-        remaining_size -= copy_amount;
-    }
+    const auto& page_table = process.vm_manager.page_table;
+    const u8* src = static_cast<const u8*>(src_buffer);
+
+    impl->WalkBlock(page_table, dest_addr, size, FlushMode::Invalidate,
+                    [&](VAddr current_vaddr, PageType type, u8* pointer, std::size_t copy_amount) {
+                        switch (type) {
+                        case PageType::Unmapped:
+                            LOG_ERROR(HW_Memory,
+                                      "unmapped WriteBlock @ 0x{:08X} (start address = 0x{:08X}, "
+                                      "size = {})",
+                                      current_vaddr, dest_addr, size);
+                            break;
+                        case PageType::Special: {
+                            MMIORegionPointer handler = GetMMIOHandler(page_table, current_vaddr);
+                            DEBUG_ASSERT(handler);
+                            handler->WriteBlock(current_vaddr, src, copy_amount);
+                            break;
+                        }
+                        default:
+                            std::memcpy(pointer, src, copy_amount);
+                            break;
+                        }
+                        src += copy_amount;
+                    });
 }
 
 void MemorySystem::ZeroBlock(const Kernel::Process& process, const VAddr dest_addr,
                              const std::size_t size) {
-    auto& page_table = process.vm_manager.page_table;
-    std::size_t remaining_size = size;
-    std::size_t page_index = dest_addr >> PAGE_BITS;
-    std::size_t page_offset = dest_addr & PAGE_MASK;
+    const auto& page_table = process.vm_manager.page_table;
 
     static const std::array<u8, PAGE_SIZE> zeros = {};
 
-    while (remaining_size > 0) {
-        const std::size_t copy_amount = std::min(PAGE_SIZE - page_offset, remaining_size);
-        const VAddr current_vaddr = static_cast<VAddr>((page_index << PAGE_BITS) + page_offset);
-
-        switch (page_table.attributes[page_index]) {
-        case PageType::Unmapped: {
-            LOG_ERROR(HW_Memory,
-                      "unmapped ZeroBlock @ 0x{:08X} (start address = 0x{:08X}, size = {})",
-                      current_vaddr, dest_addr, size);
-            break;
-        }
-        case PageType::Memory: {
-            DEBUG_ASSERT(page_table.pointers[page_index]);
-
-            u8* dest_ptr = page_table.pointers[page_index] + page_offset;
-            std::memset(dest_ptr, 0, copy_amount);
-            break;
-        }
-        case PageType::Special: {
-            MMIORegionPointer handler = GetMMIOHandler(page_table, current_vaddr);
-            DEBUG_ASSERT(handler);
-            handler->WriteBlock(current_vaddr, zeros.data(), copy_amount);
-            break;
-        }
-        case PageType::RasterizerCachedMemory: {
-            RasterizerFlushVirtualRegion(current_vaddr, static_cast<u32>(copy_amount),
-                                         FlushMode::Invalidate);
-            std::memset(GetPointerForRasterizerCache(current_vaddr), 0, copy_amount);
-            break;
-        }
-        default:
-            UNREACHABLE();
-        }
-
-        page_index++;
-        page_offset = 0;
-        remaining_size -= copy_amount;
-    }
+    impl->WalkBlock(page_table, dest_addr, size, FlushMode::Invalidate,
+                    [&](VAddr current_vaddr, PageType type, u8* pointer, std::size_t copy_amount) {
+                        switch (type) {
+                        case PageType::Unmapped:
+                            LOG_ERROR(HW_Memory,
+                                      "unmapped ZeroBlock @ 0x{:08X} (start address = 0x{:08X}, "
+                                      "size = {})",
+                                      current_vaddr, dest_addr, size);
+                            break;
+                        case PageType::Special: {
+                            MMIORegionPointer handler = GetMMIOHandler(page_table, current_vaddr);
+                            DEBUG_ASSERT(handler);
+                            handler->WriteBlock(current_vaddr, zeros.data(), copy_amount);
+                            break;
+                        }
+                        default:
+                            std::memset(pointer, 0, copy_amount);
+                            break;
+                        }
+                    });
 }
 
 void MemorySystem::CopyBlock(const Kernel::Process& process, VAddr dest_addr, VAddr src_addr,
@@ -654,54 +720,43 @@ void MemorySystem::CopyBlock(const Kernel::Process& process, VAddr dest_addr, VA
 void MemorySystem::CopyBlock(const Kernel::Process& dest_process,
                              const Kernel::Process& src_process, VAddr dest_addr, VAddr src_addr,
                              std::size_t size) {
-    auto& page_table = src_process.vm_manager.page_table;
-    std::size_t remaining_size = size;
-    std::size_t page_index = src_addr >> PAGE_BITS;
-    std::size_t page_offset = src_addr & PAGE_MASK;
-
-    while (remaining_size > 0) {
-        const std::size_t copy_amount = std::min(PAGE_SIZE - page_offset, remaining_size);
-        const VAddr current_vaddr = static_cast<VAddr>((page_index << PAGE_BITS) + page_offset);
-
-        switch (page_table.attributes[page_index]) {
-        case PageType::Unmapped: {
-            LOG_ERROR(HW_Memory,
-                      "unmapped CopyBlock @ 0x{:08X} (start address = 0x{:08X}, size = {})",
-                      current_vaddr, src_addr, size);
-            ZeroBlock(dest_process, dest_addr, copy_amount);
-            break;
-        }
-        case PageType::Memory: {
-            DEBUG_ASSERT(page_table.pointers[page_index]);
-            const u8* src_ptr = page_table.pointers[page_index] + page_offset;
-            WriteBlock(dest_process, dest_addr, src_ptr, copy_amount);
-            break;
-        }
-        case PageType::Special: {
-            MMIORegionPointer handler = GetMMIOHandler(page_table, current_vaddr);
-            DEBUG_ASSERT(handler);
-            std::vector<u8> buffer(copy_amount);
-            handler->ReadBlock(current_vaddr, buffer.data(), buffer.size());
-            WriteBlock(dest_process, dest_addr, buffer.data(), buffer.size());
-            break;
-        }
-        case PageType::RasterizerCachedMemory: {
-            RasterizerFlushVirtualRegion(current_vaddr, static_cast<u32>(copy_amount),
-                                         FlushMode::Flush);
-            WriteBlock(dest_process, dest_addr, GetPointerForRasterizerCache(current_vaddr),
-                       copy_amount);
-            break;
-        }
-        default:
-            UNREACHABLE();
-        }
-
-        page_index++;
-        page_offset = 0;
-        dest_addr += static_cast<VAddr>(copy_amount);
-        src_addr += static_cast<VAddr>(copy_amount);
-        remaining_size -= copy_amount;
-    }
+    const auto& page_table = src_process.vm_manager.page_table;
+
+    impl->WalkBlock(page_table, src_addr, size, FlushMode::Flush,
+                    [&](VAddr current_vaddr, PageType type, u8* pointer, std::size_t copy_amount) {
+                        switch (type) {
+                        case PageType::Unmapped:
+                            LOG_ERROR(HW_Memory,
+                                      "unmapped CopyBlock @ 0x{:08X} (start address = 0x{:08X}, "
+                                      "size = {})",
+                                      current_vaddr, src_addr, size);
+                            ZeroBlock(dest_process, dest_addr, copy_amount);
+                            break;
+                        case PageType::Special: {
+                            MMIORegionPointer handler = GetMMIOHandler(page_table, current_vaddr);
+                            DEBUG_ASSERT(handler);
+                            std::vector<u8> buffer(copy_amount);
+                            handler->ReadBlock(current_vaddr, buffer.data(), buffer.size());
+                            WriteBlock(dest_process, dest_addr, buffer.data(), buffer.size());
+                            break;
+                        }
+                        default:
+                            WriteBlock(dest_process, dest_addr, pointer, copy_amount);
+                            break;
+                        }
+                        dest_addr += static_cast<VAddr>(copy_amount);
+                    });
+}
+
+std::vector<MemorySpan> MemorySystem::GetSpans(const Kernel::Process& process, VAddr addr,
+                                               std::size_t size, std::optional<FlushMode> mode) {
+    std::vector<MemorySpan> spans;
+    impl->WalkBlock(process.vm_manager.page_table, addr, size, mode,
+                    [&spans](VAddr vaddr, PageType type, u8* pointer, std::size_t span_size) {
+                        spans.push_back({vaddr, pointer, span_size,
+                                         type == PageType::RasterizerCachedMemory});
+                    });
+    return spans;
 }
 
 template <>
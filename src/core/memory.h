@@ -7,6 +7,7 @@
 #include <array>
 #include <cstddef>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 #include "common/common_types.h"
@@ -73,6 +74,16 @@ struct PageTable {
      */
     std::vector<SpecialRegion> special_regions;
 
+    /// Number of pages covered by each chunk of `special_region_index`.
+    static constexpr std::size_t SPECIAL_INDEX_CHUNK_PAGES = 1024;
+
+    /**
+     * Index into `special_regions`, plus one, of the region that backs each page of type
+     * `Special`. Split into chunks of SPECIAL_INDEX_CHUNK_PAGES pages, which are only allocated
+     * once an IO region is mapped into them, so page tables without IO regions stay small.
+     */
+    std::vector<std::vector<u16>> special_region_index;
+
     /**
      * Array of fine grained page attributes. If it is set to any value other than `Memory`, then
      * the corresponding entry in `pointers` MUST be set to null.
@@ -215,6 +226,16 @@ enum class FlushMode {
  */
 void RasterizerFlushVirtualRegion(VAddr start, u32 size, FlushMode mode);
 
+/// A part of a range of guest memory that is contiguous in host memory.
+struct MemorySpan {
+    VAddr vaddr;
+    /// Host memory backing the span, or null if it is MMIO or unmapped
+    u8* pointer;
+    std::size_t size;
+    /// Whether the span is rasterizer-cached memory
+    bool rasterizer_cached;
+};
+
 class MemorySystem {
 public:
     MemorySystem();
@@ -245,6 +266,12 @@ public:
     void SetCurrentPageTable(PageTable* page_table);
     PageTable* GetCurrentPageTable() const;
 
+    /**
+     * Makes the calling host thread keep its own active page table, so that threads running
+     * different cores can access memory through different address spaces at the same time.
+     */
+    void UseThreadLocalPageTable();
+
     u8 Read8(VAddr addr);
     u16 Read16(VAddr addr);
     u32 Read32(VAddr addr);
@@ -267,6 +294,18 @@ public:
 
     std::string ReadCString(VAddr vaddr, std::size_t max_length);
 
+    /**
+     * Gets the host memory backing a range of the address space of a process, so that it can be
+     * accessed in place instead of being copied through ReadBlock/WriteBlock. Pages that are
+     * contiguous in host memory are merged into one span. Rasterizer-cached parts of the range are
+     * flushed with `mode` first, using a single flush for the whole range. Without a mode, nothing
+     * is flushed, and the caller has to flush the rasterizer-cached spans it accesses itself. Spans
+     * that are not backed by host memory have a null pointer and have to be accessed through
+     * ReadBlock/WriteBlock.
+     */
+    std::vector<MemorySpan> GetSpans(const Kernel::Process& process, VAddr addr, std::size_t size,
+                                     std::optional<FlushMode> mode);
+
     /**
      * Gets a pointer to the memory region beginning at the specified physical address.
      */
@@ -75,6 +75,10 @@ void LogSetting(const std::string& name, const T& value) {
 void LogSettings() {
     LOG_INFO(Config, "Citra Configuration:");
     LogSetting("Core_UseCpuJit", Settings::values.use_cpu_jit);
+    LogSetting("Core_UseCpuThreads", Settings::values.use_cpu_threads);
+    LogSetting("Core_DeterministicCpuThreads", Settings::values.deterministic_cpu_threads);
+    LogSetting("Core_SkipIdleLoops", Settings::values.skip_idle_loops);
+    LogSetting("Core_UseVfpHostFpu", Settings::values.use_vfp_host_fpu);
     LogSetting("Renderer_UseGLES", Settings::values.use_gles);
     LogSetting("Renderer_UseHwRenderer", Settings::values.use_hw_renderer);
     LogSetting("Renderer_UseHwShader", Settings::values.use_hw_shader);
@@ -112,8 +116,12 @@ void LogSettings() {
     LogSetting("Camera_OuterLeftConfig", Settings::values.camera_config[OuterLeftCamera]);
     LogSetting("Camera_OuterLeftFlip", Settings::values.camera_flip[OuterLeftCamera]);
     LogSetting("DataStorage_UseVirtualSd", Settings::values.use_virtual_sd);
+    LogSetting("DataStorage_CacheDecryptedContent", Settings::values.cache_decrypted_content);
+    LogSetting("DataStorage_ContentCacheSizeMb", Settings::values.content_cache_size_mb);
     LogSetting("System_IsNew3ds", Settings::values.is_new_3ds);
     LogSetting("System_RegionValue", Settings::values.region_value);
+    LogSetting("Debugging_GuestProfilerRate", Settings::values.guest_profiler_rate);
+    LogSetting("Debugging_DumpServiceMetrics", Settings::values.dump_service_metrics);
     LogSetting("Debugging_UseGdbstub", Settings::values.use_gdbstub);
     LogSetting("Debugging_GdbstubPort", Settings::values.gdbstub_port);
 }
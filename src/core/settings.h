@@ -129,9 +129,15 @@ struct Values {
     // Core
     bool use_cpu_jit;
     int cpu_clock_percentage;
+    bool use_cpu_threads;
+    bool deterministic_cpu_threads;
+    bool skip_idle_loops;
+    bool use_vfp_host_fpu;
 
     // Data Storage
     bool use_virtual_sd;
+    bool cache_decrypted_content;
+    u32 content_cache_size_mb;
 
     // System
     int region_value;
@@ -196,6 +202,8 @@ struct Values {
 
     // Debugging
     bool record_frame_times;
+    u32 guest_profiler_rate;
+    bool dump_service_metrics;
     bool use_gdbstub;
     u16 gdbstub_port;
     std::string log_filter;
@@ -0,0 +1,46 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "common/file_util.h"
+
+namespace FileUtil {
+
+TEST_CASE("MappedFile: maps the contents of a file", "[common]") {
+    const std::string path = GetCurrentDir().value_or(".") + "/mapped_file_test.bin";
+    std::vector<u8> data(0x12345);
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<u8>(i * 13);
+    }
+    {
+        IOFile file(path, "wb");
+        REQUIRE(file.WriteBytes(data.data(), data.size()) == data.size());
+    }
+
+    MappedFile mapping;
+    {
+        IOFile file(path, "rb");
+        mapping = MappedFile(file);
+    }
+    REQUIRE(mapping.IsOpen());
+    REQUIRE(mapping.GetSize() == data.size());
+    mapping.Advise(0x1234, 0x20000, MappedFile::AccessHint::Sequential);
+    CHECK(std::equal(data.begin(), data.end(), mapping.Data()));
+
+    // Empty files can't be mapped
+    {
+        IOFile file(path, "wb");
+    }
+    IOFile file(path, "rb");
+    CHECK(!MappedFile(file).IsOpen());
+
+    file.Close();
+    mapping = MappedFile();
+    Delete(path);
+}
+
+} // namespace FileUtil
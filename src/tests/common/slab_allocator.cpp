@@ -0,0 +1,107 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <fmt/format.h>
+#include "common/slab_allocator.h"
+
+namespace Common {
+
+namespace {
+struct Counted {
+    explicit Counted(int value) : value(value) {
+        ++alive;
+    }
+    ~Counted() {
+        --alive;
+    }
+
+    int value;
+    static int alive;
+};
+int Counted::alive = 0;
+} // Anonymous namespace
+
+TEST_CASE("SlabAllocator: objects are recycled", "[common]") {
+    auto first = MakeSlabShared<Counted>(1);
+    auto second = MakeSlabShared<Counted>(2);
+    REQUIRE(Counted::alive == 2);
+    CHECK(first->value == 1);
+    CHECK(second->value == 2);
+    CHECK(first.get() != second.get());
+
+    // The block freed last is handed out first
+    const Counted* freed = second.get();
+    second.reset();
+    CHECK(Counted::alive == 1);
+    auto third = MakeSlabShared<Counted>(3);
+    CHECK(third.get() == freed);
+    CHECK(third->value == 3);
+
+    // Growing the pool keeps existing objects intact
+    std::vector<std::shared_ptr<Counted>> many;
+    for (int i = 0; i < 1000; ++i) {
+        many.push_back(MakeSlabShared<Counted>(i));
+    }
+    CHECK(first->value == 1);
+    for (int i = 0; i < 1000; ++i) {
+        REQUIRE(many[i]->value == i);
+    }
+
+    many.clear();
+    first.reset();
+    third.reset();
+    CHECK(Counted::alive == 0);
+}
+
+namespace {
+/// Roughly the size of a kernel event, to compare the allocators with a realistic block size
+struct Payload {
+    explicit Payload(int value) {
+        data.fill(value);
+    }
+    std::array<int, 32> data;
+};
+
+template <typename MakeShared>
+double MeasureNsPerObject(MakeShared make_shared) {
+    constexpr int NUM_ROUNDS = 20000;
+    constexpr int OBJECTS_PER_ROUND = 64;
+
+    std::vector<std::shared_ptr<Payload>> objects;
+    objects.reserve(OBJECTS_PER_ROUND);
+    const auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < NUM_ROUNDS; ++round) {
+        // Create a batch of objects and destroy them again, like a game that recreates its sync
+        // objects every frame
+        for (int i = 0; i < OBJECTS_PER_ROUND; ++i) {
+            objects.push_back(make_shared(i));
+        }
+        objects.clear();
+    }
+    const std::chrono::duration<double, std::nano> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count() / (NUM_ROUNDS * OBJECTS_PER_ROUND);
+}
+} // Anonymous namespace
+
+TEST_CASE("SlabAllocator: MakeSlabShared against std::make_shared", "[.benchmark]") {
+    // Warm up both the pool and the heap
+    MeasureNsPerObject([](int value) { return MakeSlabShared<Payload>(value); });
+    MeasureNsPerObject([](int value) { return std::make_shared<Payload>(value); });
+
+    const double slab =
+        MeasureNsPerObject([](int value) { return MakeSlabShared<Payload>(value); });
+    const double heap =
+        MeasureNsPerObject([](int value) { return std::make_shared<Payload>(value); });
+    WARN(fmt::format("MakeSlabShared: {:.1f} ns, std::make_shared: {:.1f} ns per object", slab,
+                     heap));
+    REQUIRE(slab > 0);
+}
+
+} // namespace Common
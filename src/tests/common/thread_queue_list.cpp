@@ -0,0 +1,43 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch.hpp>
+#include "common/thread_queue_list.h"
+
+namespace Common {
+
+TEST_CASE("ThreadQueueList: threads are taken by priority, then in FIFO order", "[common]") {
+    ThreadQueueList<int, 96> queue;
+    REQUIRE(queue.get_first() == 0);
+    REQUIRE(queue.pop_first() == 0);
+
+    queue.push_back(80, 1);
+    queue.push_back(30, 2);
+    queue.push_back(30, 3);
+    queue.push_front(30, 4);
+    queue.push_back(70, 5);
+
+    REQUIRE(queue.get_first() == 4);
+    REQUIRE(queue.pop_first_better(30) == 0);
+    REQUIRE(queue.pop_first_better(31) == 4);
+    REQUIRE(queue.pop_first() == 2);
+
+    queue.move(5, 70, 10);
+    queue.remove(30, 3);
+    REQUIRE(queue.empty(30));
+    REQUIRE(queue.contains(5) == 10);
+    REQUIRE(queue.pop_first() == 5);
+
+    // Priority levels past the first 64 are found as well
+    REQUIRE(queue.pop_first_better(80) == 0);
+    REQUIRE(queue.pop_first() == 1);
+    REQUIRE(queue.get_first() == 0);
+
+    queue.push_back(95, 6);
+    queue.clear();
+    REQUIRE(queue.empty(95));
+    REQUIRE(queue.get_first() == 0);
+}
+
+} // namespace Common
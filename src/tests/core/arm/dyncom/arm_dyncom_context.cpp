@@ -0,0 +1,151 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <memory>
+#include <catch2/catch.hpp>
+#include <fmt/format.h>
+#include "core/arm/dyncom/arm_dyncom.h"
+#include "tests/core/arm/arm_test_common.h"
+
+namespace ArmTests {
+
+TEST_CASE("ARM_DynCom: VFP registers are switched lazily", "[arm_dyncom]") {
+    TestEnvironment test_env(false);
+    test_env.SetMemory32(0, 0xEE321A03); // vadd.f32 s2, s4, s6
+    test_env.SetMemory32(4, 0xEAFFFFFE); // b +#0
+
+    ARM_DynCom dyncom(nullptr, test_env.GetMemory(), USER32MODE, 0, nullptr);
+    const auto first = dyncom.NewContext();
+    const auto second = dyncom.NewContext();
+    first->SetCpsr(USER32MODE);
+    first->SetFpuRegister(0, 1);
+    first->SetFpscr(0x03000000);
+    second->SetCpsr(USER32MODE);
+    second->SetFpuRegister(4, 0x3F800000); // 1.0f
+    second->SetFpuRegister(6, 0x40000000); // 2.0f
+
+    dyncom.LoadContext(first);
+    CHECK(dyncom.GetVFPReg(0) == 1);
+    dyncom.SetVFPReg(0, 3);
+
+    // The first thread still owns the VFP registers, but its context is kept up to date
+    dyncom.SaveContext(first);
+    dyncom.LoadContext(second);
+    CHECK(first->GetFpuRegister(0) == 3);
+
+    // The registers of the second thread are loaded by its first VFP instruction
+    dyncom.Step();
+    CHECK(dyncom.GetVFPReg(2) == 0x40400000); // 3.0f
+    CHECK(dyncom.GetVFPSystemReg(VFP_FPSCR) == 0);
+    dyncom.SaveContext(second);
+
+    dyncom.LoadContext(first);
+    CHECK(second->GetFpuRegister(2) == 0x40400000);
+    CHECK(dyncom.GetVFPReg(0) == 3);
+    CHECK(dyncom.GetVFPSystemReg(VFP_FPSCR) == 0x03000000);
+
+    // A context that is modified while it is switched out gets loaded again
+    dyncom.SetVFPReg(0, 4);
+    dyncom.SaveContext(first);
+    CHECK(first->GetFpuRegister(0) == 4);
+    first->SetFpuRegister(0, 5);
+    dyncom.LoadContext(first);
+    CHECK(dyncom.GetVFPReg(0) == 5);
+}
+
+TEST_CASE("ARM_DynCom: VFP registers follow a thread across cores", "[arm_dyncom]") {
+    TestEnvironment test_env(false);
+    ARM_DynCom core0(nullptr, test_env.GetMemory(), USER32MODE, 0, nullptr);
+    ARM_DynCom core1(nullptr, test_env.GetMemory(), USER32MODE, 1, nullptr);
+    const auto thread = core0.NewContext();
+    const auto other = core0.NewContext();
+
+    core0.LoadContext(thread);
+    core0.SetVFPReg(0, 1);
+    core0.SaveContext(thread);
+    core0.LoadContext(other);
+    core0.SaveContext(other);
+
+    // The thread moves to the other core, which changes its registers
+    core1.LoadContext(thread);
+    CHECK(core1.GetVFPReg(0) == 1);
+    core1.SetVFPReg(0, 2);
+    core1.SaveContext(thread);
+
+    // The first core still has the old registers of the thread, which are stale now
+    core0.LoadContext(thread);
+    CHECK(core0.GetVFPReg(0) == 2);
+}
+
+TEST_CASE("ARM_DynCom: VFP registers are read safely after the thread of an idle core exits",
+          "[arm_dyncom]") {
+    TestEnvironment test_env(false);
+    ARM_DynCom dyncom(nullptr, test_env.GetMemory(), USER32MODE, 0, nullptr);
+    auto thread = dyncom.NewContext();
+    thread->SetFpuRegister(0, 1);
+
+    // The thread never touches the VFP, exits and is released while the core idles, as in
+    // ThreadManager::SwitchContext. Reading the registers then, as the debugger does, must not
+    // load them from the released context.
+    dyncom.LoadContext(thread);
+    dyncom.SaveContext(thread);
+    dyncom.UnloadContext();
+    thread.reset();
+    CHECK(dyncom.GetVFPReg(0) == 0);
+
+    // The same holds for a context that is released while the core still runs its thread
+    thread = dyncom.NewContext();
+    thread->SetFpuRegister(0, 2);
+    dyncom.LoadContext(thread);
+    thread.reset();
+    CHECK(dyncom.GetVFPReg(0) == 0);
+
+    // The next thread still gets its own registers
+    thread = dyncom.NewContext();
+    thread->SetFpuRegister(0, 3);
+    dyncom.LoadContext(thread);
+    CHECK(dyncom.GetVFPReg(0) == 3);
+}
+
+TEST_CASE("ARM_DynCom[ContextSwitch]", "[.benchmark]") {
+    constexpr int NUM_SWITCHES = 1000000;
+    constexpr int NUM_ROUNDS = 5;
+
+    TestEnvironment test_env(false);
+    ARM_DynCom dyncom(nullptr, test_env.GetMemory(), USER32MODE, 0, nullptr);
+    const std::array<std::unique_ptr<ARM_Interface::ThreadContext>, 2> contexts{
+        dyncom.NewContext(), dyncom.NewContext()};
+
+    // Either only one of the threads uses the VFP, as is the case for most switches between
+    // application and service threads, or both of them do. Single rounds are noisy, so the fastest
+    // one is reported.
+    u32 expected = 0;
+    for (const int vfp_threads : {1, 2}) {
+        std::chrono::duration<double> best = std::chrono::duration<double>::max();
+        for (int round = 0; round < NUM_ROUNDS; ++round) {
+            const auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < NUM_SWITCHES; ++i) {
+                const int next = i % 2;
+                dyncom.SaveContext(contexts[1 - next]);
+                dyncom.LoadContext(contexts[next]);
+                if (next < vfp_threads) {
+                    dyncom.SetVFPReg(0, dyncom.GetVFPReg(0) + 1);
+                }
+            }
+            best = std::min<std::chrono::duration<double>>(
+                best, std::chrono::steady_clock::now() - start);
+            expected += NUM_SWITCHES / 2;
+        }
+
+        WARN(fmt::format("{} switches with {} VFP thread(s) in {:.3f}s ({:.1f} ns per switch)",
+                         NUM_SWITCHES, vfp_threads, best.count(),
+                         best.count() * 1e9 / NUM_SWITCHES));
+    }
+    REQUIRE(contexts[0]->GetFpuRegister(0) == expected);
+}
+
+} // namespace ArmTests
@@ -0,0 +1,80 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch.hpp>
+#include "core/arm/dyncom/arm_dyncom_idle_loop.h"
+#include "tests/core/arm/arm_test_common.h"
+
+namespace ArmTests {
+
+TEST_CASE("FindIdleLoop: ARM", "[arm_dyncom]") {
+    TestEnvironment test_env(false);
+    u32 branch_addr = 0;
+
+    SECTION("polling loop") {
+        test_env.SetMemory32(0, 0xE5901000); // ldr r1, [r0]
+        test_env.SetMemory32(4, 0xE3510000); // cmp r1, #0
+        test_env.SetMemory32(8, 0x0AFFFFFC); // beq #0
+        CHECK(FindIdleLoop(test_env.GetMemory(), false, 0, branch_addr) == IdleLoopBranch::ARM);
+        CHECK(branch_addr == 8);
+    }
+
+    SECTION("loop that follows a pointer chain") {
+        test_env.SetMemory32(0, 0xE5900000); // ldr r0, [r0]
+        test_env.SetMemory32(4, 0xE3500000); // cmp r0, #0
+        test_env.SetMemory32(8, 0x1AFFFFFC); // bne #0
+        CHECK(FindIdleLoop(test_env.GetMemory(), false, 0, branch_addr) == IdleLoopBranch::NONE);
+    }
+
+    SECTION("loop that stores") {
+        test_env.SetMemory32(0, 0xE5801000); // str r1, [r0]
+        test_env.SetMemory32(4, 0xE3510000); // cmp r1, #0
+        test_env.SetMemory32(8, 0x0AFFFFFC); // beq #0
+        CHECK(FindIdleLoop(test_env.GetMemory(), false, 0, branch_addr) == IdleLoopBranch::NONE);
+    }
+
+    SECTION("branch that doesn't close the block") {
+        test_env.SetMemory32(0, 0xE5901000); // ldr r1, [r0]
+        test_env.SetMemory32(4, 0xE3510000); // cmp r1, #0
+        test_env.SetMemory32(8, 0x0A000000); // beq #16
+        CHECK(FindIdleLoop(test_env.GetMemory(), false, 0, branch_addr) == IdleLoopBranch::NONE);
+    }
+
+    SECTION("loop that crosses a page") {
+        test_env.SetMemory32(0xFF8, 0xE5901000); // ldr r1, [r0]
+        test_env.SetMemory32(0xFFC, 0xE3510000); // cmp r1, #0
+        test_env.SetMemory32(0x1000, 0x0AFFFFFC); // beq #0xFF8
+        CHECK(FindIdleLoop(test_env.GetMemory(), false, 0xFF8, branch_addr) ==
+              IdleLoopBranch::NONE);
+    }
+}
+
+TEST_CASE("FindIdleLoop: Thumb", "[arm_dyncom]") {
+    TestEnvironment test_env(false);
+    u32 branch_addr = 0;
+    test_env.SetMemory16(0x100, 0x6801); // ldr r1, [r0]
+    test_env.SetMemory16(0x102, 0x2900); // cmp r1, #0
+
+    SECTION("conditional branch") {
+        test_env.SetMemory16(0x104, 0xD0FC); // beq #0x100
+        CHECK(FindIdleLoop(test_env.GetMemory(), true, 0x100, branch_addr) ==
+              IdleLoopBranch::THUMB_COND);
+        CHECK(branch_addr == 0x104);
+    }
+
+    SECTION("unconditional branch") {
+        test_env.SetMemory16(0x104, 0xE7FC); // b #0x100
+        CHECK(FindIdleLoop(test_env.GetMemory(), true, 0x100, branch_addr) ==
+              IdleLoopBranch::THUMB);
+    }
+
+    SECTION("loop with side effects") {
+        test_env.SetMemory16(0x104, 0x3101); // adds r1, #1
+        test_env.SetMemory16(0x106, 0xD0FB); // beq #0x100
+        CHECK(FindIdleLoop(test_env.GetMemory(), true, 0x100, branch_addr) ==
+              IdleLoopBranch::NONE);
+    }
+}
+
+} // namespace ArmTests
@@ -0,0 +1,160 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include <memory>
+#include <new>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "core/arm/dyncom/arm_dyncom.h"
+#include "core/arm/dyncom/arm_dyncom_interpreter.h"
+#include "core/arm/dyncom/arm_dyncom_trans_cache.h"
+#include "core/arm/skyeye_common/armstate.h"
+#include "core/memory.h"
+#include "tests/core/arm/arm_test_common.h"
+
+namespace ArmTests {
+
+/// Translates a block that fills up the rest of the current segment.
+static void FillSegment(TranslationCache& cache, u32 pc) {
+    cache.BeginBlock(pc);
+    while (cache.HasSpaceForInstruction()) {
+        cache.Allocate(TranslationCache::MAX_INSTRUCTION_SIZE);
+    }
+}
+
+TEST_CASE("TranslationCache: lookup and invalidation", "[arm_dyncom]") {
+    auto cache = std::make_unique<TranslationCache>();
+
+    const std::size_t first = cache->BeginBlock(0x100000);
+    cache->Allocate(16);
+    const std::size_t second = cache->BeginBlock(0x100800);
+    cache->Allocate(16);
+    const std::size_t third = cache->BeginBlock(0x101000);
+    cache->Allocate(16);
+
+    REQUIRE(cache->FindBlock(0x100000) == first);
+    REQUIRE(cache->FindBlock(0x100800) == second);
+    REQUIRE(cache->FindBlock(0x101000) == third);
+    REQUIRE(!cache->FindBlock(0x100004));
+
+    // Translating new blocks keeps existing branch links valid
+    const u32 generation = cache->GetGeneration();
+    CHECK(generation != 0);
+
+    // Only blocks translated from the touched page are dropped
+    cache->InvalidateRange(0x100ffc, 4);
+    CHECK(cache->GetGeneration() != generation);
+    CHECK(!cache->FindBlock(0x100000));
+    CHECK(!cache->FindBlock(0x100800));
+    CHECK(cache->FindBlock(0x101000) == third);
+
+    cache->Clear();
+    CHECK(!cache->FindBlock(0x101000));
+}
+
+TEST_CASE("TranslationCache: oldest segment is recycled", "[arm_dyncom]") {
+    auto cache = std::make_unique<TranslationCache>();
+
+    for (u32 segment = 0; segment < TranslationCache::NUM_SEGMENTS; ++segment) {
+        FillSegment(*cache, segment * Memory::PAGE_SIZE);
+    }
+    for (u32 segment = 0; segment < TranslationCache::NUM_SEGMENTS; ++segment) {
+        REQUIRE(cache->FindBlock(segment * Memory::PAGE_SIZE));
+    }
+
+    // The cache is full, so the next block evicts everything from the first segment
+    const std::size_t offset = cache->BeginBlock(0x200000);
+    CHECK(offset == 0);
+    CHECK(cache->FindBlock(0x200000) == 0);
+    CHECK(!cache->FindBlock(0));
+    CHECK(cache->FindBlock(Memory::PAGE_SIZE));
+}
+
+TEST_CASE("InterpreterMainLoop: invalidating a branch target unlinks the branch", "[arm_dyncom]") {
+    TestEnvironment test_env(false);
+    Memory::MemorySystem& memory = test_env.GetMemory();
+    Memory::PageTable* const test_page_table = memory.GetCurrentPageTable();
+
+    // The branch and its target are on different pages, so the branch stays translated
+    std::vector<u8> code(2 * Memory::PAGE_SIZE);
+    const auto set_code = [&code](u32 addr, u32 instruction) {
+        std::memcpy(code.data() + addr, &instruction, sizeof(instruction));
+    };
+    set_code(0x0000, 0xEA0003FE); // b #0x1000
+    set_code(0x1000, 0xE3A00001); // mov r0, #1
+    set_code(0x1004, 0xEAFFFFFE); // b +#0
+
+    auto page_table = std::make_unique<Memory::PageTable>();
+    memory.MapMemoryRegion(*page_table, 0, 2 * Memory::PAGE_SIZE, code.data());
+    memory.SetCurrentPageTable(page_table.get());
+
+    auto cache = std::make_unique<TranslationCache>();
+    ARMul_State state(nullptr, memory, USER32MODE);
+    state.trans_cache = cache.get();
+    const auto run = [&state] {
+        state.Reg[0] = 0;
+        state.Reg[15] = 0;
+        state.NumInstrsToExecute = 2;
+        InterpreterMainLoop(&state);
+        return state.Reg[0];
+    };
+
+    // The first run links the branch, the second one follows the link
+    CHECK(run() == 1);
+    CHECK(run() == 1);
+
+    // The old translation of the target is still in the buffer, but the branch must not reach it
+    set_code(0x1000, 0xE3A00002); // mov r0, #2
+    cache->InvalidateRange(0x1000, 4);
+    CHECK(cache->FindBlock(0x0000));
+    CHECK(run() == 2);
+    CHECK(run() == 2);
+
+    memory.SetCurrentPageTable(test_page_table);
+}
+
+TEST_CASE("ARM_DynCom: code of a destroyed page table is dropped", "[arm_dyncom]") {
+    TestEnvironment test_env(false);
+    Memory::MemorySystem& memory = test_env.GetMemory();
+    Memory::PageTable* const test_page_table = memory.GetCurrentPageTable();
+    ARM_DynCom dyncom(nullptr, memory, USER32MODE, 0, nullptr);
+
+    std::vector<u8> code(Memory::PAGE_SIZE);
+    const auto set_code = [&code](u32 instruction) {
+        std::memcpy(code.data(), &instruction, sizeof(instruction));
+        const u32 loop = 0xEAFFFFFE; // b +#0
+        std::memcpy(code.data() + 4, &loop, sizeof(loop));
+    };
+    auto page_table = std::make_unique<Memory::PageTable>();
+    const auto run = [&] {
+        memory.SetCurrentPageTable(page_table.get());
+        dyncom.PageTableChanged();
+        dyncom.SetPC(0);
+        dyncom.Step();
+        return dyncom.GetReg(0);
+    };
+
+    memory.MapMemoryRegion(*page_table, 0, Memory::PAGE_SIZE, code.data());
+    set_code(0xE3A00001); // mov r0, #1
+    CHECK(run() == 1);
+
+    // The code isn't invalidated, so the translated block keeps being used
+    set_code(0xE3A00002); // mov r0, #2
+    CHECK(run() == 1);
+
+    // Free the page table while another one is current and allocate a new one at its address
+    memory.SetCurrentPageTable(test_page_table);
+    dyncom.PageTableChanged();
+    dyncom.PageTableDestroyed(page_table.get());
+    page_table->~PageTable();
+    new (page_table.get()) Memory::PageTable{};
+
+    memory.MapMemoryRegion(*page_table, 0, Memory::PAGE_SIZE, code.data());
+    CHECK(run() == 2);
+
+    memory.SetCurrentPageTable(test_page_table);
+}
+
+} // namespace ArmTests
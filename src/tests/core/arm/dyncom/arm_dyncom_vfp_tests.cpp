@@ -2,10 +2,14 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <iterator>
+#include <random>
 #include <catch2/catch.hpp>
 #include "core/arm/dyncom/arm_dyncom.h"
+#include "core/arm/skyeye_common/vfp/asm_vfp.h"
 #include "core/core.h"
 #include "core/core_timing.h"
+#include "core/settings.h"
 #include "tests/core/arm/arm_test_common.h"
 
 namespace ArmTests {
@@ -47,4 +51,108 @@ TEST_CASE("ARM_DynCom (vfp): vadd", "[arm_dyncom]") {
     }
 }
 
+/// Generates floating point bits that are biased towards interesting values
+static u64 RandomFloatBits(std::mt19937_64& rng, bool is_double) {
+    const u32 exponent_bits = is_double ? 11 : 8;
+    const u32 significand_bits = is_double ? 52 : 23;
+    const u64 max_exponent = (u64{1} << exponent_bits) - 1;
+    u64 significand = rng() & ((u64{1} << significand_bits) - 1);
+    u64 exponent;
+    switch (rng() % 8) {
+    case 0: // Zeros and denormals
+        exponent = 0;
+        significand = rng() % 2 ? significand : 0;
+        break;
+    case 1: // Infinities and NaNs
+        exponent = max_exponent;
+        significand = rng() % 2 ? significand : 0;
+        break;
+    case 2: // Close to underflowing
+        exponent = 1 + rng() % 4;
+        break;
+    case 3: // Close to overflowing
+        exponent = max_exponent - 1 - rng() % 4;
+        break;
+    case 4:
+        exponent = rng() % (max_exponent + 1);
+        break;
+    default: // Around 1, with short significands to get some exact results
+        exponent = max_exponent / 2 - 12 + rng() % 25;
+        if (rng() % 2) {
+            significand &= ~((u64{1} << (significand_bits - 4)) - 1);
+        }
+        break;
+    }
+    return (rng() & 1) << (exponent_bits + significand_bits) | exponent << significand_bits |
+           significand;
+}
+
+TEST_CASE("ARM_DynCom (vfp): host FPU matches soft-float", "[arm_dyncom]") {
+    TestEnvironment test_env(false);
+    ARM_DynCom dyncom(nullptr, test_env.GetMemory(), USER32MODE, 0, nullptr);
+
+    const u32 instructions[] = {
+        0xEE321A03, // vadd.f32 s2, s4, s6
+        0xEE321A43, // vsub.f32 s2, s4, s6
+        0xEE221A03, // vmul.f32 s2, s4, s6
+        0xEE221A43, // vnmul.f32 s2, s4, s6
+        0xEE821A03, // vdiv.f32 s2, s4, s6
+        0xEE321B03, // vadd.f64 d1, d2, d3
+        0xEE321B43, // vsub.f64 d1, d2, d3
+        0xEE221B03, // vmul.f64 d1, d2, d3
+        0xEE221B43, // vnmul.f64 d1, d2, d3
+        0xEE821B03, // vdiv.f64 d1, d2, d3
+    };
+    const u32 fpscrs[] = {
+        0,
+        FPSCR_FLUSH_TO_ZERO,
+        FPSCR_DEFAULT_NAN,
+        FPSCR_FLUSH_TO_ZERO | FPSCR_DEFAULT_NAN,
+        FPSCR_ROUND_PLUSINF,
+        FPSCR_ROUND_MINUSINF,
+        FPSCR_ROUND_TOZERO,
+    };
+
+    const bool use_vfp_host_fpu = Settings::values.use_vfp_host_fpu;
+    std::mt19937_64 rng(0x3D5);
+    for (const u32 instruction : instructions) {
+        const bool is_double = (instruction & 0x100) != 0;
+        test_env.SetMemory32(0, instruction);
+        test_env.SetMemory32(4, 0xEAFFFFFE); // b +#0
+
+        for (int i = 0; i < 20000; ++i) {
+            const u32 fpscr = fpscrs[rng() % std::size(fpscrs)];
+            const u64 a = RandomFloatBits(rng, is_double);
+            // Also test opposite and equal operands, which give exact zeros and ones
+            const u64 sign = is_double ? u64{1} << 63 : u64{1} << 31;
+            const u64 b = rng() % 4 == 0 ? a ^ (rng() % 2 ? sign : 0)
+                                         : RandomFloatBits(rng, is_double);
+
+            u64 results[2];
+            u32 final_fpscrs[2];
+            for (int host = 0; host < 2; ++host) {
+                Settings::values.use_vfp_host_fpu = host != 0;
+                dyncom.SetPC(0);
+                dyncom.SetVFPSystemReg(VFP_FPSCR, fpscr);
+                dyncom.SetVFPReg(4, static_cast<u32>(a));
+                dyncom.SetVFPReg(5, static_cast<u32>(a >> 32));
+                dyncom.SetVFPReg(6, static_cast<u32>(b));
+                dyncom.SetVFPReg(7, static_cast<u32>(b >> 32));
+                dyncom.Step();
+                results[host] = dyncom.GetVFPReg(2);
+                if (is_double) {
+                    results[host] |= u64{dyncom.GetVFPReg(3)} << 32;
+                }
+                final_fpscrs[host] = dyncom.GetVFPSystemReg(VFP_FPSCR);
+            }
+
+            INFO("instruction: " << std::hex << instruction << ", fpscr: " << fpscr
+                                 << ", a: " << a << ", b: " << b);
+            REQUIRE(results[1] == results[0]);
+            REQUIRE(final_fpscrs[1] == final_fpscrs[0]);
+        }
+    }
+    Settings::values.use_vfp_host_fpu = use_vfp_host_fpu;
+}
+
 } // namespace ArmTests
@@ -0,0 +1,69 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <thread>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "core/arm/exclusive_monitor.h"
+
+namespace {
+/// LDREX followed by an STREX of value + 1, like a guest atomic increment
+bool TryIncrement(ExclusiveMonitor& monitor, std::size_t core, volatile u32& value) {
+    const u32 loaded = value;
+    monitor.Mark(core, 0x1000, loaded);
+    return monitor.ExclusiveWrite(
+        core, 0x1000, [&] { return u64{value}; }, [&] { value = loaded + 1; });
+}
+} // Anonymous namespace
+
+TEST_CASE("ExclusiveMonitor: a store of another core clears the reservation", "[arm]") {
+    ExclusiveMonitor monitor(2);
+    u32 value = 0;
+    const auto load = [&] { return u64{value}; };
+
+    monitor.Mark(0, 0x1000, value);
+    monitor.Mark(1, 0x1004, value); // Same granule
+    REQUIRE(monitor.ExclusiveWrite(1, 0x1004, load, [&] { value = 1; }));
+    CHECK(!monitor.ExclusiveWrite(0, 0x1000, load, [&] { value = 2; }));
+    CHECK(value == 1);
+
+    // Reservations are dropped by a failed store as well
+    CHECK(!monitor.ExclusiveWrite(0, 0x1000, load, [&] { value = 2; }));
+
+    monitor.Mark(0, 0x1000, value);
+    monitor.Clear(0);
+    CHECK(!monitor.ExclusiveWrite(0, 0x1000, load, [&] { value = 2; }));
+}
+
+TEST_CASE("ExclusiveMonitor: a plain store that changed the value fails the STREX", "[arm]") {
+    ExclusiveMonitor monitor(2);
+    u32 value = 0;
+    const auto load = [&] { return u64{value}; };
+
+    monitor.Mark(0, 0x1000, value);
+    value = 5; // STR of another core
+    CHECK(!monitor.ExclusiveWrite(0, 0x1000, load, [&] { value = 1; }));
+    CHECK(value == 5);
+}
+
+TEST_CASE("ExclusiveMonitor: increments from several host threads are atomic", "[arm]") {
+    constexpr std::size_t NUM_CORES = 4;
+    constexpr u32 INCREMENTS = 20000;
+    ExclusiveMonitor monitor(NUM_CORES);
+    volatile u32 value = 0;
+
+    std::vector<std::thread> threads;
+    for (std::size_t core = 0; core < NUM_CORES; ++core) {
+        threads.emplace_back([&monitor, &value, core] {
+            for (u32 i = 0; i < INCREMENTS; ++i) {
+                while (!TryIncrement(monitor, core, value)) {
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    CHECK(value == NUM_CORES * INCREMENTS);
+}
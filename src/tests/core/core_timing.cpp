@@ -4,9 +4,14 @@
 
 #include <catch2/catch.hpp>
 
+#include <algorithm>
 #include <array>
 #include <bitset>
+#include <chrono>
+#include <random>
 #include <string>
+#include <vector>
+#include <fmt/format.h>
 #include "common/file_util.h"
 #include "core/core.h"
 #include "core/core_timing.h"
@@ -117,6 +122,33 @@ TEST_CASE("CoreTiming[SharedSlot]", "[core]") {
     REQUIRE(0x1FULL == callbacks_ran_flags.to_ullong());
 }
 
+TEST_CASE("CoreTiming[UnscheduleByHandle]", "[core]") {
+    Core::Timing timing(1, 100);
+
+    Core::TimingEventType* cb_a = timing.RegisterEvent("callbackA", CallbackTemplate<0>);
+
+    timing.GetTimer(0)->Advance();
+
+    // Two events of the same type and userdata; only the handle tells them apart.
+    const Core::Timing::EventHandle first = timing.ScheduleEvent(100, cb_a, CB_IDS[0], 0);
+    timing.ScheduleEvent(300, cb_a, CB_IDS[0], 0);
+    REQUIRE(100 == timing.GetTimer(0)->GetDowncount());
+
+    timing.UnscheduleEvent(first);
+    // Unscheduling an event that is no longer pending is a no-op.
+    timing.UnscheduleEvent(first);
+    timing.UnscheduleEvent(Core::Timing::EventHandle{});
+
+    // Nothing fires where the first event was due.
+    callbacks_ran_flags = 0;
+    timing.GetTimer(0)->AddTicks(timing.GetTimer(0)->GetDowncount());
+    timing.GetTimer(0)->Advance();
+    REQUIRE(callbacks_ran_flags.none());
+    REQUIRE(200 == timing.GetTimer(0)->GetDowncount());
+
+    AdvanceAndCheck(timing, 0, MAX_SLICE_LENGTH);
+}
+
 TEST_CASE("CoreTiming[PredictableLateness]", "[core]") {
     Core::Timing timing(1, 100);
 
@@ -186,4 +218,109 @@ TEST_CASE("CoreTiming[ChainScheduling]", "[core]") {
     REQUIRE(MAX_SLICE_LENGTH == timing.GetTimer(0)->GetDowncount());
 }
 
+TEST_CASE("CoreTiming[EventQueue]", "[core]") {
+    using Event = Core::Timing::Event;
+    const std::array<Core::TimingEventType, 2> types{};
+
+    Core::Timing::EventQueue queue;
+    std::vector<Event> expected;
+    std::mt19937 rng(1234);
+    u64 fifo_order = 0;
+
+    const auto push = [&](s64 time, u64 userdata) {
+        const Event event{time, fifo_order++, userdata, &types[userdata % types.size()]};
+        expected.push_back(event);
+        return queue.Push(event);
+    };
+    const auto remove_expected = [&](u64 userdata) {
+        expected.erase(std::remove_if(expected.begin(), expected.end(),
+                                      [&](const Event& e) { return e.userdata == userdata; }),
+                       expected.end());
+    };
+
+    // Mix events sharing a time with events spread over every level, and some far beyond them
+    for (u64 i = 0; i < 2000; ++i) {
+        switch (i % 4) {
+        case 0:
+            push(5000, i);
+            break;
+        case 1:
+            push(std::uniform_int_distribution<s64>(0, 1 << 20)(rng), i);
+            break;
+        case 2:
+            push(std::uniform_int_distribution<s64>(0, s64{1} << 40)(rng), i);
+            break;
+        default:
+            push(std::uniform_int_distribution<s64>(0, 100)(rng), i);
+            break;
+        }
+    }
+
+    const auto handle = push(4000, 2000);
+    REQUIRE(queue.Remove(handle));
+    REQUIRE(!queue.Remove(handle));
+    remove_expected(2000);
+
+    queue.Remove(&types[1], 7);
+    remove_expected(7);
+    REQUIRE(queue.Size() == expected.size());
+
+    std::sort(expected.begin(), expected.end());
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        const Event* front = queue.Front();
+        REQUIRE(front != nullptr);
+        REQUIRE(front->userdata == expected[i].userdata);
+
+        // Events scheduled in the past are still dispatched before everything else
+        if (i == expected.size() / 2) {
+            const Event late{0, fifo_order++, 3000, &types[0]};
+            queue.Push(late);
+            REQUIRE(queue.Front()->userdata == 3000);
+            queue.PopFront();
+        }
+        queue.PopFront();
+    }
+    REQUIRE(queue.Empty());
+    REQUIRE(queue.Front() == nullptr);
+}
+
+TEST_CASE("CoreTiming[Throughput]", "[.benchmark]") {
+    constexpr int NUM_PERIODIC_EVENTS = 64;
+    constexpr int NUM_SLICES = 200000;
+
+    Core::Timing timing(1, 100);
+    u64 callbacks = 0;
+
+    // Periodic events with different periods, similar to the audio, HID, VBlank and service
+    // timers, each of which gets unscheduled and scheduled again every so often.
+    Core::TimingEventType* periodic = nullptr;
+    periodic = timing.RegisterEvent("periodic", [&](u64 userdata, s64 cycles_late) {
+        ++callbacks;
+        timing.ScheduleEvent(static_cast<s64>(userdata) - cycles_late, periodic, userdata, 0);
+    });
+    Core::TimingEventType* oneshot = timing.RegisterEvent("oneshot", [](u64, s64) {});
+
+    timing.GetTimer(0)->Advance();
+    for (int i = 0; i < NUM_PERIODIC_EVENTS; ++i) {
+        const s64 period = 1000 + i * 997;
+        timing.ScheduleEvent(period, periodic, static_cast<u64>(period), 0);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int slice = 0; slice < NUM_SLICES; ++slice) {
+        const u64 userdata = slice % 16;
+        const auto handle = timing.ScheduleEvent(msToCycles(16), oneshot, userdata, 0);
+        if (slice % 3 == 0) {
+            timing.UnscheduleEvent(handle);
+        }
+        timing.GetTimer(0)->AddTicks(timing.GetTimer(0)->GetDowncount());
+        timing.GetTimer(0)->Advance();
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    WARN(fmt::format("{} slices, {} callbacks in {:.3f}s ({:.1f} ns per slice)", NUM_SLICES,
+                     callbacks, elapsed.count(), elapsed.count() * 1e9 / NUM_SLICES));
+    REQUIRE(callbacks > 0);
+}
+
 // TODO: Add tests for multiple timers
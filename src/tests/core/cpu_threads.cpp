@@ -0,0 +1,117 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include <memory>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "core/arm/dyncom/arm_dyncom.h"
+#include "core/core_timing.h"
+#include "core/cpu_threads.h"
+#include "core/hle/kernel/kernel.h"
+#include "core/hle/kernel/process.h"
+#include "core/hle/kernel/thread.h"
+#include "core/memory.h"
+
+namespace {
+
+constexpr std::size_t NUM_CORES = 2;
+constexpr VAddr CODE_ADDR = 0x00100000;
+constexpr VAddr COUNTER_ADDR = 0x00101000;
+constexpr u32 INCREMENTS_PER_CORE = 0x400;
+
+/// Increments the counter INCREMENTS_PER_CORE times with LDREX and STREX, then spins
+constexpr u32 INCREMENT_CODE[] = {
+    0xE3A01601, // mov r1, #0x100000
+    0xE2811A01, // add r1, r1, #0x1000
+    0xE3A02B01, // mov r2, #0x400
+    0xE1910F9F, // loop: ldrex r0, [r1]
+    0xE2800001, // add r0, r0, #1
+    0xE1813F90, // strex r3, r0, [r1]
+    0xE3530000, // cmp r3, #0
+    0x1AFFFFFA, // bne loop
+    0xE2522001, // subs r2, r2, #1
+    0x1AFFFFF8, // bne loop
+    0xEAFFFFFE, // done: b done
+};
+constexpr VAddr DONE_ADDR = CODE_ADDR + sizeof(INCREMENT_CODE) - 4;
+
+struct CPUThreadsEnvironment {
+    CPUThreadsEnvironment()
+        : timing(NUM_CORES, 100), kernel(memory, timing, [] {}, 0, NUM_CORES, 0) {
+        for (u32 id = 0; id < NUM_CORES; ++id) {
+            cores.push_back(
+                std::make_shared<ARM_DynCom>(nullptr, memory, USER32MODE, id, timing.GetTimer(id)));
+        }
+        kernel.SetCPUs(cores);
+        kernel.SetRunningCPU(cores[0]);
+    }
+
+    /// Advances the timers to the next slice and runs it on the core threads.
+    void RunSlice(Core::CPUThreads& cpu_threads) {
+        for (const auto& core : cores) {
+            core->GetTimer()->Advance();
+        }
+        cpu_threads.RunSlice();
+    }
+
+    Core::Timing timing;
+    Memory::MemorySystem memory;
+    Kernel::KernelSystem kernel;
+    std::vector<std::shared_ptr<ARM_Interface>> cores;
+};
+
+} // Anonymous namespace
+
+TEST_CASE("CPUThreads: cores without threads idle", "[core]") {
+    CPUThreadsEnvironment env;
+    REQUIRE(Core::CPUThreads::IsSupported(env.cores));
+
+    Core::CPUThreads cpu_threads(env.kernel, env.memory, env.cores, false);
+    CHECK_FALSE(Core::CPUThreads::IsCoreThread());
+    CHECK(Core::CPUThreads::GetThreadCore() == nullptr);
+
+    for (int slice = 0; slice < 3; ++slice) {
+        env.RunSlice(cpu_threads);
+        for (const auto& core : env.cores) {
+            CHECK(core->GetTimer()->GetIdleTicks() > 0);
+        }
+    }
+}
+
+TEST_CASE("CPUThreads: LDREX and STREX are atomic across cores", "[core]") {
+    bool deterministic = false;
+    SECTION("non-deterministic") {}
+    SECTION("deterministic") {
+        deterministic = true;
+    }
+
+    CPUThreadsEnvironment env;
+
+    std::vector<u8> ram(2 * Memory::PAGE_SIZE);
+    std::memcpy(ram.data(), INCREMENT_CODE, sizeof(INCREMENT_CODE));
+    auto process = env.kernel.CreateProcess(env.kernel.CreateCodeSet("", 0));
+    env.memory.MapMemoryRegion(process->vm_manager.page_table, CODE_ADDR, 2 * Memory::PAGE_SIZE,
+                               ram.data());
+
+    std::vector<std::shared_ptr<Kernel::Thread>> threads;
+    for (u32 id = 0; id < NUM_CORES; ++id) {
+        threads.push_back(
+            env.kernel.CreateThread("", CODE_ADDR, 0x30, 0, id, 0, *process).Unwrap());
+        env.kernel.SetRunningCPU(env.cores[id]);
+        env.kernel.GetThreadManager(id).Reschedule();
+    }
+
+    Core::CPUThreads cpu_threads(env.kernel, env.memory, env.cores, deterministic);
+    for (int slice = 0; slice < 10; ++slice) {
+        env.RunSlice(cpu_threads);
+    }
+
+    for (const auto& core : env.cores) {
+        CHECK(core->GetPC() == DONE_ADDR);
+    }
+    u32 counter;
+    std::memcpy(&counter, ram.data() + (COUNTER_ADDR - CODE_ADDR), sizeof(counter));
+    CHECK(counter == NUM_CORES * INCREMENTS_PER_CORE);
+}
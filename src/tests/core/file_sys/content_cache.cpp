@@ -0,0 +1,66 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <string>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <fmt/format.h>
+#include "common/file_util.h"
+#include "core/file_sys/content_cache.h"
+
+namespace FileSys {
+
+namespace {
+const std::string CACHE_DIR = FileUtil::GetCurrentDir().value_or(".") + "/content_cache_test/";
+
+ExeFSSections MakeSections(std::size_t code_size) {
+    ExeFSSections sections;
+    sections[".code"] = std::vector<u8>(code_size, 0xC0);
+    sections["icon"] = {1, 2, 3, 4};
+    sections["banner"] = {};
+    return sections;
+}
+
+std::string GetEntryPath(u64 program_id, u64 content_hash) {
+    return fmt::format("{}{:016X}_{:016X}.bin", CACHE_DIR, program_id, content_hash);
+}
+} // Anonymous namespace
+
+TEST_CASE("ContentCache: sections are stored and read back", "[core][file_sys]") {
+    FileUtil::DeleteDirRecursively(CACHE_DIR);
+    const ExeFSSections sections = MakeSections(0x1000);
+    REQUIRE(WriteContentCache(CACHE_DIR, 0x0004000000123400, 1, sections, 1 << 20));
+
+    CHECK(ReadContentCache(CACHE_DIR, 0x0004000000123400, 1) == sections);
+    // A different version of the same title
+    CHECK(!ReadContentCache(CACHE_DIR, 0x0004000000123400, 2));
+
+    // Corrupted entries are removed
+    {
+        FileUtil::IOFile file(GetEntryPath(0x0004000000123400, 1), "r+b");
+        REQUIRE(file.Seek(-1, SEEK_END));
+        REQUIRE(file.WriteBytes("X", 1) == 1);
+    }
+    CHECK(!ReadContentCache(CACHE_DIR, 0x0004000000123400, 1));
+    CHECK(!FileUtil::Exists(GetEntryPath(0x0004000000123400, 1)));
+
+    FileUtil::DeleteDirRecursively(CACHE_DIR);
+}
+
+TEST_CASE("ContentCache: least recently used entries are removed", "[core][file_sys]") {
+    FileUtil::DeleteDirRecursively(CACHE_DIR);
+    constexpr u64 SIZE_LIMIT = 0x3000;
+    REQUIRE(WriteContentCache(CACHE_DIR, 1, 0, MakeSections(0x1000), SIZE_LIMIT));
+    REQUIRE(WriteContentCache(CACHE_DIR, 2, 0, MakeSections(0x1000), SIZE_LIMIT));
+    // An entry that doesn't fit on its own is still kept
+    REQUIRE(WriteContentCache(CACHE_DIR, 3, 0, MakeSections(0x4000), SIZE_LIMIT));
+
+    CHECK(!FileUtil::Exists(GetEntryPath(1, 0)));
+    CHECK(!FileUtil::Exists(GetEntryPath(2, 0)));
+    CHECK(ReadContentCache(CACHE_DIR, 3, 0) == MakeSections(0x4000));
+
+    FileUtil::DeleteDirRecursively(CACHE_DIR);
+}
+
+} // namespace FileSys
@@ -0,0 +1,124 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "common/file_util.h"
+#include "core/file_sys/layered_fs.h"
+
+namespace FileSys {
+
+namespace {
+const std::string TEST_DIR = FileUtil::GetCurrentDir().value_or(".") + "/layered_fs_test/";
+const std::string MODS_DIR = TEST_DIR + "mods/";
+const std::string CACHE_PATH = TEST_DIR + "cache/layeredfs.bin";
+
+class MemoryRomFS : public RomFSReader {
+public:
+    explicit MemoryRomFS(std::vector<u8> data) : data(std::move(data)) {}
+
+    std::size_t GetSize() const override {
+        return data.size();
+    }
+
+    std::size_t ReadFile(std::size_t offset, std::size_t length, u8* buffer) override {
+        ++num_reads;
+        const std::size_t read_size = std::min(length, data.size() - offset);
+        std::memcpy(buffer, data.data() + offset, read_size);
+        return read_size;
+    }
+
+    std::size_t num_reads = 0;
+
+private:
+    std::vector<u8> data;
+};
+
+void Write32(std::vector<u8>& data, std::size_t offset, u32 value) {
+    std::memcpy(data.data() + offset, &value, sizeof(value));
+}
+
+/// Builds a RomFS holding the file "a.bin" in its root directory.
+std::shared_ptr<MemoryRomFS> MakeRomFS() {
+    std::vector<u8> data(0x84, 0xFF);
+    const u32 header[] = {0x28, 0x28, 4, 0x2C, 0x18, 0x44, 4, 0x48, 0x2C, 0x80};
+    std::memcpy(data.data(), header, sizeof(header));
+    Write32(data, 0x28, 0); // Directory hash table
+    // Root directory
+    Write32(data, 0x2C, 0);
+    Write32(data, 0x38, 0);
+    Write32(data, 0x40, 0);
+    Write32(data, 0x44, 0); // File hash table
+    // a.bin
+    Write32(data, 0x48, 0);
+    std::memset(data.data() + 0x50, 0, 16);
+    data[0x58] = 4;
+    Write32(data, 0x64, 10);
+    const char16_t name[] = u"a.bin";
+    std::memcpy(data.data() + 0x68, name, 10);
+    std::memcpy(data.data() + 0x80, "ORIG", 4);
+    return std::make_shared<MemoryRomFS>(std::move(data));
+}
+
+void WriteMods(const std::string& new_file) {
+    FileUtil::CreateFullPath(MODS_DIR + "romfs/");
+    FileUtil::CreateFullPath(MODS_DIR + "romfs_ext/");
+    FileUtil::WriteStringToFile(false, MODS_DIR + "romfs/new.bin", new_file);
+    // Replaces the first byte of a.bin with 'X'
+    const std::string ips("PATCH\0\0\0\0\1XEOF", 14);
+    FileUtil::WriteStringToFile(false, MODS_DIR + "romfs_ext/a.bin.ips", ips);
+}
+
+std::vector<u8> ReadAll(LayeredFS& layered_fs) {
+    std::vector<u8> data(layered_fs.GetSize());
+    REQUIRE(layered_fs.ReadFile(0, data.size(), data.data()) == data.size());
+    return data;
+}
+
+bool Contains(const std::vector<u8>& data, const std::string& str) {
+    return std::search(data.begin(), data.end(), str.begin(), str.end()) != data.end();
+}
+} // Anonymous namespace
+
+TEST_CASE("LayeredFS: rebuilt metadata is cached", "[core][file_sys]") {
+    FileUtil::DeleteDirRecursively(TEST_DIR);
+    WriteMods("NEW!");
+
+    LayeredFS rebuilt(MakeRomFS(), MODS_DIR + "romfs/", MODS_DIR + "romfs_ext/", true,
+                      CACHE_PATH);
+    const std::vector<u8> expected = ReadAll(rebuilt);
+    CHECK(Contains(expected, "XRIG"));
+    CHECK(Contains(expected, "NEW!"));
+    REQUIRE(FileUtil::Exists(CACHE_PATH));
+
+    // Only the header and the original metadata are read to validate the cache
+    auto romfs = MakeRomFS();
+    LayeredFS cached(romfs, MODS_DIR + "romfs/", MODS_DIR + "romfs_ext/", true, CACHE_PATH);
+    CHECK(romfs->num_reads == 2);
+    CHECK(ReadAll(cached) == expected);
+
+    FileUtil::DeleteDirRecursively(TEST_DIR);
+}
+
+TEST_CASE("LayeredFS: the cache is rebuilt when mods change", "[core][file_sys]") {
+    FileUtil::DeleteDirRecursively(TEST_DIR);
+    WriteMods("NEW!");
+    LayeredFS(MakeRomFS(), MODS_DIR + "romfs/", MODS_DIR + "romfs_ext/", true, CACHE_PATH);
+
+    WriteMods("NEWER");
+    auto romfs = MakeRomFS();
+    LayeredFS layered_fs(romfs, MODS_DIR + "romfs/", MODS_DIR + "romfs_ext/", true, CACHE_PATH);
+    CHECK(romfs->num_reads > 2);
+    const std::vector<u8> data = ReadAll(layered_fs);
+    CHECK(Contains(data, "XRIG"));
+    CHECK(Contains(data, "NEWER"));
+
+    FileUtil::DeleteDirRecursively(TEST_DIR);
+}
+
+} // namespace FileSys
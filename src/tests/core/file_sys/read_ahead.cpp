@@ -0,0 +1,84 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "core/file_sys/read_ahead.h"
+
+namespace FileSys {
+
+namespace {
+struct TestFile {
+    explicit TestFile(std::size_t size) : data(size) {
+        for (std::size_t i = 0; i < size; ++i) {
+            data[i] = static_cast<u8>(i * 7 + (i >> 9));
+        }
+    }
+
+    std::size_t Read(u64 offset, std::size_t length, u8* buffer) {
+        ++num_reads;
+        if (offset >= data.size()) {
+            return 0;
+        }
+        length = std::min<std::size_t>(length, data.size() - offset);
+        std::memcpy(buffer, data.data() + offset, length);
+        return length;
+    }
+
+    /// Reads through a ReadAhead and checks the result against the data.
+    void Check(ReadAhead& read_ahead, u64 offset, std::size_t length) {
+        std::vector<u8> buffer(length);
+        const std::size_t expected =
+            offset >= data.size() ? 0 : std::min<std::size_t>(length, data.size() - offset);
+        REQUIRE(read_ahead.Read(offset, length, buffer.data()) == expected);
+        CHECK(std::equal(buffer.begin(), buffer.begin() + expected, data.begin() + offset));
+    }
+
+    std::vector<u8> data;
+    std::atomic<int> num_reads{0};
+};
+} // Anonymous namespace
+
+TEST_CASE("ReadAhead: sequential reads are served from the data read ahead", "[core][file_sys]") {
+    TestFile file(0x345678);
+    ReadAhead read_ahead([&file](u64 offset, std::size_t length, u8* buffer) {
+        return file.Read(offset, length, buffer);
+    });
+
+    constexpr std::size_t CHUNK_SIZE = 0x8000;
+    for (u64 offset = 0; offset < file.data.size(); offset += CHUNK_SIZE) {
+        file.Check(read_ahead, offset, CHUNK_SIZE);
+    }
+    read_ahead.Wait();
+    // Reading 0x69 chunks took far fewer reads of the file
+    CHECK(file.num_reads < 20);
+
+    // Moving around the file, including back into data read ahead
+    file.Check(read_ahead, 0x1000, 0x100);
+    file.Check(read_ahead, 0x1100, 0x100);
+    file.Check(read_ahead, 0x1050, 0x200);
+    file.Check(read_ahead, 0x300000, 0x50000);
+    file.Check(read_ahead, 0x350000, 0x10000);
+    file.Check(read_ahead, 0x345000, 0x1000);
+}
+
+TEST_CASE("ReadAhead: invalidated data is read again", "[core][file_sys]") {
+    TestFile file(0x200000);
+    ReadAhead read_ahead([&file](u64 offset, std::size_t length, u8* buffer) {
+        return file.Read(offset, length, buffer);
+    });
+
+    file.Check(read_ahead, 0, 0x1000);
+    file.Check(read_ahead, 0x1000, 0x1000);
+
+    read_ahead.Invalidate();
+    std::fill(file.data.begin(), file.data.end(), 0xAB);
+    file.Check(read_ahead, 0x2000, 0x1000);
+    file.Check(read_ahead, 0x3000, 0x1000);
+}
+
+} // namespace FileSys
@@ -0,0 +1,133 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <cryptopp/aes.h>
+#include <cryptopp/modes.h>
+#include <fmt/format.h>
+#include "common/file_util.h"
+#include "core/file_sys/romfs_reader.h"
+
+namespace FileSys {
+
+namespace {
+constexpr std::size_t FILE_OFFSET = 0x200;
+constexpr std::size_t CRYPTO_OFFSET = 0x1000;
+constexpr std::array<u8, 16> KEY{0x01, 0x23, 0x45, 0x67, 0x89, 0xAB, 0xCD, 0xEF,
+                                 0xFE, 0xDC, 0xBA, 0x98, 0x76, 0x54, 0x32, 0x10};
+constexpr std::array<u8, 16> CTR{0x00, 0x04, 0x00, 0x00, 0x00, 0x12, 0x34, 0x00,
+                                 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+
+/// Writes encrypted data to a file and opens a reader over it. Only the first stored_size bytes
+/// are written, to simulate a truncated file.
+struct EncryptedRomFS {
+    explicit EncryptedRomFS(std::size_t size, std::size_t stored_size = SIZE_MAX) : data(size) {
+        u32 seed = 1;
+        for (u8& byte : data) {
+            seed = seed * 1103515245 + 12345;
+            byte = static_cast<u8>(seed >> 16);
+        }
+
+        std::vector<u8> encrypted(data);
+        CryptoPP::CTR_Mode<CryptoPP::AES>::Encryption e(KEY.data(), KEY.size(), CTR.data());
+        e.Seek(CRYPTO_OFFSET);
+        e.ProcessData(encrypted.data(), encrypted.data(), encrypted.size());
+        encrypted.resize(std::min(encrypted.size(), stored_size));
+        {
+            FileUtil::IOFile file(path, "wb");
+            REQUIRE(file.Seek(FILE_OFFSET, SEEK_SET));
+            REQUIRE(file.WriteBytes(encrypted.data(), encrypted.size()) == encrypted.size());
+        }
+
+        reader = std::make_unique<DirectRomFSReader>(FileUtil::IOFile(path, "rb"), FILE_OFFSET,
+                                                     data.size(), KEY, CTR, CRYPTO_OFFSET);
+    }
+
+    ~EncryptedRomFS() {
+        reader.reset();
+        FileUtil::Delete(path);
+    }
+
+    /// Checks that a range reads back as the original data.
+    void Check(std::size_t offset, std::size_t length) {
+        std::vector<u8> buffer(length);
+        REQUIRE(reader->ReadFile(offset, length, buffer.data()) == length);
+        CHECK(std::equal(buffer.begin(), buffer.end(), data.begin() + offset));
+    }
+
+    const std::string path = FileUtil::GetCurrentDir().value_or(".") + "/romfs_test.bin";
+    std::vector<u8> data;
+    std::unique_ptr<DirectRomFSReader> reader;
+};
+} // Anonymous namespace
+
+TEST_CASE("DirectRomFSReader: encrypted data is decrypted", "[core][file_sys]") {
+    // Not a whole number of cache blocks, so that the last block is partial
+    EncryptedRomFS romfs(0x123457);
+
+    romfs.Check(0, 1);
+    romfs.Check(5, 0x3F);
+    // Across a cache block boundary
+    romfs.Check(0xFFF0, 0x20);
+    // Large reads, aligned or not
+    romfs.Check(0x20000, 0x40000);
+    romfs.Check(0x3, 0x10001);
+    // Again, now that it is cached
+    romfs.Check(5, 0x3F);
+    romfs.Check(0x123400, 0x57);
+
+    // Reads past the end are cut short
+    std::vector<u8> buffer(0x100);
+    CHECK(romfs.reader->ReadFile(0x123450, buffer.size(), buffer.data()) == 7);
+    CHECK(romfs.reader->ReadFile(0x200000, buffer.size(), buffer.data()) == 0);
+
+    // Enough blocks to evict the first ones
+    for (std::size_t offset = 0; offset < romfs.data.size(); offset += 0x8000) {
+        romfs.Check(offset, 0x10);
+    }
+    romfs.Check(0x10, 0x10);
+}
+
+TEST_CASE("DirectRomFSReader: incomplete blocks are not served", "[core][file_sys]") {
+    // The file ends in the middle of the second cache block
+    EncryptedRomFS romfs(0x30000, 0x18000);
+
+    romfs.Check(0x100, 0x10);
+    std::vector<u8> buffer(0x10);
+    // Even the part of the block that is in the file is an error, and stays one when retried
+    CHECK(romfs.reader->ReadFile(0x10100, buffer.size(), buffer.data()) == 0);
+    CHECK(romfs.reader->ReadFile(0x10100, buffer.size(), buffer.data()) == 0);
+    // A read starting in a complete block stops where the incomplete one begins
+    CHECK(romfs.reader->ReadFile(0xFFF8, buffer.size(), buffer.data()) == 8);
+    CHECK(std::equal(buffer.begin(), buffer.begin() + 8, romfs.data.begin() + 0xFFF8));
+    romfs.Check(0x200, 0x10);
+}
+
+TEST_CASE("DirectRomFSReader[SmallReads]", "[.benchmark]") {
+    constexpr std::size_t READ_SIZE = 0x40;
+    constexpr int NUM_READS = 200000;
+
+    // Small reads walking through a file, like a game parsing a table out of the RomFS
+    EncryptedRomFS romfs(0x400000);
+    std::vector<u8> buffer(READ_SIZE);
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < NUM_READS; ++i) {
+        const std::size_t offset = (i * READ_SIZE * 3) % (romfs.data.size() - READ_SIZE);
+        romfs.reader->ReadFile(offset, READ_SIZE, buffer.data());
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    WARN(fmt::format("{} reads of {} bytes in {:.3f}s ({:.1f} ns per read)", NUM_READS,
+                     READ_SIZE, elapsed.count(), elapsed.count() * 1e9 / NUM_READS));
+    romfs.Check(0, READ_SIZE);
+}
+
+} // namespace FileSys
@@ -0,0 +1,38 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch.hpp>
+#include "core/guest_profiler.h"
+
+TEST_CASE("GuestProfiler: samples are attributed to symbols", "[core]") {
+    Core::GuestProfiler profiler;
+    profiler.AddSymbol(1, 0x100000, 0x100, "main");
+    profiler.AddSymbol(1, 0x100100, 0x10, "WaitLoop");
+    profiler.AddSymbol(2, 0x100000, 0x100, "other");
+
+    // Two samples in WaitLoop called from main, one in main itself and two outside any symbol,
+    // one of them past the end of the last one
+    profiler.AddSample(1, "app", 3, 0x100104, 0x100011);
+    profiler.AddSample(1, "app", 3, 0x100108, 0x100011);
+    profiler.AddSample(1, "app", 4, 0x100010, 0x200000);
+    profiler.AddSample(1, "app", 4, 0x0FFFFC, 0x200000);
+    profiler.AddSample(1, "app", 4, 0x100110, 0x200000);
+    profiler.AddIdleSample();
+
+    const std::string report = profiler.GetReport(10);
+    CHECK(report.find("Guest profile: 6 samples, 1 idle") != std::string::npos);
+    CHECK(report.find("Process 1 \"app\": 5 samples") != std::string::npos);
+    CHECK(report.find("2  40.00%  WaitLoop\n") != std::string::npos);
+    CHECK(report.find("1  20.00%  main\n") != std::string::npos);
+    CHECK(report.find("1  20.00%  0x000FFFFC\n") != std::string::npos);
+    CHECK(report.find("1  20.00%  0x00100110\n") != std::string::npos);
+    CHECK(report.find("2  40.00%  main -> WaitLoop\n") != std::string::npos);
+    CHECK(report.find("2  40.00%  thread 3\n") != std::string::npos);
+    // Symbols of other processes are not used
+    CHECK(report.find("other") == std::string::npos);
+
+    // Unloading a module drops its symbols
+    profiler.RemoveSymbols(1, 0x100100, 0x100);
+    CHECK(profiler.GetReport(10).find("WaitLoop") == std::string::npos);
+}
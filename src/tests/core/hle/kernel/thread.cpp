@@ -0,0 +1,66 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch.hpp>
+#include "core/arm/dyncom/arm_dyncom.h"
+#include "core/arm/skyeye_common/armstate.h"
+#include "core/core_timing.h"
+#include "core/hle/kernel/kernel.h"
+#include "core/hle/kernel/process.h"
+#include "core/hle/kernel/thread.h"
+#include "core/memory.h"
+
+namespace Kernel {
+
+TEST_CASE("Thread::RepeatsIdlePoll", "[kernel]") {
+    Core::Timing timing(1, 100);
+    Memory::MemorySystem memory;
+    KernelSystem kernel(memory, timing, [] {}, 0, 1, 0);
+    auto process = kernel.CreateProcess(kernel.CreateCodeSet("", 0));
+    kernel.MapSharedPages(process->vm_manager);
+    auto thread =
+        kernel.CreateThread("", Memory::SHARED_PAGE_VADDR, 0x30, 0, 0, 0, *process).Unwrap();
+
+    ARM_DynCom core(nullptr, memory, USER32MODE, 0, nullptr);
+    core.SetReg(4, 0x1000);
+    core.SetReg(13, 0x10000000);
+    core.SetReg(14, 0x00100100);
+
+    // The first call has nothing to compare to
+    REQUIRE_FALSE(thread->RepeatsIdlePoll(core, 1000));
+
+    SECTION("same call with the same state") {
+        CHECK(thread->RepeatsIdlePoll(core, 1500));
+    }
+
+    SECTION("results of the previous call change") {
+        core.SetReg(0, 1234);
+        core.SetReg(1, 5678);
+        core.SetReg(12, 9);
+        CHECK(thread->RepeatsIdlePoll(core, 1500));
+    }
+
+    SECTION("loop state changes") {
+        core.SetReg(4, 0x1004);
+        CHECK_FALSE(thread->RepeatsIdlePoll(core, 1500));
+        // Polling with the new state is detected again
+        CHECK(thread->RepeatsIdlePoll(core, 2000));
+    }
+
+    SECTION("flags change") {
+        core.SetCPSR(core.GetCPSR() ^ 0x40000000);
+        CHECK_FALSE(thread->RepeatsIdlePoll(core, 1500));
+    }
+
+    SECTION("call from somewhere else") {
+        core.SetReg(14, 0x00100200);
+        CHECK_FALSE(thread->RepeatsIdlePoll(core, 1500));
+    }
+
+    SECTION("too much time in between") {
+        CHECK_FALSE(thread->RepeatsIdlePoll(core, 3000));
+    }
+}
+
+} // namespace Kernel
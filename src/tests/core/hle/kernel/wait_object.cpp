@@ -0,0 +1,92 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch.hpp>
+#include "core/core_timing.h"
+#include "core/hle/kernel/kernel.h"
+#include "core/hle/kernel/mutex.h"
+#include "core/hle/kernel/process.h"
+#include "core/hle/kernel/semaphore.h"
+#include "core/hle/kernel/thread.h"
+#include "core/memory.h"
+
+namespace Kernel {
+
+TEST_CASE("WaitObject: HLE wakeup callbacks can change which threads are woken up next",
+          "[core][kernel]") {
+    Core::Timing timing(1, 100);
+    Memory::MemorySystem memory;
+    KernelSystem kernel(memory, timing, [] {}, 0, 1, 0);
+    auto process = kernel.CreateProcess(kernel.CreateCodeSet("", 0));
+    kernel.MapSharedPages(process->vm_manager);
+    auto semaphore = kernel.CreateSemaphore(0, 2).Unwrap();
+
+    const auto make_waiting_thread = [&](u32 priority) {
+        auto thread =
+            kernel.CreateThread("", Memory::SHARED_PAGE_VADDR, priority, 0, 0, 0, *process)
+                .Unwrap();
+        thread->status = ThreadStatus::WaitSynchAny;
+        thread->wait_objects = {semaphore};
+        semaphore->AddWaitingThread(thread);
+        return thread;
+    };
+    auto high = make_waiting_thread(0x20);
+    auto middle = make_waiting_thread(0x30);
+    auto low = make_waiting_thread(0x40);
+
+    // Like an HLE service releasing a mutex the low priority thread holds, the callback of the
+    // first thread boosts the low priority thread above the others
+    high->status = ThreadStatus::WaitHleEvent;
+    high->wakeup_callback = [&](ThreadWakeupReason, std::shared_ptr<Thread>,
+                                std::shared_ptr<WaitObject>) { low->BoostPriority(0x10); };
+
+    REQUIRE(semaphore->Release(2).Succeeded());
+    CHECK(high->status == ThreadStatus::Ready);
+    CHECK(low->status == ThreadStatus::Ready);
+    CHECK(middle->status == ThreadStatus::WaitSynchAny);
+    CHECK(semaphore->available_count == 0);
+}
+
+TEST_CASE("WaitObject: waking a thread can lower the inherited priority of another waiting thread",
+          "[core][kernel]") {
+    Core::Timing timing(1, 100);
+    Memory::MemorySystem memory;
+    KernelSystem kernel(memory, timing, [] {}, 0, 1, 0);
+    auto process = kernel.CreateProcess(kernel.CreateCodeSet("", 0));
+    kernel.MapSharedPages(process->vm_manager);
+    auto semaphore = kernel.CreateSemaphore(0, 2).Unwrap();
+    auto mutex = kernel.CreateMutex(false, "");
+
+    const auto make_waiting_thread = [&](u32 priority,
+                                         std::vector<std::shared_ptr<WaitObject>> objects) {
+        auto thread =
+            kernel.CreateThread("", Memory::SHARED_PAGE_VADDR, priority, 0, 0, 0, *process)
+                .Unwrap();
+        thread->status = ThreadStatus::WaitSynchAny;
+        thread->wait_objects = objects;
+        for (const auto& object : objects) {
+            object->AddWaitingThread(thread);
+        }
+        return thread;
+    };
+    auto holder = make_waiting_thread(0x30, {});
+    mutex->Acquire(holder.get());
+    auto high = make_waiting_thread(0x10, {semaphore, mutex});
+    holder->wait_objects = {semaphore};
+    semaphore->AddWaitingThread(holder);
+    auto middle = make_waiting_thread(0x20, {semaphore});
+
+    // The holder inherits the priority of the high priority thread until that one stops waiting
+    // for the mutex
+    REQUIRE(holder->current_priority == 0x10);
+
+    REQUIRE(semaphore->Release(2).Succeeded());
+    CHECK(high->status == ThreadStatus::Ready);
+    CHECK(holder->current_priority == 0x30);
+    CHECK(middle->status == ThreadStatus::Ready);
+    CHECK(holder->status == ThreadStatus::WaitSynchAny);
+    CHECK(semaphore->available_count == 0);
+}
+
+} // namespace Kernel
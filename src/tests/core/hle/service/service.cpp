@@ -0,0 +1,57 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch.hpp>
+#include "core/hle/ipc.h"
+#include "core/hle/service/service.h"
+
+namespace Service {
+
+class TestService final : public ServiceFramework<TestService> {
+public:
+    TestService() : ServiceFramework("test", 1) {
+        static const FunctionInfo functions[] = {
+            {IPC::MakeHeader(0x0001, 0, 0), &TestService::Handler, "First"},
+            {IPC::MakeHeader(0x0002, 1, 0), &TestService::Handler, "Second"},
+            {IPC::MakeHeader(0x0002, 2, 0), &TestService::Handler, "SecondWithParam"},
+            {IPC::MakeHeader(0x0010, 0, 2), nullptr, "Unimplemented"},
+        };
+        RegisterHandlers(functions);
+    }
+
+    void RegisterMore() {
+        static const FunctionInfo functions[] = {
+            {IPC::MakeHeader(0x0003, 0, 0), &TestService::Handler, "Third"},
+            {IPC::MakeHeader(0x4000, 0, 0), &TestService::Handler, "HighID"},
+        };
+        RegisterHandlers(functions);
+    }
+
+private:
+    void Handler(Kernel::HLERequestContext&) {}
+};
+
+TEST_CASE("ServiceFramework: handler lookup", "[core][service]") {
+    auto service = std::make_shared<TestService>();
+
+    CHECK(service->GetFunctionName(IPC::MakeHeader(0x0001, 0, 0)) == "First");
+    CHECK(service->GetFunctionName(IPC::MakeHeader(0x0010, 0, 2)) == "Unimplemented");
+    // Headers have to match exactly, including the parameter sizes
+    CHECK(service->GetFunctionName(IPC::MakeHeader(0x0001, 1, 0)).empty());
+    CHECK(service->GetFunctionName(IPC::MakeHeader(0x0005, 0, 0)).empty());
+    CHECK(service->GetFunctionName(IPC::MakeHeader(0x0100, 0, 0)).empty());
+
+    // Commands sharing an ID are all found
+    CHECK(service->GetFunctionName(IPC::MakeHeader(0x0002, 1, 0)) == "Second");
+    CHECK(service->GetFunctionName(IPC::MakeHeader(0x0002, 2, 0)) == "SecondWithParam");
+
+    // Registering more handlers keeps the existing ones reachable
+    service->RegisterMore();
+    CHECK(service->GetFunctionName(IPC::MakeHeader(0x0001, 0, 0)) == "First");
+    CHECK(service->GetFunctionName(IPC::MakeHeader(0x0003, 0, 0)) == "Third");
+    CHECK(service->GetFunctionName(IPC::MakeHeader(0x0010, 0, 2)) == "Unimplemented");
+    CHECK(service->GetFunctionName(IPC::MakeHeader(0x4000, 0, 0)) == "HighID");
+}
+
+} // namespace Service
@@ -0,0 +1,71 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch.hpp>
+#include "core/hle/service/service_metrics.h"
+
+namespace Service {
+
+TEST_CASE("ServiceMetrics: calls are accumulated per command", "[core][service]") {
+    ServiceMetrics metrics;
+    CHECK(!metrics.IsEnabled());
+    const std::size_t hid_user = metrics.RegisterService("hid:USER");
+    const std::size_t fs_user = metrics.RegisterService("fs:USER");
+
+    CommandMetrics call;
+    call.calls = 1;
+    call.host_time_ns = 100;
+    call.static_buffer_bytes = 16;
+    metrics.Record(hid_user, 0x000A0000, "GetIPCHandles", call);
+    metrics.Record(hid_user, 0x000A0000, "GetIPCHandles", call);
+    call.client_sleeps = 1;
+    call.mapped_buffer_bytes = 0x1000;
+    metrics.Record(fs_user, 0x08020000, "OpenFile", call);
+
+    const auto snapshot = metrics.GetSnapshot();
+    REQUIRE(snapshot.size() == 2);
+    const auto& hid = snapshot.at("hid:USER").at(0x000A0000);
+    CHECK(hid.function_name == "GetIPCHandles");
+    CHECK(hid.metrics.calls == 2);
+    CHECK(hid.metrics.host_time_ns == 200);
+    CHECK(hid.metrics.static_buffer_bytes == 32);
+    CHECK(hid.metrics.client_sleeps == 0);
+    const auto& fs = snapshot.at("fs:USER").at(0x08020000);
+    CHECK(fs.metrics.client_sleeps == 1);
+    CHECK(fs.metrics.mapped_buffer_bytes == 0x1000);
+
+    const std::string json = metrics.ToJson();
+    CHECK(json.find("\"hid:USER\": {\n    \"calls\": 2,\n    \"host_time_ns\": 200,") !=
+          std::string::npos);
+    CHECK(json.find("{\"header\": \"0x08020000\", \"name\": \"OpenFile\", \"calls\": 1,") !=
+          std::string::npos);
+
+    metrics.Reset();
+    CHECK(metrics.GetSnapshot().empty());
+    CHECK(metrics.ToJson() == "{\n}\n");
+}
+
+TEST_CASE("ServiceMetrics: services with the same name are merged", "[core][service]") {
+    ServiceMetrics metrics;
+    const std::size_t first = metrics.RegisterService("srv:");
+    const std::size_t second = metrics.RegisterService("srv:");
+    const std::size_t unused = metrics.RegisterService("err:f");
+    REQUIRE(first != second);
+    REQUIRE(second != unused);
+
+    CommandMetrics call;
+    call.calls = 1;
+    call.host_time_ns = 10;
+    metrics.Record(first, 0x00050100, "GetServiceHandle", call);
+    metrics.Record(second, 0x00050100, "GetServiceHandle", call);
+
+    const auto snapshot = metrics.GetSnapshot();
+    REQUIRE(snapshot.size() == 1);
+    const auto& entry = snapshot.at("srv:").at(0x00050100);
+    CHECK(entry.function_name == "GetServiceHandle");
+    CHECK(entry.metrics.calls == 2);
+    CHECK(entry.metrics.host_time_ns == 20);
+}
+
+} // namespace Service
@@ -9,6 +9,7 @@
 #include "core/hle/kernel/process.h"
 #include "core/hle/kernel/shared_page.h"
 #include "core/memory.h"
+#include "core/mmio.h"
 
 TEST_CASE("Memory::IsValidVirtualAddress", "[core][memory]") {
     Core::Timing timing(1, 100);
@@ -54,3 +55,90 @@ TEST_CASE("Memory::IsValidVirtualAddress", "[core][memory]") {
         CHECK(Memory::IsValidVirtualAddress(*process, Memory::CONFIG_MEMORY_VADDR) == false);
     }
 }
+
+TEST_CASE("Memory::MemorySystem::GetSpans", "[core][memory]") {
+    Core::Timing timing(1, 100);
+    Memory::MemorySystem memory;
+    Kernel::KernelSystem kernel(memory, timing, [] {}, 0, 1, 0);
+    auto process = kernel.CreateProcess(kernel.CreateCodeSet("", 0));
+    kernel.HandleSpecialMapping(process->vm_manager,
+                                {Memory::VRAM_VADDR, Memory::VRAM_SIZE, false, false});
+    u8* const vram = memory.GetPhysicalPointer(Memory::VRAM_PADDR);
+
+    SECTION("contiguous pages are merged into one span") {
+        const auto spans = memory.GetSpans(*process, Memory::VRAM_VADDR + 0x800, 0x3000,
+                                           Memory::FlushMode::Flush);
+        REQUIRE(spans.size() == 1);
+        CHECK(spans[0].vaddr == Memory::VRAM_VADDR + 0x800);
+        CHECK(spans[0].pointer == vram + 0x800);
+        CHECK(spans[0].size == 0x3000);
+    }
+
+    SECTION("unmapped pages have no host memory") {
+        const auto spans = memory.GetSpans(*process, Memory::VRAM_VADDR_END - 0x1000, 0x2000,
+                                           Memory::FlushMode::Flush);
+        REQUIRE(spans.size() == 2);
+        CHECK(spans[0].pointer == vram + Memory::VRAM_SIZE - 0x1000);
+        CHECK(spans[0].size == 0x1000);
+        CHECK(spans[1].vaddr == Memory::VRAM_VADDR_END);
+        CHECK(spans[1].pointer == nullptr);
+        CHECK(spans[1].size == 0x1000);
+    }
+}
+
+namespace {
+/// IO region whose 32-bit reads return a fixed value
+class ConstantMMIO final : public Memory::MMIORegion {
+public:
+    explicit ConstantMMIO(u32 value) : value(value) {}
+
+    bool IsValidAddress(VAddr addr) override {
+        return true;
+    }
+    u8 Read8(VAddr addr) override {
+        return 0;
+    }
+    u16 Read16(VAddr addr) override {
+        return 0;
+    }
+    u32 Read32(VAddr addr) override {
+        return value;
+    }
+    u64 Read64(VAddr addr) override {
+        return 0;
+    }
+    bool ReadBlock(VAddr src_addr, void* dest_buffer, std::size_t size) override {
+        return false;
+    }
+    void Write8(VAddr addr, u8 data) override {}
+    void Write16(VAddr addr, u16 data) override {}
+    void Write32(VAddr addr, u32 data) override {}
+    void Write64(VAddr addr, u64 data) override {}
+    bool WriteBlock(VAddr dest_addr, const void* src_buffer, std::size_t size) override {
+        return false;
+    }
+
+private:
+    u32 value;
+};
+} // Anonymous namespace
+
+TEST_CASE("Memory::MemorySystem::MapIoRegion", "[core][memory]") {
+    Memory::MemorySystem memory;
+    auto page_table = std::make_unique<Memory::PageTable>();
+    page_table->pointers.fill(nullptr);
+    page_table->attributes.fill(Memory::PageType::Unmapped);
+    memory.SetCurrentPageTable(page_table.get());
+
+    // The second region spans a chunk boundary of the handler index and covers part of the first
+    memory.MapIoRegion(*page_table, 0x10000000, 0x4000, std::make_shared<ConstantMMIO>(1));
+    memory.MapIoRegion(*page_table, 0x103FF000, 0x3000, std::make_shared<ConstantMMIO>(2));
+    memory.MapIoRegion(*page_table, 0x10002000, 0x1000, std::make_shared<ConstantMMIO>(3));
+
+    CHECK(memory.Read32(0x10000000) == 1);
+    CHECK(memory.Read32(0x10001FFC) == 1);
+    CHECK(memory.Read32(0x10002000) == 3);
+    CHECK(memory.Read32(0x10003000) == 1);
+    CHECK(memory.Read32(0x103FF000) == 2);
+    CHECK(memory.Read32(0x10401FFC) == 2);
+}
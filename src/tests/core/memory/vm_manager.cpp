@@ -137,3 +137,39 @@ TEST_CASE("Memory Basics", "[kernel][memory]") {
         REQUIRE(code == RESULT_SUCCESS);
     }
 }
+
+TEST_CASE("VMManager::GetBackingBlocksForRange", "[kernel][memory]") {
+    std::vector<u8> first(Memory::PAGE_SIZE), second(2 * Memory::PAGE_SIZE);
+    Memory::MemorySystem memory;
+    // Because of the PageTable, Kernel::VMManager is too big to be created on the stack.
+    auto manager = std::make_unique<Kernel::VMManager>(memory);
+    REQUIRE(manager
+                ->MapBackingMemory(Memory::HEAP_VADDR, first.data(), Memory::PAGE_SIZE,
+                                   Kernel::MemoryState::Private)
+                .Succeeded());
+    REQUIRE(manager
+                ->MapBackingMemory(Memory::HEAP_VADDR + Memory::PAGE_SIZE, second.data(),
+                                   2 * Memory::PAGE_SIZE, Kernel::MemoryState::Private)
+                .Succeeded());
+
+    auto blocks =
+        manager->GetBackingBlocksForRange(Memory::HEAP_VADDR + 0x10, 2 * Memory::PAGE_SIZE);
+    REQUIRE(blocks.Succeeded());
+    const std::vector<std::pair<u8*, u32>> expected{
+        {first.data() + 0x10, Memory::PAGE_SIZE - 0x10},
+        {second.data(), Memory::PAGE_SIZE + 0x10},
+    };
+    CHECK(*blocks == expected);
+
+    // Ranges that run into unmapped memory are rejected
+    REQUIRE(manager->UnmapRange(Memory::HEAP_VADDR + Memory::PAGE_SIZE, 2 * Memory::PAGE_SIZE) ==
+            RESULT_SUCCESS);
+    CHECK(manager->GetBackingBlocksForRange(Memory::HEAP_VADDR, 2 * Memory::PAGE_SIZE).Code() ==
+          Kernel::ERR_INVALID_ADDRESS_STATE);
+
+    // Only the unmapped pages are gone from the page table
+    CHECK(manager->page_table.attributes[Memory::HEAP_VADDR >> Memory::PAGE_BITS] ==
+          Memory::PageType::Memory);
+    CHECK(manager->page_table.attributes[(Memory::HEAP_VADDR >> Memory::PAGE_BITS) + 1] ==
+          Memory::PageType::Unmapped);
+}